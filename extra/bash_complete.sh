@@ -38,7 +38,7 @@ _Ant()
             ;;
     esac
 
-    opts="--help --version --batch --u_writeuncalibrated --u_disablereconstruct --u_writecalibrated --p_disableParticleID -i --input -s --setup -p --physics -o --output -v --verbose -m --maxevents -O -c --calibration"
+    opts="--help --version --batch --u_writeuncalibrated --u_disablereconstruct --u_writecalibrated --p_disableParticleID -i --input -s --setup -p --physics -o --output -v --verbose -m --maxevents -O -c --calibration -j --jobs"
     if [[ ${cur} == * ]] ; then
         COMPREPLY=( $(compgen -W "${opts}" -- ${cur}) )
         return 0
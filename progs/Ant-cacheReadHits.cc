@@ -0,0 +1,130 @@
+#include "expconfig/ExpConfig.h"
+#include "expconfig/setups/Setup.h"
+#include "unpacker/Unpacker.h"
+#include "unpacker/RawFileReader.h"
+
+#include "analysis/input/ant/ReadHitsCache.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+#include "tree/TAntHeader.h"
+
+#include "base/WrapTFile.h"
+#include "base/std_ext/system.h"
+#include "base/ProgressCounter.h"
+#include "tclap/CmdLine.h"
+#include "base/Logger.h"
+
+#include "TTree.h"
+
+#include <memory>
+#include <signal.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+static volatile bool interrupt = false;
+
+int main(int argc, char** argv) {
+    SetupLogger();
+
+    signal(SIGINT, [] (int) {
+        interrupt = true;
+    });
+
+    TCLAP::CmdLine cmd("Ant-cacheReadHits", ' ', "0.1");
+
+    auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
+    auto cmd_input  = cmd.add<TCLAP::MultiArg<string>>("i","input","Input raw files",true,"filename");
+    auto cmd_output = cmd.add<TCLAP::ValueArg<string>>("o","output","Output file with read hits cache",true,"","filename");
+    auto cmd_setup  = cmd.add<TCLAP::ValueArg<string>>("s","setup","Choose setup manually by name",false,"","setup");
+    auto cmd_maxevents = cmd.add<TCLAP::ValueArg<long long>>("m","maxevents","Process only max events",false,-1,"maxevents");
+
+    cmd.parse(argc, argv);
+    if(cmd_verbose->isSet()) {
+        el::Loggers::setVerboseLevel(cmd_verbose->getValue());
+    }
+
+    if(std_ext::system::isInteractive())
+        ProgressCounter::Interval = 3;
+
+    if(cmd_setup->isSet()) {
+        ExpConfig::Setup::SetByName(cmd_setup->getValue());
+        LOG(INFO) << "Commandline override setup name to '" << cmd_setup->getValue() << "'";
+    }
+
+    WrapTFileOutput outputfile(cmd_output->getValue(), true);
+
+    ReadHitsCache_t cache;
+    cache.CreateBranches(outputfile.CreateInside<TTree>(ReadHitsCache_t::TreeName, "Cached read hits"));
+
+    TAntHeader* header = new TAntHeader();
+    gDirectory->Add(header);
+
+    long long nEvents = 0;
+    long long nEvents_last = 0;
+    ProgressCounter progress(
+                [&nEvents, &nEvents_last] (std::chrono::duration<double> elapsed) {
+        LOG(INFO) << "Cached " << nEvents << " events, "
+                  << (nEvents-nEvents_last)/elapsed.count() << " events/s";
+        nEvents_last = nEvents;
+    });
+
+    const auto maxevents = cmd_maxevents->getValue();
+
+    for(const auto& inputfile : cmd_input->getValue()) {
+        if(interrupt || (maxevents >= 0 && nEvents >= maxevents))
+            break;
+
+        string errmsg;
+        if(!std_ext::system::testopen(inputfile, errmsg)) {
+            LOG(ERROR) << "Cannot open inputfile '" << inputfile << "': " << errmsg;
+            return EXIT_FAILURE;
+        }
+
+        std::unique_ptr<Unpacker::Module> unpacker;
+        try {
+            unpacker = Unpacker::Get(inputfile);
+        }
+        catch(Unpacker::Exception e) {
+            LOG(ERROR) << "Unpacker exception: " << e.what();
+            return EXIT_FAILURE;
+        }
+        catch(RawFileReader::Exception e) {
+            LOG(ERROR) << "Unpacker: Error opening file "<<inputfile<<": " << e.what();
+            return EXIT_FAILURE;
+        }
+        catch(ExpConfig::ExceptionNoSetup) {
+            LOG(ERROR) << "The inputfile " << inputfile << " cannot be unpacked without a manually specified setupname";
+            return EXIT_FAILURE;
+        }
+
+        LOG(INFO) << "Caching read hits of " << inputfile;
+
+        while(auto event = unpacker->NextEvent()) {
+            if(interrupt || (maxevents >= 0 && nEvents >= maxevents))
+                break;
+
+            const auto& eventdata = event.Reconstructed();
+            if(nEvents == 0)
+                header->FirstID = eventdata.ID;
+            header->LastID = eventdata.ID;
+
+            cache.Set(eventdata);
+            cache.Tree->Fill();
+            nEvents++;
+            ProgressCounter::Tick();
+        }
+    }
+
+    header->SetupName = ExpConfig::Setup::Get().GetName();
+    header->WorkingDir = std_ext::system::getCwd();
+    header->CmdLine = std_ext::system::buildCmdLine(argc, argv);
+
+    LOG(INFO) << "Cached " << nEvents << " events, "
+              << (double)cache.Tree->GetZipBytes()/(1 << 20) << " MB (compressed), "
+              << (double)cache.Tree->GetTotBytes()/max(nEvents, 1LL) << " bytes/event (uncompressed)";
+
+    return interrupt ? EXIT_FAILURE : EXIT_SUCCESS;
+}
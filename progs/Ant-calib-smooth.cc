@@ -1,6 +1,5 @@
 #include "calibration/DataManager.h"
 #include "calibration/DataBase.h"
-#include "calibration/gui/AvgBuffer.h"
 
 #include "expconfig/ExpConfig.h"
 
@@ -10,6 +9,8 @@
 #include "tclap/ValuesConstraintExtra.h"
 #include "base/std_ext/system.h"
 #include "base/piecewise_interval.h"
+#include "base/SavitzkyGolay.h"
+#include "base/WrapTFile.h"
 #include "base/Logger.h"
 
 #include "detail/tools.h"
@@ -18,23 +19,6 @@ using namespace std;
 using namespace ant;
 using namespace ant::calibration;
 
-namespace ant {
-namespace calibration {
-namespace gui {
-// provide AvgBuffer traits for SavitzyGolay, where Add() method is not needed
-template<>
-struct AvgBufferItem_traits<TCalibrationData> {
-    static std::unique_ptr<TCalibrationData> Clone(const TCalibrationData& cdata) {
-        // just use copy ctor
-        return std_ext::make_unique<TCalibrationData>(cdata);
-    }
-    static int    GetNBins(const TCalibrationData& cdata) { return cdata.Data.size(); };
-    static double GetBin(const TCalibrationData& cdata, int bin) { return cdata.Data[bin].Value; }
-    static void   SetBin(TCalibrationData& cdata, int bin, double v) { cdata.Data[bin].Value = v; }
-};
-}}} // namespace ant::calibration::gui
-
-
 // ensure same mapping of index in cdata.Data to Key
 bool check_compatibility(const TCalibrationData& cdata) {
     static TCalibrationData prev_cdata;
@@ -104,8 +88,15 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    calibration::gui::AvgBuffer_SavitzkyGolay<TCalibrationData> buffer(cmd_average->getValue(), cmd_sgpol->getValue());
+    if(cmd_average->getValue()<1) {
+        LOG(ERROR) << "Average window size must be at least 1";
+        return EXIT_FAILURE;
+    }
+    const SavitzkyGolay sg(cmd_average->getValue(), cmd_sgpol->getValue());
 
+    // read all ranges first, as all channels across all ranges are smoothed at once
+    vector<TCalibrationData> cdatas;
+    cdatas.reserve(ranges.size());
     for(auto& range : ranges) {
         // no need to use the calibration manager,
         // as we already know it's only a DataRange
@@ -117,10 +108,7 @@ int main(int argc, char** argv)
                 LOG(ERROR) << "Incompatible TCalibrationData to previously read found: " << cdata;
                 return EXIT_FAILURE;
             }
-            // use copy ctor, this is a bit inefficient (but hopefully moving it helps)
-            // but it boils down how to handle ownership of ROOT objects (in particular hists)
-            // in WrapTFile, then calibration::gui::Manager and then calibration::gui::AvgBuffer
-            buffer.Push(make_shared<decltype(cdata)>(std::move(cdata)), range);
+            cdatas.emplace_back(std::move(cdata));
         }
         else {
             cerr << "Could not get data for range=" << range << endl;
@@ -128,10 +116,30 @@ int main(int argc, char** argv)
         }
     }
 
-    // indicate no more pushes
-    buffer.Flush();
+    // one row of values per range, with the channels contiguous,
+    // check_compatibility ensured the same keys in each range
+    const auto nChannels = cdatas.front().Data.size();
+    vector<double> values;
+    values.reserve(cdatas.size()*nChannels);
+    for(const auto& cdata : cdatas) {
+        for(const auto& kv : cdata.Data)
+            values.push_back(kv.Value);
+    }
+
+    try {
+        const auto smoothed = sg.Smooth(values, nChannels);
+        auto it_smoothed = smoothed.begin();
+        for(auto& cdata : cdatas) {
+            for(auto& kv : cdata.Data)
+                kv.Value = *it_smoothed++;
+        }
+    }
+    catch(const SavitzkyGolay::Exception& e) {
+        LOG(ERROR) << "Cannot smooth " << cdatas.size() << " ranges: " << e.what();
+        return EXIT_FAILURE;
+    }
 
-    // before running over the buffer, setup --dump mode
+    // before running over the smoothed ranges, setup --dump mode
     struct timepoint_t {
         const uint32_t Timestamp;
         const double Value;
@@ -145,8 +153,7 @@ int main(int argc, char** argv)
     if(dump)
         cout << "# Generated with " << std_ext::system::buildCmdLine(argc, argv) << '\n';
 
-    while(!buffer.Empty()) {
-        auto& cdata = buffer.CurrentItem();
+    for(const auto& cdata : cdatas) {
 
         if(dump) {
             for(auto& kv : cdata.Data) {
@@ -158,8 +165,6 @@ int main(int argc, char** argv)
         else if(write) {
             calmgr->Add(cdata, Calibration::AddMode_t::StrictRange);
         }
-
-        buffer.Next();
     }
 
     if(dump) {
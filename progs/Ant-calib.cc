@@ -33,6 +33,7 @@ int main(int argc, char** argv) {
     auto cmd_default = cmd.add<TCLAP::SwitchArg>("","default","Put created TCalibrationData to default range",false);
     auto cmd_confirmHeaderMismatch = cmd.add<TCLAP::SwitchArg>("","confirmHeaderMismatch","Confirm mismatch in Git infos in file headers and use files anyway",false);
     auto cmd_setupname = cmd.add<TCLAP::ValueArg<string>>("s","setup","Override setup name", false, "", "setup");
+    auto cmd_prefetch = cmd.add<TCLAP::ValueArg<unsigned>>("","prefetch","Number of input files loaded ahead in parallel by worker processes, helps for large or remote input files (batch mode only)", false, 0, "files");
     auto cmd_ModuleOptions = cmd.add<TCLAP::MultiArg<string>>("O","options","Options for Calibration GUI Module, key=value",false,"");
 
     // unlabeled multi arg must be the last element added, and interprets everything as a input file
@@ -97,6 +98,11 @@ int main(int argc, char** argv) {
                 move(buffer),
                 cmd_confirmHeaderMismatch->getValue()
                 );
+    // the workers are forked, which must not happen with an open display connection
+    if(cmd_prefetch->isSet() && !cmd_batchmode->isSet())
+        LOG(WARNING) << "Ignoring " << cmd_prefetch->longID() << " without " << cmd_batchmode->longID();
+    else
+        manager.PrefetchFiles = cmd_prefetch->getValue();
 
     // try to find the requested calibration modules
     // the gui manager already scanned the files and provides a hint
@@ -140,15 +146,17 @@ int main(int argc, char** argv) {
 
     int gotoslice = cmd_gotoslice->isSet() ? cmd_gotoslice->getValue() : -1;
 
+    // before DoInit, which already loads files,
+    // so forked prefetch workers do not share any graphics state
+    if(cmd_batchmode->isSet()) {
+        gROOT->SetBatch();
+    }
+
     if(!manager.DoInit(gotoslice)) {
         LOG(ERROR) << "Cannot initialize the calibration. Check previous messages.";
         return EXIT_FAILURE;
     }
 
-    if(cmd_batchmode->isSet()) {
-        gROOT->SetBatch();
-    }
-
     new ManagerWindow(manager);
     app->Run(kTRUE);
     ExpConfig::Setup::Cleanup();
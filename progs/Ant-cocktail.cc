@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
 
 #include "mc/pluto/PlutoGenerator.h"
@@ -15,6 +16,9 @@
 #include "tclap/ValuesConstraintExtra.h"
 
 #include "detail/McAction.h"
+#include "detail/McShards.h"
+
+#include "TRandom.h"
 
 using namespace std;
 using namespace ant;
@@ -46,6 +50,9 @@ int main( int argc, char** argv )
     auto cmd_noTID      = cmd.add<TCLAP::SwitchArg>        ("",  "noTID",   "Don't add TID tree for the events",   false);
     auto cmd_verbose    = cmd.add<TCLAP::ValueArg<int>>    ("v", "verbose", "Verbosity level (0..9)",              false, 0, "int");
 
+    auto cmd_seed       = cmd.add<TCLAP::ValueArg<unsigned>> ("", "seed",   "Seed for reproducible output, 0 means random", false, 0, "seed");
+    auto cmd_shards     = cmd.add<TCLAP::ValueArg<unsigned>> ("j", "shards", "Generate in this many independent worker processes and merge afterwards", false, 1, "shards");
+
     cmd.parse(argc, argv);
 
     string outfile(cmd_outfile->getValue());
@@ -87,27 +94,51 @@ int main( int argc, char** argv )
         return 1;
     }
 
-    // scope that the Cocktail output file is properly closed before adding TID tree
-    {
-        auto selector = mc::data::Query::GetSelector(allowedTargets.at(cmd_target->getValue()));
-        Cocktail cocktail(outfile,
-                          energies,
-                          !cmd_noUnstable->isSet(),
-                          !cmd_noBulk->isSet(),
-                          cmd_verbose->getValue(),
-                          "1.0 / x",
-                          selector);
-
-        auto nErrors = cocktail.Sample(cmd_numEvents->getValue());
-
-        if(nErrors>0)
-            LOG(WARNING) << "Events with error: " <<  nErrors;
-    }
+    const auto nShards = std::max(1u, cmd_shards->getValue());
+    const auto timestamp = McShard::GetTimestamp();
+    const auto shards = McShard::Make(outfile, cmd_numEvents->getValue(), nShards, cmd_seed->getValue());
+
+    auto generate = [&] (const McShard& shard) {
+        // Pluto uses gRandom for the decays
+        gRandom->SetSeed(shard.Seed);
+
+        // scope that the Cocktail output file is properly closed before adding TID tree
+        {
+            auto selector = mc::data::Query::GetSelector(allowedTargets.at(cmd_target->getValue()));
+            Cocktail cocktail(shard.Outfile,
+                              energies,
+                              !cmd_noUnstable->isSet(),
+                              !cmd_noBulk->isSet(),
+                              cmd_verbose->getValue(),
+                              "1.0 / x",
+                              selector,
+                              shard.Seed);
+
+            // sampling in blocks gives the same events, but lets the worker report its progress
+            unsigned long nErrors = 0;
+            for(unsigned long done = 0; done < shard.nEvents; ) {
+                const auto n = std::min<unsigned long>(shard.nEvents - done, 10000);
+                nErrors += cocktail.Sample(n);
+                done += n;
+                ProcessPool::ReportProgress(double(done)/shard.nEvents);
+            }
+
+            if(nErrors>0)
+                LOG(WARNING) << "Events with error: " <<  nErrors;
+        }
+
+        // add TID tree for the generated events,
+        // offset by the events of the previous shards to keep them disjoint
+        if(!cmd_noTID->isSet()) {
+            LOG(INFO) << "Add TID tree to the output file";
+            mc::pluto::utils::PlutoTID::AddTID(shard.Outfile, timestamp, shard.FirstEvent, shard.Seed);
+        }
+        return true;
+    };
 
-    // add TID tree for the generated events
-    if(!cmd_noTID->isSet()) {
-        LOG(INFO) << "Add TID tree to the output file";
-        mc::pluto::utils::PlutoTID::AddTID(outfile);
+    if(!McShard::Run(shards, generate) || !McShard::Merge(shards, outfile)) {
+        LOG(ERROR) << "Generating cocktail failed";
+        return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
@@ -3,6 +3,12 @@
 #include "unpacker/UnpackerAcqu.h"
 #include "unpacker/detail/UnpackerAcqu_legacy.h"
 #include "unpacker/RawFileReader.h"
+#include "unpacker/RawFileWriter.h"
+#include "unpacker/Unpacker.h"
+#include "reconstruct/Reconstruct.h"
+#include "analysis/physics/Physics.h"
+#include "analysis/physics/manager_t.h"
+#include "analysis/input/event_t.h"
 
 #include "expconfig/setups/Setup.h"
 
@@ -11,13 +17,23 @@
 #include "tree/TAntHeader.h"
 
 #include "base/WrapTFile.h"
+#include "base/tmpfile_t.h"
 #include "base/std_ext/system.h"
+#include "base/std_ext/memory.h"
 #include "tclap/CmdLine.h"
 #include "base/Logger.h"
 
+#include "TTree.h"
+
 #include <memory>
 #include <signal.h>
 #include <fstream>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <list>
+#include <cstdlib>
+#include <new>
 
 using namespace std;
 using namespace ant;
@@ -25,7 +41,263 @@ using namespace ant::unpacker;
 
 static volatile bool interrupt = false;
 
+// count all allocations of this program for the benchmark,
+// replacing the global operator new also covers the shared libraries
+static std::size_t nAllocations = 0;
+
+void* operator new(std::size_t n) {
+    nAllocations++;
+    if(auto p = std::malloc(n))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief The Mk2Writer struct packs event buffers into Acqu Mk2 data buffers
+ */
+struct Mk2Writer {
+    static constexpr size_t BufferWords = 10*0x8000/sizeof(uint32_t);
+
+    explicit Mk2Writer(RawFileWriter& output) : out(output) {}
+
+    void WriteHeader(const string& headerfile) {
+        std::vector<uint32_t> buffer;
+        RawFileReader r;
+        r.open(headerfile);
+        if(!r)
+            throw std::runtime_error("Cannot open headerfile for reading");
+        // header is usually contained within the first 32k bytes
+        r.expand_buffer(buffer, 0x8000/sizeof(uint32_t));
+        buffer.resize(BufferWords);
+        out.write(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief WriteEvent adds the event to the current data buffer
+     * @param eventbuffer the event, must end with acqu::EEndEvent
+     */
+    void WriteEvent(const vector<uint32_t>& eventbuffer) {
+        // each eventbuffer is filled into the buffer with its eventID, eventlength (in bytes)
+        // and some possible end-of-databuffer marker, in total 3 extra words maximum
+        if(databuffer.size()+eventbuffer.size()+3 > BufferWords) {
+            flush();
+            databuffer.emplace_back(acqu::EMk2DataBuff);
+        }
+
+        // fill event into buffer
+        databuffer.emplace_back(nEvents);
+        databuffer.emplace_back(eventbuffer.size()*sizeof(uint32_t));
+        databuffer.insert(databuffer.end(), eventbuffer.begin(), eventbuffer.end());
+
+        nEvents++;
+    }
+
+    void Finish() {
+        // dump last databuffer
+        flush();
+
+        // write EEndBuffer
+        databuffer.emplace_back(acqu::EEndBuff);
+        flush();
+    }
+
+    unsigned nEvents = 0;
+
+protected:
+    RawFileWriter& out;
+    // ensure first databuffer has Mk2 data marker
+    std::vector<uint32_t> databuffer{acqu::EMk2DataBuff};
+
+    void flush() {
+        databuffer.emplace_back(acqu::EBufferEnd);
+        databuffer.resize(BufferWords);
+        out.write(databuffer.data(), databuffer.size());
+        databuffer.clear();
+    }
+};
+
+constexpr size_t Mk2Writer::BufferWords;
+
+/**
+ * @brief The SyntheticEvents struct generates random Acqu events from the setup's mappings
+ */
+struct SyntheticEvents {
+    SyntheticEvents(const std::vector<UnpackerAcquConfig::hit_mapping_t>& hit_mappings,
+                    const std::vector<UnpackerAcquConfig::scaler_mapping_t>& scaler_mappings,
+                    double meanHits, unsigned seed) :
+        rng(seed),
+        nHits(meanHits)
+    {
+        // only simple mappings can be inverted
+        for(auto& m : hit_mappings) {
+            if(m.RawChannels.size() != 1)
+                continue;
+            auto& rawchannel = m.RawChannels.front();
+            if(rawchannel.NoMask() != rawchannel.Mask)
+                continue;
+            hitChannels.push_back(rawchannel.RawChannel);
+        }
+        for(auto& m : scaler_mappings)
+            for(auto& entry : m.Entries)
+                scalerChannels.push_back(entry.RawChannel.RawChannel);
+
+        if(hitChannels.empty())
+            throw std::runtime_error("Setup does not provide simple hit mappings");
+    }
+
+    void Fill(vector<uint32_t>& eventbuffer, bool withScalers) {
+        eventbuffer.clear();
+
+        std::uniform_int_distribution<size_t> channel(0, hitChannels.size()-1);
+        std::uniform_int_distribution<uint16_t> adc;
+
+        const auto n = nHits(rng);
+        for(unsigned i=0;i<n;i++) {
+            eventbuffer.emplace_back();
+            auto acquhit = reinterpret_cast<acqu::AcquBlock_t*>(addressof(eventbuffer.back()));
+            acquhit->id = hitChannels[channel(rng)];
+            acquhit->adc = adc(rng);
+        }
+
+        if(withScalers && !scalerChannels.empty()) {
+            std::uniform_int_distribution<uint32_t> value(0, 1000000);
+            eventbuffer.push_back(acqu::EScalerBuffer);
+            // length in bytes includes the length word itself, but not the end marker
+            eventbuffer.push_back((1+2*scalerChannels.size())*sizeof(uint32_t));
+            for(auto ch : scalerChannels) {
+                eventbuffer.push_back(ch);
+                eventbuffer.push_back(value(rng));
+            }
+            eventbuffer.push_back(acqu::EScalerBuffer);
+        }
+
+        // finish with end-event marker
+        eventbuffer.push_back(acqu::EEndEvent);
+    }
+
+protected:
+    std::mt19937 rng;
+    std::poisson_distribution<unsigned> nHits;
+    vector<uint16_t> hitChannels;
+    vector<uint32_t> scalerChannels;
+};
+
+/**
+ * @brief The stage_t struct accumulates time and allocations of a processing stage
+ */
+struct stage_t {
+    const string Name;
+    std::chrono::duration<double> Elapsed{0};
+    std::size_t Allocations = 0;
+
+    explicit stage_t(const string& name) : Name(name) {}
+
+    struct scope_t {
+        explicit scope_t(stage_t& stage) : Stage(stage) {}
+        scope_t(const scope_t&) = delete;
+        ~scope_t() {
+            Stage.Elapsed += std::chrono::steady_clock::now() - Start;
+            Stage.Allocations += nAllocations - StartAllocations;
+        }
+    private:
+        stage_t& Stage;
+        const std::size_t StartAllocations = nAllocations;
+        const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    };
+};
+
+/**
+ * @brief RunBenchmark runs the Ant processing chain on the given raw file stage by stage
+ * @param rawfile the Acqu file
+ * @param physicsclasses physics classes to run, slowcontrol is not available for them
+ * @return true on success
+ *
+ * Reports events/s, MB/s of uncompressed raw data and allocations per event for each stage
+ */
+bool RunBenchmark(const string& rawfile, const vector<string>& physicsclasses)
+{
+    stage_t s_reader("RawFileReader");
+    stage_t s_unpacker("Unpacker (incl. reading)");
+    stage_t s_reconstruct("Reconstruct");
+    stage_t s_physics("Physics");
+    stage_t s_output("Output");
+
+    // first just read the file to get the raw decompression speed
+    double rawMB = 0;
+    {
+        stage_t::scope_t m(s_reader);
+        RawFileReader reader;
+        reader.open(rawfile, 1 << 20);
+        vector<char> buffer(1 << 20);
+        while(!reader.eof()) {
+            reader.read(buffer.data(), buffer.size());
+            rawMB += double(reader.gcount())/(1 << 20);
+        }
+    }
+
+    // then run the chain as Ant does
+    tmpfile_t outfile;
+    WrapTFileOutput output(outfile.filename, true);
 
+    std::list<std::unique_ptr<analysis::Physics>> physics;
+    for(const auto& classname : physicsclasses)
+        physics.emplace_back(analysis::PhysicsRegistry::Create(classname));
+
+    auto unpacker = Unpacker::Get(rawfile);
+    if(!unpacker) {
+        LOG(ERROR) << "No unpacker found for " << rawfile;
+        return false;
+    }
+    Reconstruct reconstruct;
+
+    auto treeEvents = output.CreateInside<TTree>("treeEvents","TEvent data");
+    TEvent* treeEventPtr = nullptr;
+    treeEvents->Branch("data", addressof(treeEventPtr));
+
+    long long nEvents = 0;
+    while(!interrupt) {
+        analysis::input::event_t event;
+        {
+            stage_t::scope_t m(s_unpacker);
+            event = analysis::input::event_t{unpacker->NextEvent()};
+        }
+        if(!event)
+            break;
+        {
+            stage_t::scope_t m(s_reconstruct);
+            reconstruct.DoReconstruct(event.Reconstructed());
+        }
+        {
+            stage_t::scope_t m(s_physics);
+            analysis::physics::manager_t manager;
+            for(auto& p : physics)
+                p->ProcessEvent(event, manager);
+        }
+        {
+            stage_t::scope_t m(s_output);
+            treeEventPtr = addressof(event);
+            treeEvents->Fill();
+        }
+        nEvents++;
+    }
+
+    for(auto& p : physics)
+        p->Finish();
+
+    LOG(INFO) << "Benchmark of " << nEvents << " events, " << rawMB << " MB uncompressed raw data";
+    for(const stage_t* s : {&s_reader, &s_unpacker, &s_reconstruct, &s_physics, &s_output}) {
+        const auto secs = s->Elapsed.count();
+        LOG(INFO) << setw(25) << left << s->Name << right
+                  << setw(12) << fixed << setprecision(0) << nEvents/secs << " events/s "
+                  << setw(10) << setprecision(2) << rawMB/secs << " MB/s "
+                  << setw(10) << setprecision(2) << double(s->Allocations)/nEvents << " allocs/event";
+    }
+    return true;
+}
 
 int main(int argc, char** argv) {
     SetupLogger();
@@ -38,10 +310,21 @@ int main(int argc, char** argv) {
 
     auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
     auto cmd_setup  = cmd.add<TCLAP::ValueArg<string>>("s","setup","Choose setup manually by name",false,"","setup");
-    auto cmd_input  = cmd.add<TCLAP::ValueArg<string>>("i","input","Input files",true,"","filename");
+    auto cmd_input  = cmd.add<TCLAP::ValueArg<string>>("i","input","Input files",false,"","filename");
     auto cmd_output = cmd.add<TCLAP::ValueArg<string>>("o","output","Output file",true,"","filename");
     auto cmd_headerfile = cmd.add<TCLAP::ValueArg<string>>("","header","Acqu Mk2 file to for header extraction",true,"","acqufile");
+    auto cmd_compression = cmd.add<TCLAP::ValueArg<string>>("c","compression","Compression of output file: none, gz or xz",false,"none","compression");
+    auto cmd_xzBlockSize = cmd.add<TCLAP::ValueArg<unsigned>>("","xzBlockSize","Size of independent xz blocks in MB (uncompressed) for fast seeking, 0 for one block",false,0,"MB");
+
+    // synthetic events instead of input file
+    auto cmd_synthetic = cmd.add<TCLAP::ValueArg<unsigned>>("","synthetic","Generate this many random events instead of reading input (needs setup)",false,0,"events");
+    auto cmd_hits = cmd.add<TCLAP::ValueArg<double>>("","hits","Mean (Poisson) number of hits per synthetic event",false,50,"hits");
+    auto cmd_scalerEvery = cmd.add<TCLAP::ValueArg<unsigned>>("","scalerEvery","Add scaler block every n-th synthetic event, 0 disables",false,10000,"n");
+    auto cmd_seed = cmd.add<TCLAP::ValueArg<unsigned>>("","seed","Seed for synthetic events",false,0,"seed");
 
+    // run the Ant chain on the written file
+    auto cmd_benchmark = cmd.add<TCLAP::SwitchArg>("","benchmark","Measure throughput of reader, unpacker, reconstruct, physics and output on the written file",false);
+    auto cmd_physics = cmd.add<TCLAP::MultiArg<string>>("p","physics","Physics class to run in benchmark",false,"physics");
 
     cmd.parse(argc, argv);
     if(cmd_verbose->isSet()) {
@@ -58,9 +341,14 @@ int main(int argc, char** argv) {
         }
     }
 
-    // check if input file is readable
-    const string& inputfile = cmd_input->getValue();
-    {
+    if(cmd_input->isSet() == cmd_synthetic->isSet()) {
+        LOG(ERROR) << "Specify either input file or number of synthetic events";
+        return EXIT_FAILURE;
+    }
+
+    if(cmd_input->isSet()) {
+        // check if input file is readable
+        const string& inputfile = cmd_input->getValue();
         string errmsg;
         if(!std_ext::system::testopen(inputfile, errmsg)) {
             LOG(ERROR) << "Cannot open inputfile '" << inputfile << "': " << errmsg;
@@ -68,13 +356,13 @@ int main(int argc, char** argv) {
         }
     }
 
-    auto inputrootfile = make_shared<WrapTFileInput>(inputfile);
+    auto inputrootfile = cmd_input->isSet() ? make_shared<WrapTFileInput>(cmd_input->getValue()) : nullptr;
 
     // check if there's a previous AntHeader present,
     // which could tell us the SetupName
     if(!cmd_setup->isSet()) {
         TAntHeader* previous_AntHeader;
-        if(inputrootfile->GetObject<TAntHeader>("AntHeader",previous_AntHeader)) {
+        if(inputrootfile && inputrootfile->GetObject<TAntHeader>("AntHeader",previous_AntHeader)) {
             const auto& setupname = previous_AntHeader->SetupName;
             if(!setupname.empty()) {
                 ExpConfig::Setup::SetByName(setupname);
@@ -92,45 +380,41 @@ int main(int argc, char** argv) {
 
     // get mapping from setup
     std::vector<UnpackerAcquConfig::hit_mapping_t> hit_mappings;
+    std::vector<UnpackerAcquConfig::scaler_mapping_t> scaler_mappings;
     {
-        std::vector<UnpackerAcquConfig::scaler_mapping_t> scaler_mappings;
         auto& setup = ExpConfig::Setup::GetByType<UnpackerAcquConfig>();
         setup.BuildMappings(hit_mappings, scaler_mappings);
     }
 
-
-
     const auto& outputfilename = cmd_output->getValue();
-    ofstream outputfile(outputfilename);
+    RawFileWriter outputfile(outputfilename,
+                             RawFileWriter::GetCompression(cmd_compression->getValue()),
+                             6, streamsize(cmd_xzBlockSize->getValue()) << 20);
+    Mk2Writer writer(outputfile);
 
     // copy the header from given file
-    {
-        std::vector<uint32_t> buffer;
-        RawFileReader r;
-        r.open(headerfile);
-        if(!r) {
-            LOG(ERROR) << "Cannot open headerfile for reading";
-            return EXIT_FAILURE;
+    writer.WriteHeader(headerfile);
+
+    vector<uint32_t> eventbuffer;
+
+    if(cmd_synthetic->isSet()) {
+        SyntheticEvents synthetic(hit_mappings, scaler_mappings, cmd_hits->getValue(), cmd_seed->getValue());
+        const auto scalerEvery = cmd_scalerEvery->getValue();
+        for(unsigned i=0;i<cmd_synthetic->getValue();i++) {
+            if(interrupt)
+                break;
+            synthetic.Fill(eventbuffer, scalerEvery > 0 && (i+1) % scalerEvery == 0);
+            writer.WriteEvent(eventbuffer);
         }
-        // header is usually contained within the first 32k bytes
-        r.expand_buffer(buffer, 0x8000/sizeof(uint32_t));
-        buffer.resize(10*0x8000/sizeof(uint32_t));
-        outputfile.write(reinterpret_cast<const char*>(buffer.data()),
-                         buffer.size()*sizeof(uint32_t));
     }
+    else {
+        analysis::input::AntReader reader(inputrootfile, nullptr, nullptr);
+        analysis::input::event_t event;
+        while(reader.ReadNextEvent(event)) {
+            if(interrupt)
+                break;
 
-    analysis::input::AntReader reader(inputrootfile, nullptr, nullptr);
-
-    unsigned nEvents = 0;
-    analysis::input::event_t event;
-    // ensure first databuffer has Mk2 data marker
-    std::vector<uint32_t> databuffer{acqu::EMk2DataBuff};
-    while(reader.ReadNextEvent(event)) {
-        if(interrupt)
-            break;
-
-        vector<uint32_t> eventbuffer;
-        {
+            eventbuffer.clear();
             for(const TDetectorReadHit& readhit : event.Reconstructed().DetectorReadHits) {
                 auto it_hit_mapping = std::find_if(hit_mappings.begin(), hit_mappings.end(),
                                                 [&readhit] (const UnpackerAcquConfig::hit_mapping_t& m) {
@@ -164,44 +448,21 @@ int main(int argc, char** argv) {
 
             // finish with end-event marker
             eventbuffer.push_back(acqu::EEndEvent);
-        }
 
-        // each eventbuffer is filled into the buffer with its eventID, eventlength (in bytes)
-        // and some possible end-of-databuffer marker, in total 3 extra words maximum
-        if(databuffer.size()+eventbuffer.size()+3 > 10*0x8000/sizeof(uint32_t)) {
-            databuffer.emplace_back(acqu::EBufferEnd);
-            databuffer.resize(10*0x8000/sizeof(uint32_t));
-            outputfile.write(reinterpret_cast<const char*>(databuffer.data()),
-                             databuffer.size()*sizeof(uint32_t));
-            databuffer.clear();
-            databuffer.emplace_back(acqu::EMk2DataBuff);
+            writer.WriteEvent(eventbuffer);
         }
-
-        // fill event into buffer
-        databuffer.emplace_back(nEvents);
-        databuffer.emplace_back(eventbuffer.size()*sizeof(uint32_t));
-        databuffer.insert(databuffer.end(), eventbuffer.begin(), eventbuffer.end());
-
-        nEvents++;
     }
 
-    // dump last databuffer
-    databuffer.emplace_back(acqu::EBufferEnd);
-    databuffer.resize(10*0x8000/sizeof(uint32_t));
-    outputfile.write(reinterpret_cast<const char*>(databuffer.data()),
-                     databuffer.size()*sizeof(uint32_t));
-
-    // write EEndBuffer
-    databuffer.clear();
-    databuffer.emplace_back(acqu::EEndBuff);
-    databuffer.emplace_back(acqu::EBufferEnd);
-    databuffer.resize(10*0x8000/sizeof(uint32_t));
-    outputfile.write(reinterpret_cast<const char*>(databuffer.data()),
-                     databuffer.size()*sizeof(uint32_t));
+    writer.Finish();
+    outputfile.close();
 
-    LOG(INFO) << nEvents << " events processed";
+    LOG(INFO) << writer.nEvents << " events processed, "
+              << double(outputfile.BytesWritten())/(1 << 20) << " MB uncompressed";
 
-    outputfile.close();
+    if(cmd_benchmark->isSet()) {
+        if(!RunBenchmark(outputfilename, cmd_physics->getValue()))
+            return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
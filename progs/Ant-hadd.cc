@@ -2,19 +2,12 @@
 #include "base/Logger.h"
 #include "base/std_ext/string.h"
 #include "base/std_ext/memory.h"
+#include "base/std_ext/system.h"
 #include "base/ProgressCounter.h"
 
-#include "tree/TAntHeader.h"
+#include "analysis/utils/FileMerger.h"
 
-#include "TDirectory.h"
-#include "TFile.h"
-#include "TList.h"
-#include "TKey.h"
 #include "TClass.h"
-#include "TH1.h"
-#include "TFileMergeInfo.h"
-#include "root-addons/analysis_codes/hstack.h"
-
 #include "TSystem.h"
 #include "TROOT.h"
 #include "TInterpreter.h"
@@ -23,130 +16,13 @@
 
 #include <list>
 #include <string>
-#include <map>
+#include <vector>
+#include <chrono>
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
 
-template<typename T>
-using unique_ptrs_t = vector<unique_ptr<T>>;
-
-using sources_t = unique_ptrs_t<const TDirectory>;
-
-unsigned nPaths = 0;
-
-template<typename T>
-struct pair_t {
-    explicit pair_t(const string& name) : Name(name) {}
-    string Name;
-    T Item;
-};
-
-template<typename C, typename... Args>
-void add_by_name(C& c, const string& name, Args&&... args) {
-    using T = typename C::value_type;
-    auto it = std::find_if(c.begin(), c.end(), [name] (const T& item) {
-        return item.Name == name;
-    });
-    if(it == c.end()) {
-        c.emplace_back(name);
-        c.back().Item.emplace_back(std::forward<Args>(args)...);
-    }
-    else {
-        it->Item.emplace_back(std::forward<Args>(args)...);
-    }
-}
-
-void MergeRecursive(TDirectory& target, const sources_t& sources)
-{
-    nPaths++;
-    ProgressCounter::Tick();
-
-    vector<pair_t<sources_t>> dirs;
-
-    vector<pair_t<unique_ptrs_t<TH1>>>    hists;
-    vector<pair_t<unique_ptrs_t<hstack>>> stacks;
-    vector<pair_t<unique_ptrs_t<TAntHeader>>> headers;
-
-    for(auto& source : sources) {
-        TList* keys = source->GetListOfKeys();
-        if(!keys)
-            continue;
-
-        // first create a unique list of names,
-        // this prevents object with different cycles
-        TIter nextk(keys);
-        string prev_keyname;
-        while(auto key = dynamic_cast<TKey*>(nextk()))
-        {
-            const string keyname = key->GetName();
-            if(prev_keyname == keyname)
-                continue;
-            prev_keyname = keyname;
-
-            auto cl = TClass::GetClass(key->GetClassName());
-
-            if(cl->InheritsFrom(TDirectory::Class())) {
-                auto dir = dynamic_cast<TDirectory*>(key->ReadObj());
-                add_by_name(dirs, keyname, dir);
-            }
-            else if(cl->InheritsFrom(TH1::Class())) {
-                auto obj = dynamic_cast<TH1*>(key->ReadObj());
-                add_by_name(hists, keyname, obj);
-            }
-            else if(cl->InheritsFrom(hstack::Class())) {
-                auto obj = dynamic_cast<hstack*>(key->ReadObj());
-                add_by_name(stacks, keyname, obj);
-            }
-            else if(cl->InheritsFrom(TAntHeader::Class())) {
-                auto obj = dynamic_cast<TAntHeader*>(key->ReadObj());
-                add_by_name(headers, keyname, obj);
-            }
-        }
-    }
-
-
-
-    for(const auto& it_dirs : dirs) {
-        auto newdir = target.mkdir(it_dirs.Name.c_str());
-        MergeRecursive(*newdir, it_dirs.Item);
-    }
-
-    target.cd();
-    TFileMergeInfo info(addressof(target)); // for calling Merge
-
-    for(const auto& it_hists : hists) {
-        auto& hists = it_hists.Item;
-        auto& first = hists.front();
-        for(auto it = next(hists.begin()); it != hists.end(); ++it) {
-            first->Add(it->get());
-        }
-        target.WriteTObject(first.get());
-    }
-
-    for(const auto& it : stacks) {
-        auto& items = it.Item;
-        auto& first = items.front();
-        TList c;
-        for(auto it = next(items.begin()); it != items.end(); ++it) {
-            c.Add(it->get());
-        }
-        first->Merge(addressof(c), addressof(info));
-        target.WriteTObject(first.get());
-    }
-
-    for(const auto& it : headers) {
-        auto& items = it.Item;
-        auto& first = items.front();
-        TList c;
-        for(auto it = next(items.begin()); it != items.end(); ++it) {
-            c.Add(it->get());
-        }
-        first->Merge(addressof(c));
-        target.WriteTObject(first.get());
-    }
-}
-
 void do_nativemode(const string& outputfile, const list<string>& inputfiles) {
     Bool_t force = kTRUE; // changed from defaults
     Bool_t skip_errors = kFALSE;
@@ -215,6 +91,8 @@ int main( int argc, char **argv )
    auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
    auto cmd_nativemode = cmd.add<TCLAP::MultiSwitchArg>("","native","Run native TFileMerger, is slow on large trees",false);
    auto cmd_filenames  = cmd.add<TCLAP::UnlabeledMultiArg<string>>("files","ROOT files, first one is output",true,"ROOT files");
+   auto cmd_jobs = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs","Merge in parallel tree reduction with this many worker processes",false,1,"jobs");
+   auto cmd_memory = cmd.add<TCLAP::ValueArg<unsigned>>("m","memory","Memory budget in MB per directory level (and worker), partial sums are spilled to temporary files if exceeded. 0 means unlimited.",false,0,"MB");
    cmd.parse(argc, argv);
    if(cmd_verbose->isSet()) {
        el::Loggers::setVerboseLevel(cmd_verbose->getValue());
@@ -244,23 +122,40 @@ int main( int argc, char **argv )
        exit(EXIT_SUCCESS);
    }
 
-   auto outputfile = std_ext::make_unique<TFile>(outputfilename.c_str(), "RECREATE");
-   sources_t sources;
-   for(const auto& filename : filenames) {
-       sources.emplace_back(std_ext::make_unique<TFile>(filename.c_str(), "READ"));
-   }
+   const vector<string> inputfilenames(filenames.begin(), filenames.end());
+
+   analysis::utils::FileMerger merger;
+   merger.MemoryBudget = size_t(cmd_memory->getValue()) << 20;
+
+   double inputMB = 0;
+   for(const auto& filename : inputfilenames)
+       inputMB += std_ext::system::getFileSizeMB(filename);
 
    ProgressCounter::Interval = 2;
-   ProgressCounter progress([] (chrono::duration<double> elapsed) {
-       LOG(INFO) << nPaths/elapsed.count() << " paths/s";
-       nPaths = 0;
+   unsigned long long nPaths_last = 0;
+   const auto nJobs = min<size_t>(cmd_jobs->getValue(), inputfilenames.size());
+   ProgressCounter progress([&merger, &nPaths_last, nJobs] (chrono::duration<double> elapsed) {
+       // the parallel merge is done by workers, whose progress is shown by the ProcessPool
+       if(nJobs > 1)
+           return;
+       LOG(INFO) << (merger.GetNPaths()-nPaths_last)/elapsed.count() << " paths/s";
+       nPaths_last = merger.GetNPaths();
    });
 
-   MergeRecursive(*outputfile, sources);
+   const bool success = nJobs > 1 ?
+                            merger.MergeParallel(outputfilename, inputfilenames, nJobs) :
+                            merger.MergeFiles(outputfilename, inputfilenames);
 
-   LOG(INFO) << "Finished, writing file " << outputfile->GetName();
+   if(!success) {
+       LOG(ERROR) << "Merging failed";
+       exit(EXIT_FAILURE);
+   }
 
-   outputfile->Write();
+   const auto secs = progress.GetTotalSecs();
+   LOG(INFO) << "Finished, merged " << inputfilenames.size() << " files ("
+             << inputMB << " MB) into " << outputfilename << " in "
+             << ProgressCounter::TimeToStr(secs) << ", "
+             << inputMB/secs << " MB/s, " << inputfilenames.size()/secs << " files/s";
 
    exit(EXIT_SUCCESS);
 }
@@ -21,9 +21,13 @@
 #include "TClonesArray.h"
 #include "TMath.h"
 #include "TRandom.h"
+#include "TRandom3.h"
 
 // detail
 #include "detail/McAction.h"
+#include "detail/McShards.h"
+
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
@@ -81,37 +85,36 @@ struct GunAction : McAction {
     double   thetaMin;
     double   thetaMax;
     double   openAngle;
+    unsigned seed = 0;
+
+    /// number of events for which the kinematics are drawn at once
+    static constexpr unsigned BlockSize = 4096;
+
+    /// momenta of one particle for a block of events, in GeV
+    struct block_t {
+        vector<double> X, Y, Z;
+        explicit block_t(size_t n) : X(n), Y(n), Z(n) {}
+    };
+
+    /// random numbers for a block of events, filled by TRandom::RndmArray
+    struct uniforms_t {
+        vector<double> U, V;
+        explicit uniforms_t(size_t n) : U(n), V(n) {}
+        void Fill(TRandom& rng, size_t n) {
+            rng.RndmArray(int(n), U.data());
+            rng.RndmArray(int(n), V.data());
+        }
+    };
 
-    vec3 getRandomDir() const
-    {
-        ant::vec3 dir;
-        do {
-            gRandom->Sphere(dir.x, dir.y, dir.z,1.0);
-        } while (dir.Theta() > thetaMax || dir.Theta() < thetaMin);
-        return dir;
-    }
-
-    double getRandomMomentum(const ParticleTypeDatabase::Type* type) const
-    {
-        const auto m = type->Mass() / GeV;
-        const auto E = (Emin  + gRandom->Uniform( Emax - Emin))/ GeV + m;
-        const auto p = sqrt(E*E - m*m);
-        return p;
-    }
-
-    vec3 getRandomDirInCone(const vec3 center) const
-    {
-        ant::vec3 dir;
-        do {
-            gRandom->Sphere(dir.x, dir.y, dir.z,1.0);
-        } while (center.Angle(dir) > openAngle);
-        return dir;
-    }
-
+    void drawDirs(TRandom& rng, uniforms_t& u, size_t n, block_t& dirs) const;
+    void drawDirsInCone(TRandom& rng, uniforms_t& u, size_t n, const block_t& centers, block_t& dirs) const;
+    void scaleToMomenta(TRandom& rng, uniforms_t& u, size_t n, const ParticleTypeDatabase::Type* type, block_t& dirs) const;
 
     virtual void Run() const override;
 };
 
+constexpr unsigned GunAction::BlockSize;
+
 
 
 int main( int argc, char** argv ) {
@@ -137,6 +140,8 @@ int main( int argc, char** argv ) {
 
     auto cmd_noTID     = cmd.add<TCLAP::SwitchArg>             ("",  "noTID",        "Don't add TID tree for the events", false);
     auto cmd_verbose   = cmd.add<TCLAP::ValueArg<int>>         ("v", "verbose",      "Verbosity level (0..9)", false, 0,"int");
+    auto cmd_seed      = cmd.add<TCLAP::ValueArg<unsigned>>    ("",  "seed",         "Seed for reproducible output, 0 means random", false, 0, "seed");
+    auto cmd_shards    = cmd.add<TCLAP::ValueArg<unsigned>>    ("j", "shards",       "Generate in this many independent worker processes and merge afterwards", false, 1, "shards");
 
 
     cmd.parse(argc, argv);
@@ -159,18 +164,31 @@ int main( int argc, char** argv ) {
     action.Emin    = cmd_Emin->getValue();
     action.Emax    = cmd_Emax->getValue();
 
-    VLOG(2) << "gRandom is a " << gRandom->ClassName();
-    gRandom->SetSeed();
-    VLOG(2) << "gRandom initialized";
+    const auto nShards = std::max(1u, cmd_shards->getValue());
+    const auto timestamp = McShard::GetTimestamp();
+    const auto shards = McShard::Make(action.outfile, action.nEvents, nShards, cmd_seed->getValue());
 
-    action.Run();
+    auto generate = [&] (const McShard& shard) {
+        GunAction shard_action(action);
+        shard_action.outfile = shard.Outfile;
+        shard_action.nEvents = shard.nEvents;
+        shard_action.seed    = shard.Seed;
+        shard_action.Run();
 
-    LOG(INFO) << "Simulation finished.";
+        LOG(INFO) << "Simulation finished.";
 
-    // add TID tree for the generated events
-    if(!cmd_noTID->isSet()) {
-        LOG(INFO) << "Add TID tree to the output file";
-        mc::pluto::utils::PlutoTID::AddTID(action.outfile);
+        // add TID tree for the generated events,
+        // offset by the events of the previous shards to keep them disjoint
+        if(!cmd_noTID->isSet()) {
+            LOG(INFO) << "Add TID tree to the output file";
+            mc::pluto::utils::PlutoTID::AddTID(shard.Outfile, timestamp, shard.FirstEvent, shard.Seed);
+        }
+        return true;
+    };
+
+    if(!McShard::Run(shards, generate) || !McShard::Merge(shards, action.outfile)) {
+        LOG(ERROR) << "Simulation failed";
+        return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
@@ -204,32 +222,105 @@ void GunAction::Run() const
     WrapTFileOutput file(outfile);
 
     TTree* tree = file.CreateInside<TTree>("data","Random Particles");
+    // flush the baskets once per block
+    tree->SetAutoFlush(BlockSize);
 
     TClonesArray* particles_array = new TClonesArray("PParticle", int(particles.size()));
     particles_array->SetOwner(kTRUE);
 
+    // the particle types are the same in every event,
+    // so construct them once and only update the momenta
+    vector<PParticle*> pparticles;
+    for(auto type : particles)
+        pparticles.push_back(new ((*particles_array)[pparticles.size()]) PParticle(type->PlutoID(), vec3{0,0,0}));
+
     tree->Branch("Particles", particles_array);
 
     // ALL in GeV from here!!!!
 
-    vec3 dirFirst;
-    for( unsigned evt=0; evt< nEvents; ++evt ) {
+    TRandom3 rng(seed);
+    uniforms_t uniforms(BlockSize);
+    vector<block_t> momenta(nParticles, block_t(BlockSize));
 
-        particles_array->Clear();
+    for(unsigned long first=0; first < nEvents; first += BlockSize) {
+        const size_t n = std::min<unsigned long>(BlockSize, nEvents - first);
 
-        for( unsigned iParticle=0; iParticle<nParticles; ++iParticle ) {
+        // directions first, as the cone needs the direction of the first particle
+        for(unsigned iParticle=0; iParticle<nParticles; ++iParticle ) {
             if (iParticle==0 || std::isnan(openAngle))
-            {
-                const auto randomDir = getRandomDir() * getRandomMomentum(particles.at(iParticle));
-                (*particles_array)[iParticle] = new PParticle(particles.at(iParticle)->PlutoID(),randomDir);
-                if (iParticle == 0)
-                    dirFirst = randomDir;
-            }
-            else{
-                const auto dirCone = getRandomDirInCone(dirFirst) * getRandomMomentum(particles.at(iParticle));
-                (*particles_array)[iParticle] = new PParticle(particles.at(iParticle)->PlutoID(),dirCone);
+                drawDirs(rng, uniforms, n, momenta[iParticle]);
+            else
+                drawDirsInCone(rng, uniforms, n, momenta.front(), momenta[iParticle]);
+        }
+
+        for(unsigned iParticle=0; iParticle<nParticles; ++iParticle )
+            scaleToMomenta(rng, uniforms, n, particles[iParticle], momenta[iParticle]);
+
+        for(size_t evt=0; evt<n; ++evt) {
+            for(unsigned iParticle=0; iParticle<nParticles; ++iParticle ) {
+                const auto& p = momenta[iParticle];
+                pparticles[iParticle]->SetXYZM(p.X[evt], p.Y[evt], p.Z[evt], particles[iParticle]->Mass() / GeV);
             }
+            tree->Fill();
         }
-        tree->Fill();
+
+        ProcessPool::ReportProgress(double(first + n)/nEvents);
+    }
+}
+
+void GunAction::drawDirs(TRandom& rng, uniforms_t& u, size_t n, block_t& dirs) const
+{
+    // uniform in cos(theta) within the theta range is isotropic,
+    // so no rejection sampling is needed
+    const auto cosMin = std::cos(thetaMax);
+    const auto cosMax = std::cos(thetaMin);
+
+    u.Fill(rng, n);
+    for(size_t i=0;i<n;i++) {
+        const auto cosTheta = cosMin + u.U[i]*(cosMax - cosMin);
+        const auto sinTheta = std::sqrt(1.0 - cosTheta*cosTheta);
+        const auto phi = 2.0*M_PI*u.V[i];
+        dirs.X[i] = sinTheta*std::cos(phi);
+        dirs.Y[i] = sinTheta*std::sin(phi);
+        dirs.Z[i] = cosTheta;
+    }
+}
+
+void GunAction::drawDirsInCone(TRandom& rng, uniforms_t& u, size_t n, const block_t& centers, block_t& dirs) const
+{
+    // isotropic around the z axis within the opening angle,
+    // then rotated to the given center directions
+    const auto cosOpen = std::cos(openAngle);
+
+    u.Fill(rng, n);
+    for(size_t i=0;i<n;i++) {
+        const auto cosAlpha = cosOpen + u.U[i]*(1.0 - cosOpen);
+        const auto sinAlpha = std::sqrt(1.0 - cosAlpha*cosAlpha);
+        const auto phi = 2.0*M_PI*u.V[i];
+
+        const vec3 c(centers.X[i], centers.Y[i], centers.Z[i]);
+        // orthonormal basis around c, using the axis least parallel to it
+        const vec3 a = std::abs(c.z) < 0.9 ? vec3(0,0,1) : vec3(1,0,0);
+        const vec3 e1 = c.Cross(a).Unit();
+        const vec3 e2 = c.Cross(e1);
+
+        const vec3 dir = e1*(sinAlpha*std::cos(phi)) + e2*(sinAlpha*std::sin(phi)) + c*cosAlpha;
+        dirs.X[i] = dir.x;
+        dirs.Y[i] = dir.y;
+        dirs.Z[i] = dir.z;
+    }
+}
+
+void GunAction::scaleToMomenta(TRandom& rng, uniforms_t& u, size_t n, const ParticleTypeDatabase::Type* type, block_t& dirs) const
+{
+    const auto m = type->Mass() / GeV;
+
+    rng.RndmArray(int(n), u.U.data());
+    for(size_t i=0;i<n;i++) {
+        const auto E = (Emin + u.U[i]*(Emax - Emin))/GeV + m;
+        const auto p = std::sqrt(E*E - m*m);
+        dirs.X[i] *= p;
+        dirs.Y[i] *= p;
+        dirs.Z[i] *= p;
     }
 }
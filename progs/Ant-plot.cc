@@ -5,15 +5,26 @@
 #include "base/std_ext/string.h"
 #include "base/std_ext/system.h"
 #include "base/ProgressCounter.h"
+#include "base/ProcessPool.h"
+#include "base/tmpfile_t.h"
+#include "base/interval.h"
 #include "analysis/physics/Plotter.h"
 
 #include "tree/TAntHeader.h"
 #include "expconfig/ExpConfig.h"
+#include "root-addons/analysis_codes/hstack.h"
 
 #include "TSystem.h"
 #include "TRint.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TClass.h"
+#include "TH1.h"
 
 #include <list>
+#include <fstream>
+#include <thread>
+#include <chrono>
 
 using namespace ant;
 using namespace ant::analysis;
@@ -34,6 +45,117 @@ using plotter_list_t = std::list<Plotter_list_entry>;
 
 volatile static bool interrupt = false;
 
+void ProcessEntries(plotter_list_t& plotters, long long& entry, const interval<long long>& range) {
+
+    plotters.sort(); // sort by max entries
+
+    auto p = plotters.begin();
+
+    const auto advp = [&p,&plotters] (const long long& i) {
+        while(i>=p->entries) {
+            ++p;
+            if(p==plotters.end())
+                return false;
+        }
+        return true;
+    };
+
+    for(entry = range.Start(); !interrupt && advp(entry) && entry < range.Stop(); ++entry) {
+
+        for(auto plotter = p; plotter!=plotters.end(); ++plotter) {
+                plotter->plotter->ProcessEntry(entry);
+        }
+
+        ProgressCounter::Tick();
+
+        if(interrupt)
+            break;
+    }
+}
+
+/**
+ * @brief MergeInto adds the objects written by a worker to the already existing ones in target
+ * @param target directory where the plotters of this process live
+ * @param source directory of the worker output file
+ *
+ * Histograms and hstacks are matched by their path. Objects which only exist in the
+ * worker output, e.g. lazily created histograms of cuttree::StackedHists_t, are moved over.
+ * gDirectory should point to the top level target directory while merging,
+ * as hstacks look up their histograms by path when being read.
+ */
+void MergeInto(TDirectory& target, TDirectory& source)
+{
+    TList* keys = source.GetListOfKeys();
+    if(!keys)
+        return;
+
+    TIter nextk(keys);
+    string prev_keyname;
+    while(auto key = dynamic_cast<TKey*>(nextk()))
+    {
+        // prevent objects with different cycles
+        const string keyname = key->GetName();
+        if(prev_keyname == keyname)
+            continue;
+        prev_keyname = keyname;
+
+        auto cl = TClass::GetClass(key->GetClassName());
+
+        if(cl->InheritsFrom(TDirectory::Class())) {
+            auto source_dir = dynamic_cast<TDirectory*>(key->ReadObj());
+            TDirectory* target_dir = nullptr;
+            target.GetObject(keyname.c_str(), target_dir);
+            if(!target_dir)
+                target_dir = target.mkdir(keyname.c_str());
+            MergeInto(*target_dir, *source_dir);
+        }
+        else if(cl->InheritsFrom(TH1::Class())) {
+            unique_ptr<TH1> hist(dynamic_cast<TH1*>(key->ReadObj()));
+            auto target_hist = dynamic_cast<TH1*>(target.Get(keyname.c_str()));
+            if(target_hist) {
+                target_hist->Add(hist.get());
+            }
+            else {
+                hist->SetDirectory(addressof(target));
+                hist.release();
+            }
+        }
+        else if(cl->InheritsFrom(hstack::Class())) {
+            unique_ptr<hstack> stack(dynamic_cast<hstack*>(key->ReadObj()));
+            auto target_stack = dynamic_cast<hstack*>(target.Get(keyname.c_str()));
+            if(target_stack) {
+                // only adds the hist paths missing in target_stack
+                TList l;
+                l.Add(stack.get());
+                target_stack->Merge(addressof(l), nullptr);
+            }
+            else {
+                target.Append(stack.release());
+            }
+        }
+        else {
+            LOG(WARNING) << "Ignoring object " << source.GetPath() << "/" << keyname
+                         << " of class " << key->GetClassName() << " in worker output";
+        }
+    }
+}
+
+struct worker_t {
+    interval<long long> Range;
+    tmpfile_t Output;
+    // number of processed entries, written by the worker when done,
+    // which is less than the range if it was interrupted
+    tmpfile_t Processed;
+    long long ReadProcessed() const {
+        ifstream f(Processed.filename);
+        long long n = -1;
+        f >> n;
+        return n;
+    }
+    worker_t(const interval<long long>& range, const tmpfolder_t& folder) :
+        Range(range), Output(folder, ".root"), Processed(folder, ".txt") {}
+};
+
 int main(int argc, char** argv) {
     SetupLogger();
 
@@ -56,6 +178,7 @@ int main(int argc, char** argv) {
     auto cmd_maxevents = cmd.add<TCLAP::ValueArg<int>>("m","maxevents","Process only max events",false,0,"maxevents");
 
     auto cmd_options = cmd.add<TCLAP::MultiArg<string>>("O","options","Options for all physics classes, key=value",false,"");
+    auto cmd_jobs = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs","Split entries over this many worker processes, if all plotters are parallel-safe",false,1,"jobs");
 
     cmd.parse(argc, argv);
     if(cmd_verbose->isSet()) {
@@ -89,26 +212,37 @@ int main(int argc, char** argv) {
         masterFile = std_ext::make_unique<WrapTFileOutput>(cmd_output->getValue(), true, WrapTFileOutput::mode_t::recreate);
     }
 
-    plotter_list_t plotters;
-    long long maxEntries = 0;
-    {
-        auto popts = make_shared<OptionsList>();
-
-        if(cmd_options->isSet()) {
-            for(const auto& opt : cmd_options->getValue()) {
-                popts->SetOption(opt);
-            }
+    auto popts = make_shared<OptionsList>();
+    if(cmd_options->isSet()) {
+        for(const auto& opt : cmd_options->getValue()) {
+            popts->SetOption(opt);
         }
+    }
 
+    const auto create_plotters = [&cmd_plotters] (const WrapTFileInput& input, OptionsPtr opts, plotter_list_t& plotters) {
         for(const auto& plotter_name : cmd_plotters->getValue()) {
             try {
-                plotters.emplace_back(PlotterRegistry::Create(plotter_name, inputfile, popts));
-                maxEntries = max(maxEntries, plotters.back().entries);
+                plotters.emplace_back(PlotterRegistry::Create(plotter_name, input, opts));
             } catch(const exception& e) {
                 LOG(ERROR) << "Could not create plotter \"" << plotter_name << "\": " << e.what();
-                return EXIT_FAILURE;
+                return false;
             }
         }
+        return true;
+    };
+
+    // remember where the plotters put their histograms,
+    // as worker output is merged into there
+    TDirectory* plotterDir = gDirectory;
+
+    plotter_list_t plotters;
+    long long maxEntries = 0;
+    {
+        if(!create_plotters(inputfile, popts, plotters))
+            return EXIT_FAILURE;
+
+        for(const auto& plotter : plotters)
+            maxEntries = max(maxEntries, plotter.entries);
 
         auto unused_popts = popts->GetUnused();
         if(!unused_popts.empty()) {
@@ -123,13 +257,67 @@ int main(int argc, char** argv) {
         maxEntries = min(maxEntries, static_cast<long long>(cmd_maxevents->getValue()));
     }
 
+    unsigned nJobs = cmd_jobs->getValue();
+    if(nJobs > 1) {
+        for(const auto& plotter : plotters) {
+            if(!plotter.plotter->IsParallelSafe()) {
+                LOG(WARNING) << "Plotter " << plotter.plotter->GetName()
+                             << " is not parallel-safe, running with one job only";
+                nJobs = 1;
+                break;
+            }
+        }
+    }
+    if(nJobs > maxEntries)
+        nJobs = static_cast<unsigned>(max(1ll, maxEntries));
+
     long long entry;
+    interval<long long> range(0, maxEntries);
+
+    // the worker outputs only live until merged, and the working directory might not be writable
+    unique_ptr<tmpfolder_t> workerFolder;
+    if(nJobs > 1)
+        workerFolder = std_ext::make_unique<tmpfolder_t>(tmpfolder_t::ParentFor(cmd_output->getValue()));
+
+    // split the entries into nJobs ranges, the first one is processed by this process
+    std::list<worker_t> workers;
+    for(unsigned i=1;i<nJobs;i++) {
+        workers.emplace_back(interval<long long>(i*maxEntries/nJobs, (i+1)*maxEntries/nJobs), *workerFolder);
+    }
+    range = {0, maxEntries/nJobs};
+
+    ProcessPool pool(nJobs-1, addressof(interrupt));
+    for(auto& worker : workers) {
+        pool.Add(std_ext::formatter() << "for entries " << worker.Range,
+                 [&worker, &entry, &range, &cmd_input, &popts, &create_plotters] () {
+            range = worker.Range;
+            // own input file and plotter instances, filling into worker output file,
+            // which is recreated if the worker is retried
+            WrapTFileInput worker_input(cmd_input->getValue());
+            WrapTFileOutput worker_output(worker.Output.filename, true);
+            plotter_list_t worker_plotters;
+            if(!create_plotters(worker_input, popts, worker_plotters))
+                return false;
+            ProcessEntries(worker_plotters, entry, range);
+            ofstream processed(worker.Processed.filename);
+            processed << entry - range.Start() << endl;
+            return static_cast<bool>(processed);
+        });
+    }
 
     ProgressCounter progress(
-                [&entry, maxEntries]
+                [&entry, &range, &pool, nJobs]
                 (std::chrono::duration<double> elapsed)
     {
-        const double percent = double(entry)/maxEntries;
+        double percent = double(entry - range.Start())/(range.Stop() - range.Start());
+
+        // as worker, the parent shows the progress
+        if(ProcessPool::ReportProgress(percent))
+            return;
+
+        // meanwhile, finished workers are collected and failed ones retried
+        pool.Poll();
+        percent = (percent + (nJobs-1)*pool.GetProgress())/nJobs;
 
         static double last_PercentDone = 0;
         const double speed = (percent - last_PercentDone)/elapsed.count();
@@ -140,34 +328,52 @@ int main(int argc, char** argv) {
 
     ProgressCounter::Interval = 5; //sec
 
-    plotters.sort(); // sort by max entries
-
-    auto p = plotters.begin();
-
-    const auto advp = [&p,&plotters] (const long long& i) {
-        while(i>=p->entries) {
-            ++p;
-            if(p==plotters.end())
-                return false;
-        }
-        return true;
-    };
+    // starts the workers
+    pool.Poll();
+    if(!workers.empty())
+        LOG(INFO) << "Started " << workers.size() << " worker processes";
 
-    for(entry = 0; !interrupt && advp(entry) && entry < maxEntries; ++entry) {
+    ProcessEntries(plotters, entry, range);
 
-        for(auto plotter = p; plotter!=plotters.end(); ++plotter) {
-                plotter->plotter->ProcessEntry(entry);
-        }
+    long long nEntries = entry - range.Start();
 
+    // wait for the workers, the progress above includes them
+    while(pool.Poll()) {
+        this_thread::sleep_for(chrono::milliseconds(100));
         ProgressCounter::Tick();
-
-        if(interrupt)
-            break;
     }
 
+    bool workers_ok = true;
+    unsigned workerIndex = 0;
+    for(auto& worker : workers) {
+        if(!pool.Succeeded(workerIndex++)) {
+            LOG(ERROR) << "Worker process for entries " << worker.Range << " failed";
+            workers_ok = false;
+            continue;
+        }
+        TFile worker_file(worker.Output.filename.c_str(), "READ");
+        if(worker_file.IsZombie()) {
+            LOG(ERROR) << "Cannot open output of worker for entries " << worker.Range;
+            workers_ok = false;
+            continue;
+        }
+        // opening the file changed gDirectory, but the hist paths of the
+        // hstacks read from the worker output should resolve into plotterDir
+        plotterDir->cd();
+        MergeInto(*plotterDir, worker_file);
+        const auto processed = worker.ReadProcessed();
+        if(processed < 0) {
+            LOG(ERROR) << "Cannot read number of processed entries of worker for entries " << worker.Range;
+            workers_ok = false;
+            continue;
+        }
+        nEntries += processed;
+    }
+    if(!workers_ok)
+        return EXIT_FAILURE;
 
-    LOG(INFO) << "Analyzed " << entry << " records"
-              << ", speed " << entry/progress.GetTotalSecs() << " event/s";
+    LOG(INFO) << "Analyzed " << nEntries << " records"
+              << ", speed " << nEntries/progress.GetTotalSecs() << " event/s";
 
     for(auto& plotter : plotters) {
         plotter.plotter->Finish();
@@ -28,6 +28,7 @@
 #include "base/vec/vec3.h"
 #include "mc/pluto/PlutoExtensions.h"
 #include "mc/pluto/utils/PlutoTID.h"
+#include "detail/McShards.h"
 
 
 // pluto++
@@ -48,6 +49,7 @@
 
 #include <string>
 #include <memory>
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
@@ -91,6 +93,8 @@ int main( int argc, char** argv ) {
     auto cmd_Emax      = cmd.add<TCLAP::ValueArg<double>>    ("",  "Emax", "Maximal incident energy [MeV]", false, 1.6*GeV, "double [MeV]");
     auto cmd_noTID     = cmd.add<TCLAP::SwitchArg>           ("",  "noTID", "Don't add TID tree for the events", false);
     auto cmd_verbose   = cmd.add<TCLAP::ValueArg<int>>       ("v", "verbose","Verbosity level (0..9)", false, 0,"int");
+    auto cmd_seed      = cmd.add<TCLAP::ValueArg<unsigned>>  ("",  "seed", "Seed for reproducible output, 0 means random", false, 0, "seed");
+    auto cmd_shards    = cmd.add<TCLAP::ValueArg<unsigned>>  ("j", "shards", "Generate in this many independent worker processes and merge afterwards", false, 1, "shards");
 
     // reaction simulation options
     auto cmd_reaction = cmd.add<TCLAP::ValueArg<string>> ("", "reaction", "Pseudo Beam - decay string (reaction string), e.g. 'p pi0 [g g]' for pion photoproduction", true, "", "g p decay string");
@@ -126,24 +130,41 @@ int main( int argc, char** argv ) {
     action.Emax    = cmd_Emax->getValue();
 
     VLOG(2) << "gRandom is a " << gRandom->ClassName();
-    gRandom->SetSeed();
-    VLOG(2) << "gRandom initialized";
 
-    action.Run();
+    string outfile = action.outfile;
+    if(!string_ends_with(outfile, ".root"))
+        outfile += ".root";
 
-    LOG(INFO) << "Simulation finished.";
+    const auto nShards = std::max(1u, cmd_shards->getValue());
+    const auto timestamp = McShard::GetTimestamp();
+    const auto shards = McShard::Make(outfile, action.nEvents, nShards, cmd_seed->getValue());
 
-    // Do not delete the reaction, otherwise: infinite loop somewhere in ROOT...
-    //delete reactrion;
+    auto generate = [&] (const McShard& shard) {
+        gRandom->SetSeed(shard.Seed);
+        VLOG(2) << "gRandom initialized";
 
-    // add TID tree for the generated events
-    if(!cmd_noTID->isSet()) {
-        LOG(INFO) << "Add TID tree to the output file";
-        string outfile = action.outfile;
-        if(!string_ends_with(outfile, ".root"))
-            outfile += ".root";
+        PlutoAction shard_action(action);
+        shard_action.outfile = shard.Outfile;
+        shard_action.nEvents = shard.nEvents;
+        shard_action.Run();
 
-        mc::pluto::utils::PlutoTID::AddTID(outfile);
+        LOG(INFO) << "Simulation finished.";
+
+        // Do not delete the reaction, otherwise: infinite loop somewhere in ROOT...
+        //delete reactrion;
+
+        // add TID tree for the generated events,
+        // offset by the events of the previous shards to keep them disjoint
+        if(!cmd_noTID->isSet()) {
+            LOG(INFO) << "Add TID tree to the output file";
+            mc::pluto::utils::PlutoTID::AddTID(shard.Outfile, timestamp, shard.FirstEvent, shard.Seed);
+        }
+        return true;
+    };
+
+    if(!McShard::Run(shards, generate) || !McShard::Merge(shards, outfile)) {
+        LOG(ERROR) << "Simulation failed";
+        return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
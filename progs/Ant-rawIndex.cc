@@ -0,0 +1,132 @@
+#include "expconfig/ExpConfig.h"
+#include "unpacker/Unpacker.h"
+#include "unpacker/RawFileReader.h"
+#include "unpacker/RawFileIndex.h"
+
+#include "base/std_ext/system.h"
+#include "base/ProgressCounter.h"
+#include "tclap/CmdLine.h"
+#include "base/Logger.h"
+
+#include <memory>
+#include <cstdio>
+#include <signal.h>
+
+using namespace std;
+using namespace ant;
+
+static volatile bool interrupt = false;
+
+bool createIndex(const string& inputfile) {
+
+    // the index is saved by the unpacker once the file was read completely
+    std::unique_ptr<Unpacker::Module> unpacker;
+    try {
+        unpacker = Unpacker::Get(inputfile);
+    }
+    catch(Unpacker::Exception e) {
+        LOG(ERROR) << "Unpacker exception: " << e.what();
+        return false;
+    }
+    catch(RawFileReader::Exception e) {
+        LOG(ERROR) << "Unpacker: Error opening file "<<inputfile<<": " << e.what();
+        return false;
+    }
+    catch(ExpConfig::ExceptionNoSetup) {
+        LOG(ERROR) << "The inputfile " << inputfile << " cannot be unpacked without a manually specified setupname";
+        return false;
+    }
+
+    unsigned nEvents = 0;
+    unsigned nEvents_last = 0;
+    ProgressCounter progress(
+                [&nEvents, &nEvents_last] (std::chrono::duration<double> elapsed) {
+        LOG(INFO) << "Read " << nEvents << " events, "
+                  << (nEvents-nEvents_last)/elapsed.count() << " events/s";
+        nEvents_last = nEvents;
+    });
+    while(auto event = unpacker->NextEvent()) {
+        if(interrupt)
+            return false;
+        nEvents++;
+        ProgressCounter::Tick();
+    }
+
+    auto index = RawFileIndex::Load(inputfile);
+    if(!index) {
+        LOG(ERROR) << "Could not create index for " << inputfile;
+        return false;
+    }
+
+    unsigned nEventsIndex = 0;
+    unsigned nScalerBuffers = 0;
+    for(const auto& b : index->Buffers) {
+        nEventsIndex += b.nEvents;
+        if(b.HasScalers)
+            nScalerBuffers++;
+    }
+
+    LOG(INFO) << "Index " << RawFileIndex::GetFilename(inputfile) << ": "
+              << index->Buffers.size() << " buffers, "
+              << nEventsIndex << " events, "
+              << nScalerBuffers << " buffers with scalers, "
+              << index->AccessPoints.size() << " access points";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SetupLogger();
+
+    signal(SIGINT, [] (int) {
+        interrupt = true;
+    });
+
+    TCLAP::CmdLine cmd("Ant-rawIndex", ' ', "0.1");
+
+    auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
+    auto cmd_input  = cmd.add<TCLAP::MultiArg<string>>("i","input","Input raw files",true,"filename");
+    auto cmd_setup  = cmd.add<TCLAP::ValueArg<string>>("s","setup","Choose setup manually by name",false,"","setup");
+    auto cmd_force = cmd.add<TCLAP::SwitchArg>("","force","Recreate index even if up-to-date one exists",false);
+
+    cmd.parse(argc, argv);
+    if(cmd_verbose->isSet()) {
+        el::Loggers::setVerboseLevel(cmd_verbose->getValue());
+    }
+
+    if(std_ext::system::isInteractive())
+        ProgressCounter::Interval = 3;
+
+    if(cmd_setup->isSet()) {
+        ExpConfig::Setup::SetByName(cmd_setup->getValue());
+        LOG(INFO) << "Commandline override setup name to '" << cmd_setup->getValue() << "'";
+    }
+
+    RawFileIndex::CreateOnRead = true;
+
+    bool success = true;
+    for(const auto& inputfile : cmd_input->getValue()) {
+        if(interrupt)
+            break;
+
+        string errmsg;
+        if(!std_ext::system::testopen(inputfile, errmsg)) {
+            LOG(ERROR) << "Cannot open inputfile '" << inputfile << "': " << errmsg;
+            success = false;
+            continue;
+        }
+
+        if(RawFileIndex::Load(inputfile)) {
+            if(!cmd_force->isSet()) {
+                LOG(INFO) << "Index for " << inputfile << " is up-to-date";
+                continue;
+            }
+            remove(RawFileIndex::GetFilename(inputfile).c_str());
+        }
+
+        LOG(INFO) << "Creating index for " << inputfile;
+        if(!createIndex(inputfile))
+            success = false;
+    }
+
+    return success && !interrupt ? EXIT_SUCCESS : EXIT_FAILURE;
+}
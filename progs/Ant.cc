@@ -9,6 +9,7 @@
 #include "analysis/input/goat/GoatReader.h"
 #include "analysis/input/pluto/PlutoReader.h"
 #include "analysis/utils/ParticleID.h"
+#include "analysis/utils/FileMerger.h"
 #include "analysis/physics/PhysicsManager.h"
 
 #include "expconfig/ExpConfig.h"
@@ -19,6 +20,7 @@
 
 #include "unpacker/Unpacker.h"
 #include "unpacker/RawFileReader.h"
+#include "unpacker/RawFileIndex.h"
 
 #include "reconstruct/Reconstruct.h"
 
@@ -31,21 +33,130 @@
 #include "base/WrapTFile.h"
 #include "base/std_ext/system.h"
 #include "base/std_ext/container.h"
+#include "base/std_ext/string.h"
 #include "base/GitInfo.h"
+#include "base/ProcessPool.h"
+#include "base/tmpfile_t.h"
 
 #include "TRint.h"
 #include "TSystem.h"
+#include "TFile.h"
 
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <csignal>
 
+#include <unistd.h>
+
 using namespace std;
 using namespace ant;
 
 volatile bool interrupt = false;
 volatile bool terminated = false;
 
+/**
+ * @brief split_inputfiles distributes the input files over the workers of --jobs
+ * @param inputfiles all input files
+ * @param nJobs number of concurrent workers
+ * @return input files of each worker, always the same for the same arguments
+ *
+ * Raw files get one worker each, as only one unpacker is handled per process.
+ * ROOT files are split into nJobs contiguous groups of about equal size.
+ * Mixing both is not supported and gives an empty list.
+ */
+vector<vector<string>> split_inputfiles(const vector<string>& inputfiles, unsigned nJobs)
+{
+    const auto nROOTfiles = count_if(inputfiles.begin(), inputfiles.end(), WrapTFile::hasROOTmagic);
+
+    vector<vector<string>> shares;
+    if(nROOTfiles == 0) {
+        for(const auto& inputfile : inputfiles)
+            shares.emplace_back(1, inputfile);
+    }
+    else if(size_t(nROOTfiles) == inputfiles.size()) {
+        const auto nShares = min<size_t>(nJobs, inputfiles.size());
+        for(size_t i=0;i<nShares;i++) {
+            shares.emplace_back(next(inputfiles.begin(), i*inputfiles.size()/nShares),
+                                next(inputfiles.begin(), (i+1)*inputfiles.size()/nShares));
+        }
+    }
+    return shares;
+}
+
+/**
+ * @brief run_jobs runs workers over the shares of input files and merges their output
+ * @return exit code
+ *
+ * Each worker executes this program again with the same arguments, selecting its share
+ * with --job_index. So any worker can be reproduced by hand, and failed workers are simply started again.
+ */
+int run_jobs(int argc, char** argv, const vector<vector<string>>& shares, const string& outputfile, unsigned nJobs)
+{
+    // prefer the actual executable over argv[0], which might have been found via PATH
+    string executable(argv[0]);
+    {
+        char buf[4096];
+        const auto n = readlink("/proc/self/exe", buf, sizeof(buf)-1);
+        if(n > 0)
+            executable.assign(buf, n);
+    }
+
+    tmpfolder_t folder;
+    vector<string> outputs;
+
+    ProcessPool pool(nJobs, addressof(interrupt));
+    for(unsigned i=0;i<shares.size();i++) {
+        outputs.emplace_back(folder.foldername + "/worker_" + to_string(i) + ".root");
+        vector<string> args{executable};
+        args.insert(args.end(), argv+1, argv+argc);
+        args.insert(args.end(), {"--job_index", to_string(i), "--job_output", outputs.back()});
+        VLOG(1) << "Worker " << i << ": " << std_ext::concatenate_string(args, " ");
+        pool.Add(std_ext::formatter() << "Worker " << i << " (" << shares[i].size() << " input files)",
+                 ProcessPool::Exec(args));
+    }
+
+    LOG(INFO) << "Running " << shares.size() << " workers, " << min<size_t>(nJobs, shares.size()) << " at once";
+
+    const bool success = pool.Wait();
+
+    vector<string> merge_inputs;
+    for(unsigned i=0;i<outputs.size();i++) {
+        if(pool.Succeeded(i))
+            merge_inputs.emplace_back(outputs[i]);
+    }
+
+    if(!success) {
+        if(!interrupt || merge_inputs.empty()) {
+            LOG(ERROR) << "Only " << merge_inputs.size() << " of " << shares.size() << " workers succeeded";
+            return EXIT_FAILURE;
+        }
+        LOG(WARNING) << "Interrupted, merging the output of " << merge_inputs.size() << " finished workers only";
+    }
+
+    LOG(INFO) << "Merging output of " << merge_inputs.size() << " workers into " << outputfile;
+    analysis::utils::FileMerger merger;
+    merger.MergeTrees = true;
+    if(!merger.MergeFiles(outputfile, merge_inputs)) {
+        LOG(ERROR) << "Merging worker output failed";
+        return EXIT_FAILURE;
+    }
+
+    // the merged header stems from the workers, so tell how the whole thing was run
+    {
+        TFile file(outputfile.c_str(), "UPDATE");
+        TAntHeader* header = nullptr;
+        file.GetObject("AntHeader", header);
+        if(header) {
+            header->CmdLine = std_ext::system::buildCmdLine(argc, argv);
+            file.WriteTObject(header, "AntHeader", "WriteDelete");
+        }
+    }
+
+    return terminated ? EXIT_FAILURE+1 : EXIT_SUCCESS;
+}
+
 
 int main(int argc, char** argv) {
     SetupLogger();
@@ -115,10 +226,19 @@ int main(int argc, char** argv) {
 
     auto cmd_calibrations  = cmd.add<TCLAP::MultiArg<string>>("c","calibration","Calibration to run",false,"calibration");
 
+    auto cmd_jobs = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs","Split input files over worker processes, run this many at once and merge their output (implies batch mode, physics classes must support it)",false,1,"jobs");
+    auto cmd_job_index = cmd.add<TCLAP::ValueArg<unsigned>>("","job_index","Internal: Run as worker of --jobs with this share of the input files",false,0,"index");
+    auto cmd_job_output = cmd.add<TCLAP::ValueArg<string>>("","job_output","Internal: Output file of worker of --jobs",false,"","filename");
+
     auto cmd_u_disablerecon  = cmd.add<TCLAP::SwitchArg>("","u_disablereconstruct","Unpacker: Disable Reconstruct (disables also all analysis)",false);
+    auto cmd_u_follow  = cmd.add<TCLAP::SwitchArg>("","u_follow","Unpacker: Follow growing raw files (UNIX sockets are always read live)",false);
+    auto cmd_u_timeout  = cmd.add<TCLAP::ValueArg<double>>("","u_timeout","Unpacker: Stop reading live data after this many seconds without new data, 0 waits forever",false,0,"seconds");
+    auto cmd_u_first  = cmd.add<TCLAP::ValueArg<unsigned>>("","u_first","Unpacker: Start with this event number (TID lower), uses raw file index",false,0,"event");
+    auto cmd_u_index  = cmd.add<TCLAP::SwitchArg>("","u_index","Unpacker: Create index of raw files on first complete read, enables --u_first for later runs",false);
 
     auto cmd_p_disableParticleID  = cmd.add<TCLAP::SwitchArg>("","p_disableParticleID","Physics: Disable ParticleID",false);
     auto cmd_p_simpleParticleID  = cmd.add<TCLAP::SwitchArg>("","p_simpleParticleID","Physics: Use simple ParticleID (just protons/photons)",false);
+    auto cmd_p_skim  = cmd.add<TCLAP::SwitchArg>("","p_skim","Physics: Save only references (file, entry, TID) of saved events to treeSkim instead of full events",false);
 
 
 
@@ -134,8 +254,18 @@ int main(int argc, char** argv) {
     // enable caching of the calibration database
     ant::calibration::DataBase::OnDiskLayout::EnableCaching = true;
 
+    // live reading of raw data
+    RawFileReader::Live.FollowFiles = cmd_u_follow->isSet();
+    RawFileReader::Live.Timeout = cmd_u_timeout->getValue();
+
+    // create index of raw files on first complete read,
+    // which costs some decompression speed for gzipped files
+    RawFileIndex::CreateOnRead = cmd_u_index->isSet();
+
     // check if input files are readable
     for(const auto& inputfile : cmd_input->getValue()) {
+        if(RawFileReader::IsSocket(inputfile))
+            continue;
         string errmsg;
         if(!std_ext::system::testopen(inputfile, errmsg)) {
             LOG(ERROR) << "Cannot open inputfile '" << inputfile << "': " << errmsg;
@@ -143,6 +273,41 @@ int main(int argc, char** argv) {
         }
     }
 
+    // the files of this process, which are only a share of them for a worker of --jobs
+    vector<string> inputfiles = cmd_input->getValue();
+    string outputfile = cmd_output->getValue();
+    bool batchmode = cmd_batchmode->isSet();
+
+    if(cmd_jobs->getValue() > 1) {
+        if(outputfile.empty()) {
+            LOG(ERROR) << "Running with " << cmd_jobs->longID() << " requires an output file";
+            return EXIT_FAILURE;
+        }
+        // the share of each worker must not depend on timing
+        if(cmd_maxevents->isSet() || cmd_u_first->isSet() || cmd_u_follow->isSet()
+           || any_of(inputfiles.begin(), inputfiles.end(), RawFileReader::IsSocket)) {
+            LOG(ERROR) << "Running with " << cmd_jobs->longID() << " cannot be combined with maxevents, live data or starting events";
+            return EXIT_FAILURE;
+        }
+        const auto shares = split_inputfiles(inputfiles, cmd_jobs->getValue());
+        if(shares.empty()) {
+            LOG(ERROR) << "Running with " << cmd_jobs->longID() << " cannot split a mixture of raw and ROOT input files";
+            return EXIT_FAILURE;
+        }
+
+        if(!cmd_job_index->isSet())
+            return run_jobs(argc, argv, shares, outputfile, cmd_jobs->getValue());
+
+        if(cmd_job_index->getValue() >= shares.size()) {
+            LOG(ERROR) << "Worker index " << cmd_job_index->getValue() << " out of range";
+            return EXIT_FAILURE;
+        }
+        inputfiles = shares[cmd_job_index->getValue()];
+        outputfile = cmd_job_output->getValue();
+        batchmode = true;
+        LOG(INFO) << "Running as worker " << cmd_job_index->getValue() << " of " << shares.size();
+    }
+
     // parse the setup options and tell the registry
     std::shared_ptr<OptionsList> setup_opts = make_shared<OptionsList>();
     if(cmd_setupOptions->isSet()) {
@@ -155,8 +320,10 @@ int main(int argc, char** argv) {
 
     // build the list of ROOT files first
     auto rootfiles = make_shared<WrapTFileInput>();
-    for(const auto& inputfile : cmd_input->getValue()) {
+    for(const auto& inputfile : inputfiles) {
         VLOG(5) << "ROOT File Manager: Looking at file " << inputfile;
+        if(RawFileReader::IsSocket(inputfile))
+            continue;
         try {
             rootfiles->OpenFile(inputfile);
         } catch (const WrapTFile::ENotARootFile& e) {
@@ -187,7 +354,7 @@ int main(int argc, char** argv) {
 
     // now we can try to open the files with an unpacker
     std::unique_ptr<Unpacker::Module> unpacker = nullptr;
-    for(const auto& inputfile : cmd_input->getValue()) {
+    for(const auto& inputfile : inputfiles) {
         VLOG(5) << "Unpacker: Looking at file " << inputfile;
         try {
             auto unpacker_ = Unpacker::Get(inputfile);
@@ -211,6 +378,15 @@ int main(int argc, char** argv) {
         }
     }
 
+    if(cmd_u_first->isSet()) {
+        if(!unpacker || !unpacker->SeekEvent(cmd_u_first->getValue())) {
+            LOG(ERROR) << "Cannot start unpacking at event " << cmd_u_first->getValue()
+                       << ", consider creating the index with Ant-rawIndex or " << cmd_u_index->longID();
+            return EXIT_FAILURE;
+        }
+        LOG(INFO) << "Unpacker starts at event " << cmd_u_first->getValue();
+    }
+
 
     // we can finally we can create the available input readers
     // for the analysis
@@ -265,13 +441,14 @@ int main(int argc, char** argv) {
     // the real output file, create it here to get all
     // further ROOT objects into this output file
     unique_ptr<WrapTFileOutput> masterFile;
-    if(cmd_output->isSet()) {
+    if(!outputfile.empty()) {
         // cd into masterFile upon creation
-        masterFile = std_ext::make_unique<WrapTFileOutput>(cmd_output->getValue(), true);
+        masterFile = std_ext::make_unique<WrapTFileOutput>(outputfile, true);
     }
 
     // add the physics/calibrationphysics modules
     analysis::PhysicsManager pm(addressof(interrupt));
+    pm.SetSkimReferences(cmd_p_skim->isSet());
     std::shared_ptr<OptionsList> popts = make_shared<OptionsList>();
 
     if(cmd_physicsOptions->isSet()) {
@@ -341,6 +518,17 @@ int main(int argc, char** argv) {
         }
     }
 
+    // a worker of --jobs only sees a share of the input,
+    // so its output must be mergeable with the other workers
+    if(cmd_jobs->getValue() > 1) {
+        const auto unsafe = pm.GetParallelUnsafe();
+        if(!unsafe.empty()) {
+            LOG(ERROR) << "Running with " << cmd_jobs->longID() << " is not supported by physics classes: "
+                       << std_ext::concatenate_string(unsafe, ", ");
+            return EXIT_FAILURE;
+        }
+    }
+
     // check global unused after activating all physics classes
     auto global_unused_popts =  popts->GetUnused();
     if(!global_unused_popts.empty()) {
@@ -407,7 +595,7 @@ int main(int argc, char** argv) {
     if(terminated)
         return EXIT_FAILURE+1;
 
-    if(!cmd_batchmode->isSet()) {
+    if(!batchmode) {
         if(!std_ext::system::isInteractive()) {
             LOG(INFO) << "No TTY attached. Not starting ROOT shell.";
         }
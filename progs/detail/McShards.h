@@ -0,0 +1,140 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <csignal>
+#include <ctime>
+#include <cstdint>
+
+#include "base/Logger.h"
+#include "base/ProcessPool.h"
+#include "base/ProgressCounter.h"
+#include "base/std_ext/string.h"
+
+#include "TRandom3.h"
+#include "TFileMerger.h"
+
+/**
+ * @brief A McShard is an independent chunk of a MC production
+ *
+ * The chunks are generated in worker processes, since ROOT and Pluto are not thread-safe.
+ * The seeds of the chunks are derived from one master seed, so the
+ * merged output is reproducible given the seed and the number of shards.
+ */
+struct McShard {
+    unsigned      Index;
+    unsigned long nEvents;
+    unsigned long FirstEvent; // number of events in previous shards, used for disjoint TIDs
+    unsigned      Seed;
+    std::string   Outfile;
+
+    /**
+     * @brief Make splits nEvents into nShards
+     * @param outfile the final output, used directly if only one shard is requested
+     * @param nEvents total number of events
+     * @param nShards number of chunks
+     * @param seed master seed, 0 means a random master seed is chosen (and logged)
+     * @return the shards, ordered by index
+     */
+    static std::vector<McShard> Make(const std::string& outfile, unsigned long nEvents, unsigned nShards, unsigned seed) {
+        if(seed == 0) {
+            TRandom3 rng(0);
+            seed = 1 + rng.Integer(kMaxUInt-1);
+            LOG(INFO) << "Using random seed " << seed << ", provide it to reproduce this production";
+        }
+
+        // seeds for the shards are drawn from master seed
+        TRandom3 master(seed);
+
+        std::string stem(outfile);
+        if(ant::std_ext::string_ends_with(stem, ".root"))
+            stem = stem.substr(0, stem.size()-5);
+
+        std::vector<McShard> shards;
+        unsigned long firstEvent = 0;
+        for(unsigned i=0;i<nShards;i++) {
+            McShard shard;
+            shard.Index = i;
+            shard.nEvents = nEvents/nShards + (i < nEvents % nShards ? 1 : 0);
+            shard.FirstEvent = firstEvent;
+            shard.Seed = 1 + master.Integer(kMaxUInt-1);
+            shard.Outfile = nShards == 1 ? outfile : stem + "_shard" + std::to_string(i) + ".root";
+            firstEvent += shard.nEvents;
+            shards.emplace_back(std::move(shard));
+        }
+        return shards;
+    }
+
+    /**
+     * @brief Run calls generate for each shard in a worker process of a ProcessPool
+     * @param shards the shards to generate
+     * @param generate returns true on success, may call ProcessPool::ReportProgress
+     * @return true if all shards succeeded
+     *
+     * All shards run at once. A failed shard is generated again from its seed,
+     * which gives the same output. SIGINT stops the workers.
+     */
+    static bool Run(const std::vector<McShard>& shards, std::function<bool(const McShard&)> generate) {
+        if(shards.size() == 1)
+            return generate(shards.front());
+
+        std::signal(SIGINT, [] (int) { Interrupt() = true; });
+
+        ant::ProcessPool pool(shards.size(), std::addressof(Interrupt()));
+        for(const auto& shard : shards) {
+            pool.Add(ant::std_ext::formatter() << "for shard " << shard.Index,
+                     [&shard, &generate] () {
+                // the generators do not check for interrupts themselves
+                std::signal(SIGINT, SIG_DFL);
+                return generate(shard);
+            });
+        }
+
+        if(ant::ProgressCounter::Interval <= 0)
+            ant::ProgressCounter::Interval = 5;
+        return pool.Wait();
+    }
+
+    static volatile bool& Interrupt() {
+        static volatile bool interrupt = false;
+        return interrupt;
+    }
+
+    /**
+     * @brief Merge concatenates the shards in order into outfile and removes them
+     * @param shards generated shards
+     * @param outfile final output file
+     * @return true on success
+     */
+    static bool Merge(const std::vector<McShard>& shards, const std::string& outfile) {
+        if(shards.size() == 1)
+            return true;
+
+        TFileMerger merger(kFALSE, kFALSE);
+        merger.SetMsgPrefix("McShard");
+        if(!merger.OutputFile(outfile.c_str(), kTRUE)) {
+            LOG(ERROR) << "Cannot open output file " << outfile;
+            return false;
+        }
+        for(const auto& shard : shards) {
+            if(!merger.AddFile(shard.Outfile.c_str())) {
+                LOG(ERROR) << "Cannot add shard " << shard.Outfile;
+                return false;
+            }
+        }
+        if(!merger.Merge()) {
+            LOG(ERROR) << "Merging shards into " << outfile << " failed";
+            return false;
+        }
+        for(const auto& shard : shards)
+            std::remove(shard.Outfile.c_str());
+        return true;
+    }
+
+    /// the timestamp for TIDs, taken once before the shards are generated so they all share it
+    static std::uint32_t GetTimestamp() {
+        return std::time(nullptr);
+    }
+};
@@ -1,12 +1,16 @@
 #include "AntReader.h"
+#include "SkimTree.h"
+#include "ReadHitsCache.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
 
 #include "base/Logger.h"
 #include "base/WrapTTree.h"
+#include "base/std_ext/system.h"
 
 #include "TTree.h"
+#include "TFile.h"
 
 #include <memory>
 #include <stdexcept>
@@ -29,7 +33,8 @@ struct AntReaderInternal {
 
 struct UnpackerReader : AntReaderInternal {
     UnpackerReader(unique_ptr<Unpacker::Module> unpacker_) :
-        unpacker(move(unpacker_))
+        unpacker(move(unpacker_)),
+        filename(make_shared<const string>(std_ext::system::absolutePath(unpacker->GetFilename())))
     {
         LOG(INFO) << "Reading events from unpacker";
     }
@@ -37,10 +42,17 @@ struct UnpackerReader : AntReaderInternal {
         return unpacker->PercentDone();
     }
     virtual event_t NextEvent() override {
-        return event_t{unpacker->NextEvent()};
+        event_t event{unpacker->NextEvent()};
+        // the unpacker can seek by TID lower
+        if(event && event.HasReconstructed()) {
+            event.Source.File = filename;
+            event.Source.Entry = event.Reconstructed().ID.Lower;
+        }
+        return event;
     }
 private:
     unique_ptr<Unpacker::Module> unpacker;
+    const shared_ptr<const string> filename;
 }; // UnpackerReader
 
 
@@ -52,6 +64,9 @@ struct TreeReader : AntReaderInternal {
 
         VLOG(5) << "Found Ant Events Tree";
         tree.LinkBranches();
+
+        if(auto file = tree.Tree->GetCurrentFile())
+            filename = make_shared<const string>(std_ext::system::absolutePath(file->GetName()));
     }
 
     virtual ~TreeReader() = default;
@@ -70,8 +85,11 @@ struct TreeReader : AntReaderInternal {
             return {};
 
         tree.Tree->GetEntry(current_entry);
+        event_t event{move(tree.data())};
+        event.Source.File = filename;
+        event.Source.Entry = current_entry;
         current_entry++;
-        return event_t{move(tree.data())};
+        return event;
     }
 
 private:
@@ -80,8 +98,186 @@ private:
         ADD_BRANCH_T(TEvent, data)
     };
     EventTree_t tree;
+    shared_ptr<const string> filename;
 }; // TreeReader
 
+
+struct ReadHitsCacheReader : AntReaderInternal {
+    ReadHitsCacheReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    {
+        if(!rootfiles->GetObject(ReadHitsCache_t::TreeName, cache.Tree))
+            return;
+
+        cache.LinkBranches();
+        LOG(INFO) << "Reading " << cache.Tree->GetEntries() << " events from read hits cache";
+
+        if(auto file = cache.Tree->GetCurrentFile())
+            filename = make_shared<const string>(std_ext::system::absolutePath(file->GetName()));
+    }
+
+    virtual ~ReadHitsCacheReader() = default;
+
+    virtual double PercentDone() const override {
+        if(cache)
+            return double(current_entry)/double(cache.Tree->GetEntries());
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    virtual event_t NextEvent() override {
+        if(!cache || current_entry >= cache.Tree->GetEntries())
+            return {};
+
+        cache.Tree->GetEntry(current_entry);
+        event_t event{cache.Get()};
+        event.Source.File = filename;
+        event.Source.Entry = current_entry;
+        current_entry++;
+        return event;
+    }
+
+private:
+    Long64_t current_entry = 0;
+    ReadHitsCache_t cache;
+    shared_ptr<const string> filename;
+}; // ReadHitsCacheReader
+
+
+struct SkimReader : AntReaderInternal {
+    SkimReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    {
+        if(!rootfiles->GetObject(SkimTree_t::TreeName, skim.Tree))
+            return;
+
+        skim.LinkBranches();
+        LOG(INFO) << "Reading " << skim.Tree->GetEntries() << " referenced events from skim";
+    }
+
+    virtual ~SkimReader() = default;
+
+    virtual double PercentDone() const override {
+        if(skim)
+            return double(current_entry)/double(skim.Tree->GetEntries());
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    virtual event_t NextEvent() override {
+        if(!skim)
+            return {};
+
+        while(current_entry<skim.Tree->GetEntries()) {
+            skim.Tree->GetEntry(current_entry);
+            current_entry++;
+
+            if(!filename || *filename != skim.File()) {
+                filename = make_shared<const string>(skim.File());
+                source = open(*filename);
+            }
+
+            event_t event = source->Get(skim.Entry());
+            if(!event) {
+                LOG(WARNING) << "Cannot read referenced entry " << skim.Entry() << " from " << *filename;
+                continue;
+            }
+
+            if(event.HasReconstructed() && event.Reconstructed().ID != skim.ID())
+                LOG_N_TIMES(10, WARNING) << "Referenced entry " << skim.Entry() << " from " << *filename
+                                         << " has " << event.Reconstructed().ID << ", but expected " << skim.ID();
+
+            event.Source.File = filename;
+            event.Source.Entry = skim.Entry();
+            return event;
+        }
+        return {};
+    }
+
+private:
+    Long64_t current_entry = 0;
+    SkimTree_t skim;
+
+    // the referenced files are either raw files or ROOT files with treeEvents
+    struct source_t {
+        virtual event_t Get(Long64_t entry) = 0;
+        virtual ~source_t() = default;
+    };
+
+    struct UnpackerSource : source_t {
+        explicit UnpackerSource(unique_ptr<Unpacker::Module> unpacker_) :
+            unpacker(move(unpacker_)) {}
+
+        virtual event_t Get(Long64_t entry) override {
+            // without seeking, the requested event is searched by reading forward
+            if(entry != next && !unpacker->SeekEvent(entry))
+                VLOG(5) << "Cannot seek to event " << entry << ", reading forward";
+
+            while(true) {
+                event_t event{unpacker->NextEvent()};
+                if(!event || !event.HasReconstructed())
+                    return {};
+                const Long64_t lower = event.Reconstructed().ID.Lower;
+                next = lower+1;
+                if(lower == entry)
+                    return event;
+                if(lower > entry)
+                    return {};
+            }
+        }
+
+        unique_ptr<Unpacker::Module> unpacker;
+        Long64_t next = 0;
+    };
+
+    struct TreeSource : source_t {
+        explicit TreeSource(const string& filename) :
+            file(filename)
+        {
+            if(file.GetObject("treeEvents", tree.Tree))
+                tree.LinkBranches();
+            else if(file.GetObject(ReadHitsCache_t::TreeName, cache.Tree))
+                cache.LinkBranches();
+        }
+
+        explicit operator bool() const {
+            return tree || cache;
+        }
+
+        virtual event_t Get(Long64_t entry) override {
+            if(tree && entry < tree.Tree->GetEntries()) {
+                tree.Tree->GetEntry(entry);
+                return event_t{move(tree.data())};
+            }
+            if(cache && entry < cache.Tree->GetEntries()) {
+                cache.Tree->GetEntry(entry);
+                return event_t{cache.Get()};
+            }
+            return {};
+        }
+
+        WrapTFileInput file;
+        struct EventTree_t : WrapTTree {
+            ADD_BRANCH_T(TEvent, data)
+        };
+        EventTree_t tree;
+        ReadHitsCache_t cache;
+    };
+
+    static unique_ptr<source_t> open(const string& filename) {
+        VLOG(3) << "Opening referenced file " << filename;
+        try {
+            return std_ext::make_unique<UnpackerSource>(Unpacker::Get(filename));
+        }
+        catch(Unpacker::Exception) {
+            // not a raw file, try ROOT file below
+        }
+        auto treesource = std_ext::make_unique<TreeSource>(filename);
+        if(!*treesource)
+            throw DataReader::Exception("Referenced file "+filename+" is neither raw file nor contains treeEvents or read hits cache");
+        return move(treesource);
+    }
+
+    shared_ptr<const string> filename;
+    unique_ptr<source_t> source;
+}; // SkimReader
+
 }}}} // namespace ant::analysis::input::detail
 
 
@@ -98,10 +294,22 @@ AntReader::AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
             LOG(WARNING) << "Reconstruct disabled although reading from unpacker. Producing DetectorReadHits only.";
     }
     else {
-        // try root files
-        auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles);
-        if(isfinite(treereader->PercentDone()))
-            reader = move(treereader);
+        // try root files, prefer references from skims
+        auto skimreader = std_ext::make_unique<detail::SkimReader>(rootfiles);
+        if(isfinite(skimreader->PercentDone())) {
+            reader = move(skimreader);
+        }
+        else {
+            auto cachereader = std_ext::make_unique<detail::ReadHitsCacheReader>(rootfiles);
+            if(isfinite(cachereader->PercentDone())) {
+                reader = move(cachereader);
+            }
+            else {
+                auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles);
+                if(isfinite(treereader->PercentDone()))
+                    reader = move(treereader);
+            }
+        }
     }
 
 }
@@ -0,0 +1,104 @@
+#include "ReadHitsCache.h"
+
+#include "tree/TEventData.h"
+
+#include "base/std_ext/string.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+constexpr unsigned maxChannel = 1 << 16;
+
+unsigned ReadHitsCache_t::PackElement(const LogicalChannel_t& element)
+{
+    if(element.Channel >= maxChannel)
+        throw Exception(std_ext::formatter() << "Channel " << element.Channel << " too large to be cached");
+    return (unsigned(element.DetectorType) << 24)
+            | (unsigned(element.ChannelType) << 16)
+            | element.Channel;
+}
+
+LogicalChannel_t ReadHitsCache_t::UnpackElement(unsigned packed)
+{
+    LogicalChannel_t element;
+    element.DetectorType = static_cast<Detector_t::Type_t>(packed >> 24);
+    element.ChannelType = static_cast<Channel_t::Type_t>((packed >> 16) & 0xff);
+    element.Channel = packed & (maxChannel-1);
+    return element;
+}
+
+void ReadHitsCache_t::Set(const TEventData& eventdata)
+{
+    ID = eventdata.ID;
+    DAQEventID = eventdata.Trigger.DAQEventID;
+
+    // clear without freeing memory
+    Elements().clear();
+    RawDataEnds().clear();
+    RawData().clear();
+    ValuesEnds().clear();
+    Values().clear();
+
+    for(const TDetectorReadHit& readhit : eventdata.DetectorReadHits) {
+        Elements().push_back(PackElement({readhit.DetectorType, readhit.ChannelType, readhit.Channel}));
+
+        RawData().append(readhit.RawData.begin(), readhit.RawData.end());
+        RawDataEnds().push_back(RawData().size());
+
+        for(const auto& value : readhit.Values)
+            Values().push_back(value.Uncalibrated);
+        ValuesEnds().push_back(Values().size());
+    }
+
+    // the rest is rarely present
+    Extra() = TEvent();
+    const auto& daqerrors = eventdata.Trigger.DAQErrors;
+    if(!eventdata.SlowControls.empty() || !eventdata.UnpackerMessages.empty() || !daqerrors.empty()) {
+        Extra() = TEvent(eventdata.ID);
+        auto& extra = Extra().Reconstructed();
+        extra.SlowControls = eventdata.SlowControls;
+        extra.UnpackerMessages = eventdata.UnpackerMessages;
+        extra.Trigger.DAQErrors = daqerrors;
+    }
+}
+
+TEvent ReadHitsCache_t::Get()
+{
+    const auto nHits = Elements().size();
+    if(RawDataEnds().size() != nHits || ValuesEnds().size() != nHits)
+        throw Exception("Inconsistent number of read hits in cache");
+
+    TEvent event(ID());
+    auto& eventdata = event.Reconstructed();
+    eventdata.Trigger.DAQEventID = DAQEventID;
+
+    eventdata.DetectorReadHits.reserve(nHits);
+    unsigned rawdata_begin = 0;
+    unsigned values_begin = 0;
+    for(size_t i=0;i<nHits;i++) {
+        const auto element = UnpackElement(Elements()[i]);
+        eventdata.DetectorReadHits.emplace_back();
+        auto& readhit = eventdata.DetectorReadHits.back();
+        readhit.DetectorType = element.DetectorType;
+        readhit.ChannelType = element.ChannelType;
+        readhit.Channel = element.Channel;
+
+        const auto& rawdata = RawData();
+        readhit.RawData.assign(rawdata.begin()+rawdata_begin, rawdata.begin()+RawDataEnds()[i]);
+        rawdata_begin = RawDataEnds()[i];
+
+        for(auto j=values_begin;j<ValuesEnds()[i];j++)
+            readhit.Values.emplace_back(Values()[j]);
+        values_begin = ValuesEnds()[i];
+    }
+
+    if(Extra()) {
+        auto& extra = Extra().Reconstructed();
+        eventdata.SlowControls = move(extra.SlowControls);
+        eventdata.UnpackerMessages = move(extra.UnpackerMessages);
+        eventdata.Trigger.DAQErrors = move(extra.Trigger.DAQErrors);
+    }
+
+    return event;
+}
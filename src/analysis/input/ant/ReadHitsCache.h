@@ -0,0 +1,61 @@
+#pragma once
+
+#include "base/WrapTTree.h"
+#include "tree/TID.h"
+#include "tree/TEvent.h"
+#include "base/Detector_t.h"
+
+#include <vector>
+#include <string>
+
+namespace ant {
+
+struct TEventData;
+
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The ReadHitsCache_t struct stores unpacked events before reconstruction
+ *
+ * The DetectorReadHits are packed into a few columns, which are much faster to read
+ * than unpacking the raw files again, for example for iterative calibrations.
+ * The rarely present slowcontrols, unpacker messages and DAQ errors are kept in a TEvent.
+ * Written by Ant-cacheReadHits, read by AntReader.
+ */
+struct ReadHitsCache_t : WrapTTree {
+    ADD_BRANCH_T(TID,                   ID)
+    ADD_BRANCH_T(unsigned,              DAQEventID)
+    // detector type, channel type and channel of each hit, see PackElement
+    ADD_BRANCH_T(std::vector<unsigned>, Elements)
+    // hits are stored consecutively, the ends are the offsets after each hit
+    ADD_BRANCH_T(std::vector<unsigned>, RawDataEnds)
+    ADD_BRANCH_T(std::string,           RawData)
+    ADD_BRANCH_T(std::vector<unsigned>, ValuesEnds)
+    ADD_BRANCH_T(std::vector<double>,   Values)
+    // only has reconstructed branch if there's anything to store
+    ADD_BRANCH_T(TEvent,                Extra)
+
+    static constexpr auto TreeName = "treeReadHits";
+
+    /**
+     * @brief Set sets the branches from unpacked, but not yet reconstructed event data
+     * @param eventdata the unpacked event data, must not have any values calibrated
+     */
+    void Set(const TEventData& eventdata);
+
+    /**
+     * @brief Get creates the event from the current entry
+     * @return event with reconstructed branch ready for Reconstruct
+     */
+    TEvent Get();
+
+    static unsigned PackElement(const LogicalChannel_t& element);
+    static LogicalChannel_t UnpackElement(unsigned packed);
+
+    struct Exception : WrapTTree::Exception {
+        using WrapTTree::Exception::Exception;
+    };
+};
+
+}}} // namespace ant::analysis::input
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "base/WrapTTree.h"
+#include "tree/TID.h"
+
+#include <string>
+
+namespace ant {
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The SkimTree_t struct references events in other files
+ *
+ * Written by PhysicsManager instead of full TEvents when skimming references,
+ * read by AntReader to jump to the referenced events. For raw files,
+ * Entry is the event number as used by Unpacker::Module::SeekEvent,
+ * for ROOT files it is the entry in treeEvents.
+ */
+struct SkimTree_t : WrapTTree {
+    ADD_BRANCH_T(std::string, File)
+    ADD_BRANCH_T(Long64_t,    Entry)
+    ADD_BRANCH_T(TID,         ID)
+
+    static constexpr auto TreeName = "treeSkim";
+};
+
+}}} // namespace ant::analysis::input
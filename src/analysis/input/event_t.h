@@ -2,6 +2,9 @@
 
 #include "tree/TEvent.h"
 
+#include <memory>
+#include <string>
+
 namespace ant {
 namespace analysis {
 namespace input {
@@ -17,6 +20,14 @@ struct event_t : TEvent {
     bool empty_reconstructed = false;
     bool empty_mctrue = false;
 
+    // where the event was read from, if known
+    // used for skimming references, see SkimTree_t
+    struct source_t {
+        std::shared_ptr<const std::string> File;
+        long long Entry = -1;
+    };
+    source_t Source;
+
     bool HasReconstructed() const { return reconstructed!=nullptr; }
     bool HasMCTrue() const { return mctrue!=nullptr; }
 
@@ -43,6 +43,14 @@ public:
     virtual void ShowResult() {}
     std::string GetName() const { return name_; }
 
+    /**
+     * @brief IsParallelSafe tells if the outputs of several instances, each run on a share of the input, can be merged
+     *
+     * Merging sums the histograms and concatenates the trees, which only equals a single run over all input
+     * if Finish() does not derive results from them. Ant refuses to run classes with --jobs that do not opt in.
+     */
+    virtual bool IsParallelSafe() const { return false; }
+
     Physics(const Physics&) = delete;
     Physics& operator=(const Physics&) = delete;
 };
@@ -2,6 +2,7 @@
 
 #include "utils/ParticleID.h"
 #include "input/DataReader.h"
+#include "input/ant/SkimTree.h"
 
 #include "tree/TSlowControl.h"
 #include "tree/TAntHeader.h"
@@ -10,10 +11,14 @@
 #include "slowcontrol/SlowControlManager.h"
 
 #include "base/ProgressCounter.h"
+#include "base/ProcessPool.h"
 
 #include "TTree.h"
+#include "TDirectory.h"
+#include "TH1D.h"
 
 #include <iomanip>
+#include <algorithm>
 
 
 using namespace std;
@@ -27,12 +32,29 @@ PhysicsManager::PhysicsManager(volatile bool* interrupt_) :
 
 PhysicsManager::~PhysicsManager() {}
 
+void PhysicsManager::AddBuffer(std::unique_ptr<HistogramFactory::DirectoryBuffer> buffer, TDirectory* target)
+{
+    if(!buffer || !target)
+        throw Exception("Cannot add buffer without target directory");
+    buffers.emplace_back(buffer_t{move(buffer), target});
+}
+
 void PhysicsManager::SetAntHeader(TAntHeader& header)
 {
     header.FirstID = firstID;
     header.LastID = lastID;
 }
 
+vector<string> PhysicsManager::GetParallelUnsafe() const
+{
+    vector<string> names;
+    for(auto& p : physics) {
+        if(!p->IsParallelSafe())
+            names.emplace_back(p->GetName());
+    }
+    return names;
+}
+
 void PhysicsManager::ShowResults()
 {
     for(auto& p : physics) {
@@ -75,11 +97,27 @@ void PhysicsManager::ReadFrom(
     slowcontrol_mgr = std_ext::make_unique<SlowControlManager>();
 
 
+    // one timer for each physics class
+    timersPhysics.clear();
+    for(auto& p : physics)
+        timersPhysics.emplace_back(std_ext::make_unique<StageTimer>("Physics/"+p->GetName()));
+
+    // timers are written next to treeEvents
+    TDirectory* outputDir = gDirectory;
+
     // prepare output of TEvents
     treeEvents = new TTree("treeEvents","TEvent data");
     treeEventPtr = nullptr;
     treeEvents->Branch("data", addressof(treeEventPtr));
 
+    // prepare output of references instead
+    treeSkim = nullptr;
+    nSkimReferences = 0;
+    if(skimReferences) {
+        treeSkim = std_ext::make_unique<input::SkimTree_t>();
+        treeSkim->CreateBranches(new TTree(input::SkimTree_t::TreeName, "References to saved events"));
+    }
+
     long long nEventsRead = 0;
     long long nEventsProcessed = 0;
     long long nEventsAnalyzed = 0;
@@ -98,6 +136,10 @@ void PhysicsManager::ReadFrom(
                                    source->PercentDone() :
                                    (double)nEventsAnalyzed/maxevents;
 
+        // as worker of Ant --jobs, the parent shows the progress
+        if(ProcessPool::ReportProgress(percent))
+            return;
+
         static double last_PercentDone = 0;
         const double speed = (percent - last_PercentDone)/elapsed.count();
         LOG(INFO) << setw(2) << std::setprecision(4)
@@ -116,7 +158,12 @@ void PhysicsManager::ReadFrom(
             }
 
             input::event_t event;
-            if(!TryReadEvent(event)) {
+            bool event_read = false;
+            {
+                StageTimer::scope_t t(timerReader);
+                event_read = TryReadEvent(event);
+            }
+            if(!event_read) {
                 VLOG(5) << "No more events to read, finish.";
                 reached_maxevents = true;
                 break;
@@ -124,7 +171,12 @@ void PhysicsManager::ReadFrom(
             nEventsRead++;
 
             // dump it into slowcontrol until full...
-            if(slowcontrol_mgr->ProcessEvent(move(event)))
+            bool complete = false;
+            {
+                StageTimer::scope_t t(timerSlowControl);
+                complete = slowcontrol_mgr->ProcessEvent(move(event));
+            }
+            if(complete)
                 break;
             // ..or max buffersize reached: 20000 corresponds to two Acqu Scaler blocks
             if(slowcontrol_mgr->BufferSize()>20000) {
@@ -134,61 +186,92 @@ void PhysicsManager::ReadFrom(
             }
         }
 
-        // read the slowcontrol_mgr's buffer and process the events
-        while(auto buf_event = slowcontrol_mgr->PopEvent()) {
-
-            auto& event = buf_event.Event;
+        // read the slowcontrol_mgr's epochs and process their events in order
+        while(true) {
 
-            if(interrupt) {
-                VLOG(3) << "Processing interrupted";
-                break;
+            slowcontrol::epoch_t epoch;
+            {
+                StageTimer::scope_t t(timerSlowControl);
+                epoch = slowcontrol_mgr->PopEpoch();
             }
+            if(!epoch)
+                break;
 
-            logger::DebugInfo::nProcessedEvents = nEventsProcessed;
+            // the physics classes see the slowcontrol values of this epoch,
+            // which is self-contained, but the physics classes are not thread-safe,
+            // so the epochs are processed one after another here
+            slowcontrol::epoch_t::Scope scope(epoch);
 
-            physics::manager_t manager;
+            for(auto it_event = epoch.Events.begin(); it_event != epoch.Events.end(); ++it_event) {
 
-            // if we've already reached the maxevents,
-            // we just postprocess the remaining slowcontrol buffer (if any)
-            if(!reached_maxevents) {
-                if(nEventsAnalyzed == maxevents) {
-                    VLOG(3) << "Reached max Events " << maxevents;
-                    reached_maxevents = true;
-                    // we cannot simply break here since might
-                    // need to save stuff for slowcontrol purposes
-                    if(slowcontrol_mgr->BufferSize()==0)
-                        break;
+                auto& buf_event = *it_event;
+                auto& event = buf_event.Event;
+
+                if(interrupt) {
+                    VLOG(3) << "Processing interrupted";
+                    break;
                 }
 
-                if(!reached_maxevents && !buf_event.WantsSkip) {
+                logger::DebugInfo::nProcessedEvents = nEventsProcessed;
+
+                physics::manager_t manager;
 
-                    ProcessEvent(event, manager);
+                // if we've already reached the maxevents,
+                // we just postprocess the remaining slowcontrol buffer (if any)
+                if(!reached_maxevents) {
+                    if(nEventsAnalyzed == maxevents) {
+                        VLOG(3) << "Reached max Events " << maxevents;
+                        reached_maxevents = true;
+                        // we cannot simply break here since might
+                        // need to save stuff for slowcontrol purposes
+                        if(slowcontrol_mgr->BufferSize()==0 && next(it_event) == epoch.Events.end())
+                            break;
+                    }
 
-                    // prefer Reconstructed ID, but at least one branch should be non-null
-                    const auto& eventid = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
-                    if(nEventsAnalyzed==0)
-                        firstID = eventid;
-                    lastID = eventid;
+                    if(!reached_maxevents && !buf_event.WantsSkip) {
 
-                    nEventsAnalyzed++;
+                        ProcessEvent(event, manager);
 
-                    if(manager.saveEvent)
-                        nEventsSaved++;
+                        // prefer Reconstructed ID, but at least one branch should be non-null
+                        const auto& eventid = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+                        if(nEventsAnalyzed==0)
+                            firstID = eventid;
+                        lastID = eventid;
+
+                        nEventsAnalyzed++;
+
+                        if(manager.saveEvent)
+                            nEventsSaved++;
+                    }
                 }
-            }
 
-            // SaveEvent is the sink for events
-            SaveEvent(move(event), manager);
+                // changes are only reported to the first non-skipped event
+                if(!buf_event.WantsSkip)
+                    epoch.ClearChanged();
+
+                // SaveEvent is the sink for events
+                SaveEvent(move(event), manager);
+
+                nEventsProcessed++;
+            }
 
-            nEventsProcessed++;
+            if(interrupt)
+                break;
         }
         ProgressCounter::Tick();
     }
 
+    // Finish may need the histograms filled into the buffers
+    for(auto& b : buffers) {
+        b.Buffer->MergeInto(b.Target);
+    }
+
     for(auto& pclass : physics) {
         pclass->Finish();
     }
 
+    WriteTimers(outputDir);
+
     VLOG(5) << "First EventId processed: " << firstID;
     VLOG(5) << "Last  EventId processed: " << lastID;
 
@@ -203,6 +286,22 @@ void PhysicsManager::ReadFrom(
               << processed_str << ", speed "
               << nEventsProcessed/progress.GetTotalSecs() << " event/s";
 
+    if(treeSkim) {
+        const auto nReferencesTotal = treeSkim->Tree->GetEntries();
+        if(nSkimReferences==0) {
+            delete treeSkim->Tree;
+        }
+        else if(treeSkim->Tree->GetCurrentFile() != nullptr) {
+            treeSkim->Tree->Write();
+            const auto n_sc = nReferencesTotal - nSkimReferences;
+            LOG(INFO) << "Wrote " << nSkimReferences << " references to " << input::SkimTree_t::TreeName
+                      << (n_sc>0 ? string(std_ext::formatter() << " (+slowcontrol: " << n_sc << ")") : "");
+        }
+        treeSkim = nullptr;
+        // saved events without references went to treeEvents as usual
+        nEventsSaved -= nSkimReferences;
+    }
+
     const auto nEventsSavedTotal = treeEvents->GetEntries();
     if(nEventsSaved==0) {
         if(nEventsSavedTotal>0)
@@ -256,9 +355,14 @@ void PhysicsManager::ProcessEvent(input::event_t& event, physics::manager_t& man
 
     event.EnsureTempBranches();
 
+    StageTimer::scope_t t(timerPhysics);
+
     // run the physics classes
+    auto it_timer = timersPhysics.begin();
     for( auto& m : physics ) {
+        StageTimer::scope_t t_m(**it_timer);
         m->ProcessEvent(event, manager);
+        ++it_timer;
     }
 
     event.ClearTempBranches();
@@ -272,11 +376,65 @@ void PhysicsManager::SaveEvent(input::event_t event, const physics::manager_t& m
             LOG_N_TIMES(1, WARNING) << "Writing treeEvents to memory. Might be a lot of data!";
 
 
+        // references can only be saved if the event knows where it came from
+        if(treeSkim) {
+            if(event.Source.File) {
+                treeSkim->File = *event.Source.File;
+                treeSkim->Entry = event.Source.Entry;
+                treeSkim->ID = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+                treeSkim->Tree->Fill();
+                if(manager.saveEvent)
+                    nSkimReferences++;
+                return;
+            }
+            LOG_N_TIMES(1, WARNING) << "Event without source cannot be referenced, saving it to treeEvents";
+        }
+
         // always keep read hits if saving for slowcontrol
         if(!manager.keepReadHits && !event.SavedForSlowControls)
             event.ClearDetectorReadHits();
 
         treeEventPtr = addressof(event);
+        StageTimer::scope_t t(timerTreeEvents);
         treeEvents->Fill();
     }
 }
+
+void PhysicsManager::WriteTimers(TDirectory* dir) const
+{
+    list<const StageTimer*> timers;
+    for(auto timer : StageTimer::GetAll())
+        if(timer->Calls>0)
+            timers.push_back(timer);
+    if(timers.empty())
+        return;
+
+    HistogramFactory HistFac("PhysicsManager_Timing", dir);
+
+    auto h_total = HistFac.makeTH1D("Cumulative time per stage", "", "t / s",
+                                    BinSettings(timers.size()), "h_TotalTime");
+    vector<double> edges(StageTimer::nBins+1);
+    for(unsigned i=0;i<edges.size();i++)
+        edges[i] = StageTimer::GetBinEdge(i);
+
+    int bin = 1;
+    for(auto timer : timers) {
+        h_total->GetXaxis()->SetBinLabel(bin, timer->Name.c_str());
+        h_total->SetBinContent(bin, timer->Total.count());
+        ++bin;
+
+        // ROOT does not like slashes in names
+        string name = timer->Name;
+        std::replace(name.begin(), name.end(), '/', '_');
+        auto h_latency = HistFac.make<TH1D>(("h_Latency_"+name).c_str(),
+                                            (timer->Name+" latency per call").c_str(),
+                                            StageTimer::nBins, edges.data());
+        h_latency->SetXTitle("t / s");
+        for(unsigned i=0;i<StageTimer::nBins;i++)
+            h_latency->SetBinContent(i+1, timer->Histogram[i]);
+        h_latency->SetEntries(timer->Calls);
+
+        VLOG(3) << "Timing " << timer->Name << ": " << timer->Total.count() << " s in "
+                << timer->Calls << " calls, " << 1e6*timer->Total.count()/timer->Calls << " us/call";
+    }
+}
@@ -2,10 +2,14 @@
 
 #include "Physics.h"
 
+#include "base/StageTimer.h"
+
 #include <memory>
 #include <queue>
+#include <vector>
 
 class TTree;
+class TDirectory;
 
 namespace ant {
 
@@ -25,6 +29,7 @@ class ParticleID;
 
 namespace input {
 struct event_t;
+struct SkimTree_t;
 class DataReader;
 }
 
@@ -67,6 +72,28 @@ protected:
     TTree*  treeEvents;
     TEvent* treeEventPtr;
 
+    // for output of references to saved events
+    bool skimReferences = false;
+    std::unique_ptr<input::SkimTree_t> treeSkim;
+    long long nSkimReferences = 0;
+
+    // timing of the processing stages, the readers may add more stages
+    StageTimer timerReader{"Reader"};
+    StageTimer timerSlowControl{"SlowControl"};
+    StageTimer timerPhysics{"Physics"};
+    StageTimer timerTreeEvents{"TreeEvents"};
+    std::list<std::unique_ptr<StageTimer>> timersPhysics;
+
+    // merged into their target directory before the physics classes are finished
+    struct buffer_t {
+        std::unique_ptr<HistogramFactory::DirectoryBuffer> Buffer;
+        TDirectory* Target;
+    };
+    std::list<buffer_t> buffers;
+
+    // writes the registered StageTimers as histograms
+    void WriteTimers(TDirectory* dir) const;
+
 public:
 
     PhysicsManager(volatile bool* interrupt_ = nullptr);
@@ -88,8 +115,28 @@ public:
         physics.emplace_back(std::move(pc));
     }
 
+    /**
+     * @brief AddBuffer lets the histograms filled into buffer be merged before Physics::Finish is called
+     * @param buffer the buffer, see HistogramFactory::DirectoryBuffer
+     * @param target the directory which was gDirectory when the registered histograms were created
+     * @note whoever fills the buffered histograms must be done when ReadFrom finishes
+     */
+    void AddBuffer(std::unique_ptr<HistogramFactory::DirectoryBuffer> buffer, TDirectory* target);
+
     void SetAntHeader(TAntHeader& header);
 
+    /// names of the added physics classes which cannot run on shares of the input, see Physics::IsParallelSafe
+    std::vector<std::string> GetParallelUnsafe() const;
+
+    /**
+     * @brief SetSkimReferences saves only the (file, entry, TID) references of saved events
+     * @param flag if true, events are written to treeSkim instead of treeEvents
+     *
+     * The AntReader reads the referenced events from the original files,
+     * which need to be available when processing the skim.
+     */
+    void SetSkimReferences(bool flag) { skimReferences = flag; }
+
     void ReadFrom(std::list<std::unique_ptr<input::DataReader> > readers_,
                   long long maxevents
                   );
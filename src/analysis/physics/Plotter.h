@@ -29,6 +29,16 @@ public:
     virtual void Finish();
     virtual void ShowResult();
 
+    /**
+     * @brief IsParallelSafe opts in to Ant-plot's --jobs mode
+     * @return true if ProcessEntry can run on disjoint entry ranges in separate worker processes
+     *
+     * Only return true if the plotter's output consists of histograms (and hstacks) which are
+     * filled in ProcessEntry without any state carried from one entry to the next,
+     * as the per-worker histograms are simply added before Finish() is called.
+     */
+    virtual bool IsParallelSafe() const { return false; }
+
     virtual ~Plotter();
 
     struct Exception : std::runtime_error {
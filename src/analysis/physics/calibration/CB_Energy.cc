@@ -5,6 +5,8 @@
 #include "expconfig/ExpConfig.h"
 #include "expconfig/detectors/CB.h"
 
+#include "base/Logger.h"
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::physics;
@@ -30,6 +32,14 @@ CB_Energy::CB_Energy(const string& name, OptionsPtr opts) :
     ggIM = HistFac.makeTH2D("2 neutral IM (CB,CB)", "IM [MeV]", "#",
                             energybins, cb_channels, "ggIM");
     h_cbdisplay = HistFac.make<TH2CB>("h_cbdisplay","Number of entries");
+
+    if(opts->Get<bool>("Iterate", false)) {
+        gainIterator = std_ext::make_unique<calibration::detail::GainIterator>(detector->GetNChannels());
+        ggIM_Iterated = HistFac.makeTH2D("2 neutral IM (CB,CB) with iterated gains", "IM [MeV]", "#",
+                                         energybins, cb_channels, "ggIM_Iterated");
+        h_GainFactors = HistFac.makeTH1D("Factors for RelativeGains", "Channel", "Factor",
+                                         cb_channels, "h_GainFactors");
+    }
 }
 
 void CB_Energy::ProcessEvent(const TEvent& event, manager_t&)
@@ -57,11 +67,36 @@ void CB_Energy::ProcessEvent(const TEvent& event, manager_t&)
             if(cl1 && cl2) {
                 FillggIM(*cl1, *cl2, ggmass);
                 FillggIM(*cl2, *cl1, ggmass);
+                if(gainIterator) {
+                    auto isClean = [this] (const TCluster& other) {
+                        return !RequireClean || !other.HasFlag(TCluster::Flags_t::TouchesHoleCentral);
+                    };
+                    gainIterator->AddPair(*cl1, *cl2, ggmass, isClean(*cl2), isClean(*cl1));
+                }
             }
         }
     }
 }
 
+void CB_Energy::Finish()
+{
+    if(!gainIterator || gainIterator->GetNPairs()==0)
+        return;
+
+    LOG(INFO) << "Iterating gains with " << gainIterator->GetNPairs() << " photon pairs";
+    calibration::detail::GainIterator::settings_t settings;
+    settings.IMBins = BinSettings(ggIM->GetNbinsX(), ggIM->GetXaxis()->GetXmin(), ggIM->GetXaxis()->GetXmax());
+    gainIterator->Iterate(settings);
+
+    gainIterator->Fill(*ggIM_Iterated);
+    const auto& factors = gainIterator->GetFactors();
+    for(size_t ch=0;ch<factors.size();ch++)
+        h_GainFactors->SetBinContent(ch+1, factors[ch]);
+    // factors iterated on parts of the data cannot be combined,
+    // the underflow bin counts the merged outputs so Ant-calib can refuse them
+    h_GainFactors->SetBinContent(0, 1);
+}
+
 void CB_Energy::ShowResult()
 {
     auto proj = dynamic_cast<TH1D*>(ggIM->ProjectionX());
@@ -71,6 +106,10 @@ void CB_Energy::ShowResult()
                       << h_cbdisplay
                       << proj
                       << endc;
+    if(gainIterator)
+        canvas(GetName()+": Iterated") << drawoption("colz") << ggIM_Iterated
+                                       << h_GainFactors
+                                       << endc;
 }
 
 AUTO_REGISTER_PHYSICS(CB_Energy)
@@ -3,6 +3,9 @@
 #include "analysis/physics/Physics.h"
 
 #include "root-addons/cbtaps_display/TH2CB.h"
+#include "calibration/modules/detail/GainIterator.h"
+
+#include <memory>
 
 namespace ant {
 namespace analysis {
@@ -20,11 +23,20 @@ protected:
 
     void FillggIM(const TCluster& cl1, const TCluster& cl2, const double imass);
 
+    // keeps the pairs in memory to iterate the gains at the end,
+    // the resulting h_GainFactors are used by the Ant-calib module with option UseIteratedGains
+    std::unique_ptr<calibration::detail::GainIterator> gainIterator;
+    TH2* ggIM_Iterated = nullptr;
+    TH1D* h_GainFactors = nullptr;
+
 public:
 
     CB_Energy(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    // the gains must be iterated on all pairs at once
+    virtual bool IsParallelSafe() const override { return !gainIterator; }
+    virtual void Finish() override;
     virtual void ShowResult() override;
 };
 
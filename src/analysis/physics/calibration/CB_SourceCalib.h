@@ -30,6 +30,7 @@ public:
     CB_SourceCalib(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual bool IsParallelSafe() const override { return true; }
     virtual void ShowResult() override;
 
 };
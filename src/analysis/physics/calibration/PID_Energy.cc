@@ -173,9 +173,9 @@ PID_Energy::PerChannel_t::PerChannel_t(HistogramFactory HistFac)
     QDCMultiplicity = HistFac.makeTH1D("PID QDC Multiplicity", "nHits", "#", BinSettings(10), "QDCMultiplicity");
 }
 
-void PID_Energy::ProcessEvent(const TEvent& event, manager_t&)
+void PID_Energy::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     // pedestals, best determined from clusters with energy information only
 
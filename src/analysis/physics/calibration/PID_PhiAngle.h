@@ -18,6 +18,7 @@ public:
     PID_PhiAngle(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual bool IsParallelSafe() const override { return true; }
     virtual void ShowResult() override;
 };
 
@@ -40,9 +40,9 @@ PID_TAPSVeto_Kinfit::PID_TAPSVeto_Kinfit(const string& name, OptionsPtr opts) :
     }
 }
 
-void PID_TAPSVeto_Kinfit::ProcessEvent(const TEvent& event, manager_t&)
+void PID_TAPSVeto_Kinfit::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     if(!triggersimu.HasTriggered())
         return;
 
@@ -16,6 +16,7 @@ public:
     TAPSVeto_Energy(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual bool IsParallelSafe() const override { return true; }
     virtual void ShowResult() override;
 };
 
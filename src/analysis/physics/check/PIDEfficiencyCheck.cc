@@ -37,9 +37,9 @@ PIDEfficiencyCheck::PIDEfficiencyCheck(const string& name, OptionsPtr opts) :
     h_Steps = HistFac.makeTH1D("Steps","","",BinSettings(10),"h_Steps");
 }
 
-void PIDEfficiencyCheck::ProcessEvent(const TEvent& event, manager_t&)
+void PIDEfficiencyCheck::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     h_Steps->Fill("Seen",1.0);
 
@@ -255,7 +255,7 @@ struct PIDEfficiencyCheck_plot : Plotter {
 
     Hist_t::Tree_t tree;
 
-    cuttree::Tree_t<Hist_t> mycuttree;
+    cuttree::Flat_t<Hist_t> mycuttree;
 
     PIDEfficiencyCheck_plot(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -264,7 +264,7 @@ struct PIDEfficiencyCheck_plot : Plotter {
             throw Exception("Cannot find tree PIDEfficiencyCheck/t");
         tree.LinkBranches();
 
-        mycuttree = cuttree::Make<Hist_t>(HistFac);
+        mycuttree = cuttree::MakeFlat<Hist_t>(HistFac);
     }
 
     virtual long long GetNumEntries() const override
@@ -272,6 +272,11 @@ struct PIDEfficiencyCheck_plot : Plotter {
         return tree.Tree->GetEntries();
     }
 
+    virtual bool IsParallelSafe() const override
+    {
+        return true;
+    }
+
     virtual void ProcessEntry(const long long entry) override
     {
         tree.Tree->GetEntry(entry);
@@ -31,9 +31,9 @@ struct MaxTracker {
     double operator()() const { return v; }
 };
 
-void ThreePhotonCheck::ProcessEvent(const TEvent& event, manager_t&)
+void ThreePhotonCheck::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     h_Steps->Fill("Seen",1.0);
 
@@ -143,9 +143,9 @@ TriggerOverview::TriggerOverview(const string &name, OptionsPtr opts):
 TriggerOverview::~TriggerOverview()
 {}
 
-void TriggerOverview::ProcessEvent(const TEvent& event, manager_t&)
+void TriggerOverview::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& branch =  GetBranch(event);
     const auto& trigger = branch.Trigger;
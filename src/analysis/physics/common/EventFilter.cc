@@ -70,7 +70,7 @@ EventFilter::~EventFilter()
 
 void EventFilter::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data = event.Reconstructed();
 
@@ -31,9 +31,9 @@ physics::ExtractResolutions::ExtractResolutions(const std::string& name, Options
     tree->Branch("rDir",    &b_recDir);
 }
 
-void physics::ExtractResolutions::ProcessEvent(const TEvent& event, manager_t&)
+void physics::ExtractResolutions::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     auto mctrue_particles = utils::ParticleTypeList::Make(event.MCTrue().ParticleTree);
 
     const auto& mcparticles = mctrue_particles.GetAll();
@@ -31,9 +31,9 @@ T inc(T x) {
     return ++x;
 }
 
-void ExtractTimings::ProcessEvent(const TEvent& event, manager_t&)
+void ExtractTimings::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     const auto& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
 
     // EPT-CB and EPT-TAPS
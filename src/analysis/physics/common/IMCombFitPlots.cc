@@ -106,9 +106,9 @@ IMCombFitPlots::IMCombFitPlots(const std::string& name, OptionsPtr opts):
                                    BinSettings(100,0,10), BinSettings(24), "projections_hep");
 }
 
-void IMCombFitPlots::ProcessEvent(const TEvent& event, manager_t&)
+void IMCombFitPlots::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& cands = event.Reconstructed().Candidates;
     if (cands.size() > MaxNGamma()+1 || cands.size() < MinNGamma()+1)
@@ -36,21 +36,23 @@ LorentzVec sumlv(iter start, iter end) {
 }
 
 
-void IMPlots::ProcessEvent(const TEvent& event, manager_t&)
+void IMPlots::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    triggersimu.ProcessEvent(event, manager);
+    const auto& recon_particles = manager.GetParticles(event);
     const auto& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
 
+    combinatorics.Set(photons);
+
     for(unsigned n = MinNGamma(); n<MaxNGamma(); ++n) {
-        for( auto comb = utils::makeCombination(photons,n); !comb.done(); ++comb) {
-            const LorentzVec sum = sumlv(comb.begin(), comb.end());
-                for(const auto& h : event.Reconstructed().TaggerHits) {
-                    prs.SetTaggerTime(triggersimu.GetCorrectedTaggerTime(h));
-                    m.at(n - MinNGamma()).Fill(sum.M());
-                }
-            }
-       }
+        combinatorics.Calculate(n);
+        auto& h_IM = m.at(n - MinNGamma());
+        for(const auto& h : event.Reconstructed().TaggerHits) {
+            prs.SetTaggerTime(triggersimu.GetCorrectedTaggerTime(h));
+            for(auto im : combinatorics.IMs())
+                h_IM.Fill(im);
+        }
+    }
 }
 
 void IMPlots::ShowResult()
@@ -88,9 +90,9 @@ Symmetric2Gamma::Symmetric2Gamma(const string& name, OptionsPtr opts):
 Symmetric2Gamma::~Symmetric2Gamma()
 {}
 
-void Symmetric2Gamma::ProcessEvent(const TEvent& event, manager_t&)
+void Symmetric2Gamma::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     const auto& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
     for( auto comb = utils::makeCombination(photons,2); !comb.done(); ++comb) {
         const TParticlePtr& g1 = comb.at(0);
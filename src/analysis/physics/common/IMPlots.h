@@ -3,6 +3,7 @@
 #include "analysis/physics/Physics.h"
 #include "plot/PromptRandomHist.h"
 #include "utils/TriggerSimulation.h"
+#include "utils/IMCombinatorics.h"
 #include <vector>
 
 class TH1D;
@@ -17,6 +18,7 @@ public:
     utils::TriggerSimulation triggersimu;
     PromptRandom::Switch prs;
     std::vector<PromptRandom::Hist1> m;
+    utils::IMCombinatorics combinatorics;
     unsigned MinNGamma() const noexcept { return 2;}
     unsigned MaxNGamma() const noexcept { return unsigned(m.size())+2; }
 
@@ -52,7 +52,7 @@ JustParticles::JustParticles(const string& name, OptionsPtr opts):
 
 void JustParticles::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     steps->Fill("Seen",1.0);
 
@@ -44,9 +44,9 @@ MCSmearing::~MCSmearing()
 
 }
 
-void MCSmearing::ProcessEvent(const TEvent& event, manager_t&)
+void MCSmearing::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     auto mctrue_particles = utils::ParticleTypeList::Make(event.MCTrue().ParticleTree);
 
     const auto& true_photons = mctrue_particles.Get(ParticleTypeDatabase::Photon);
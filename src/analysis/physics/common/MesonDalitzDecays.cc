@@ -223,9 +223,9 @@ MesonDalitzDecays::MesonDalitzDecays(const string& name, OptionsPtr opts) :
     }
 }
 
-void MesonDalitzDecays::ProcessEvent(const TEvent& event, manager_t&)
+void MesonDalitzDecays::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const TEventData& data = event.Reconstructed();
     const bool MC = data.ID.isSet(TID::Flags_t::MC);
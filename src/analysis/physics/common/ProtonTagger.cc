@@ -42,7 +42,7 @@ double TimeAverage(const std::initializer_list<const T> cands) {
     return time / energy;
 }
 
-void ProtonTagger::ProcessEvent(const TEvent& event, manager_t&)
+void ProtonTagger::ProcessEvent(const TEvent& event, manager_t& manager)
 {
 
     auto taps_cands = event.Reconstructed().Candidates.get_ptr_list(
@@ -56,7 +56,7 @@ void ProtonTagger::ProcessEvent(const TEvent& event, manager_t&)
 
     TParticleList cb_photons;
 
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     for(const auto& p : recon_particles.Get(ParticleTypeDatabase::Photon)) {
         if((p->Candidate && p->Candidate->Detector & Detector_t::Any_t::CB_Apparatus) && p->Ek() > 50.0) {
             cb_photons.emplace_back(p);
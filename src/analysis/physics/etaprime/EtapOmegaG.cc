@@ -69,9 +69,9 @@ EtapOmegaG::EtapOmegaG(const string& name, OptionsPtr opts) :
 
 }
 
-void EtapOmegaG::ProcessEvent(const TEvent& event, manager_t&)
+void EtapOmegaG::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    if(!triggersimu.ProcessEvent(event))
+    if(!triggersimu.ProcessEvent(event, manager))
         h_Cuts->Fill("Triggersimu failed", 1.0);
 
     // we start with some general candidate handling,
@@ -205,7 +205,7 @@ void EtapOmegaG::ProcessEvent(const TEvent& event, manager_t&)
     }
 
     // this ensures the TParticlePtr (shared_ptr) are only made once
-    utils::ProtonPhotonCombs proton_photons(data.Candidates);
+    const auto& proton_photons = manager.GetProtonPhotonCombs(event);
 
     // some extra info to pass to Process methods
     params_t p;
@@ -239,7 +239,7 @@ void EtapOmegaG::ProtonPhotonTree_t::Fill(const EtapOmegaG::params_t& params, co
     CBSumVetoE = 0;
     PhotonThetas().clear();
     nTouchesHole = 0;
-    for(const auto& photon : p.Photons) {
+    for(const auto& photon : p.Photons()) {
         const auto& cand = photon->Candidate;
         PhotonsEk += cand->CaloEnergy;
         if(cand->Detector & Detector_t::Type_t::CB) {
@@ -251,21 +251,21 @@ void EtapOmegaG::ProtonPhotonTree_t::Fill(const EtapOmegaG::params_t& params, co
         PhotonThetas().emplace_back(std_ext::radian_to_degree(cand->Theta));
         nTouchesHole += cand->FindCaloCluster()->HasFlag(TCluster::Flags_t::TouchesHoleCentral);
     }
-    assert(PhotonThetas().size() == p.Photons.size());
+    assert(PhotonThetas().size() == p.NPhotons());
 
     DiscardedEk = p.DiscardedEk;
     PhotonSum = p.PhotonSum.M();
     MissingMass = p.MissingMass;
-    ProtonCopl = std_ext::radian_to_degree(vec2::Phi_mpi_pi(p.Proton->Phi() - p.PhotonSum.Phi() - M_PI ));
+    ProtonCopl = std_ext::radian_to_degree(vec2::Phi_mpi_pi(p.Proton()->Phi() - p.PhotonSum.Phi() - M_PI ));
 
-    ProtonTime = p.Proton->Candidate->Time;
-    ProtonE = p.Proton->Ek();
-    ProtonTheta = std_ext::radian_to_degree(p.Proton->Theta());
-    ProtonVetoE = p.Proton->Candidate->VetoEnergy;
-    ProtonShortE = p.Proton->Candidate->FindCaloCluster()->ShortEnergy;
+    ProtonTime = p.Proton()->Candidate->Time;
+    ProtonE = p.Proton()->Ek();
+    ProtonTheta = std_ext::radian_to_degree(p.Proton()->Theta());
+    ProtonVetoE = p.Proton()->Candidate->VetoEnergy;
+    ProtonShortE = p.Proton()->Candidate->FindCaloCluster()->ShortEnergy;
     auto true_proton = utils::ParticleTools::FindParticle(ParticleTypeDatabase::Proton, params.ParticleTree);
     if(true_proton)
-        ProtonTrueAngle = std_ext::radian_to_degree(p.Proton->Angle(*true_proton));
+        ProtonTrueAngle = std_ext::radian_to_degree(p.Proton()->Angle(*true_proton));
     else
         ProtonTrueAngle = std_ext::NaN;
 
@@ -345,7 +345,7 @@ void EtapOmegaG::Sig_t::Process(params_t params)
 
     for(auto& p : params.Particles) {
 
-        auto result = kinfitter.DoFit(params.TaggerHit.PhotonEnergy, p.Proton, p.Photons);
+        auto result = kinfitter.DoFit(params.TaggerHit.PhotonEnergy, p.Proton(), p.Photons());
 
         if(result.Status != APLCON::Result_Status_t::Success)
             continue;
@@ -405,9 +405,10 @@ void EtapOmegaG::Sig_t::DoAntiPi0Eta(const params_t& params)
     for(const auto& p : params.Particles) {
 
         APLCON::Result_t r;
+        const auto photons = p.Photons();
 
         treefitter_Pi0Pi0.PrepareFits(params.TaggerHit.PhotonEnergy,
-                                      p.Proton, p.Photons);
+                                      p.Proton(), photons);
         while(treefitter_Pi0Pi0.NextFit(r)) {
             if(r.Status != APLCON::Result_Status_t::Success)
                 continue;
@@ -421,7 +422,7 @@ void EtapOmegaG::Sig_t::DoAntiPi0Eta(const params_t& params)
         }
 
         treefitter_Pi0Eta.PrepareFits(params.TaggerHit.PhotonEnergy,
-                                      p.Proton, p.Photons);
+                                      p.Proton(), photons);
         while(treefitter_Pi0Eta.NextFit(r)) {
             if(r.Status != APLCON::Result_Status_t::Success)
                 continue;
@@ -557,7 +558,8 @@ void EtapOmegaG::Sig_t::Pi0_t::Process(const params_t& params)
     for(const auto& p : params.Particles) {
 
         // do treefit
-        treefitter.PrepareFits(params.TaggerHit.PhotonEnergy, p.Proton, p.Photons);
+        const auto photons = p.Photons();
+        treefitter.PrepareFits(params.TaggerHit.PhotonEnergy, p.Proton(), photons);
 
         APLCON::Result_t r;
 
@@ -573,7 +575,7 @@ void EtapOmegaG::Sig_t::Pi0_t::Process(const params_t& params)
             // for MCTrue matching
             g1_Pi0_best = fitted_g1_Pi0->Get().Leaf->Particle;
             g2_Pi0_best = fitted_g2_Pi0->Get().Leaf->Particle;
-            photons_best = p.Photons;
+            photons_best = photons;
 
             // IM fitted expected to be delta peaks since they were fitted...
             const LorentzVec& Pi0 = fitted_Pi0->Get().LVSum;
@@ -606,7 +608,7 @@ void EtapOmegaG::Sig_t::Pi0_t::Process(const params_t& params)
             t.Bachelor_E().back() =  Boost(g2, -EtaPrime.BoostVector()).E;
 
             fill_gNonPi0(t, leave1->Particle->Candidate, leave2->Particle->Candidate);
-            fill_PhotonCombs(t, p.Photons);
+            fill_PhotonCombs(t, photons);
             t.Fill(params, p, treefitter.GetFittedProton()->Ek());
         }
 
@@ -676,7 +678,8 @@ void EtapOmegaG::Sig_t::OmegaPi0_t::Process(const params_t& params)
     for(const auto& p : params.Particles) {
 
         // do treefit
-        treefitter.PrepareFits(params.TaggerHit.PhotonEnergy, p.Proton, p.Photons);
+        const auto photons = p.Photons();
+        treefitter.PrepareFits(params.TaggerHit.PhotonEnergy, p.Proton(), photons);
 
         APLCON::Result_t r;
 
@@ -698,7 +701,7 @@ void EtapOmegaG::Sig_t::OmegaPi0_t::Process(const params_t& params)
             // remember for matching
             g_EtaPrime_best = fitted_g_EtaPrime->Get().Leaf->Particle; // unfitted for matching
             g_Omega_best    = fitted_g_Omega->Get().Leaf->Particle; // unfitted for matching
-            photons_best    = p.Photons;
+            photons_best    = photons;
 
             // have a look at the EtaPrime bachelor photon
             // the element NOT in the combination is the Bachelor photon
@@ -710,7 +713,7 @@ void EtapOmegaG::Sig_t::OmegaPi0_t::Process(const params_t& params)
             fill_gNonPi0(t,
                          fitted_g_EtaPrime->Get().Leaf->Particle->Candidate,
                          fitted_g_Omega->Get().Leaf->Particle->Candidate);
-            fill_PhotonCombs(t, p.Photons);
+            fill_PhotonCombs(t, photons);
             t.Fill(params, p, treefitter.GetFittedProton()->Ek());
         }
 
@@ -785,7 +788,7 @@ void EtapOmegaG::Ref_t::Process(params_t params)
     t.KinFitProb = std_ext::NaN;
     for(const auto& p : params.Particles) {
 
-        auto result = kinfitter.DoFit(params.TaggerHit.PhotonEnergy, p.Proton, p.Photons);
+        auto result = kinfitter.DoFit(params.TaggerHit.PhotonEnergy, p.Proton(), p.Photons());
 
         if(result.Status != APLCON::Result_Status_t::Success)
             continue;
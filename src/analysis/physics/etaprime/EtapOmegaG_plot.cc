@@ -490,6 +490,11 @@ struct EtapOmegaG_plot : Plotter {
         return treeCommon.Tree->GetEntries();
     }
 
+    virtual bool IsParallelSafe() const override
+    {
+        return true;
+    }
+
     virtual void ProcessEntry(const long long entry) override
     {
         treeCommon.Tree->GetEntry(entry);
@@ -504,7 +509,7 @@ struct EtapOmegaG_plot_Ref : EtapOmegaG_plot {
     RefHist_t::Tree_t          treeRef;
 
     using MCRefHist_t = MCTrue_Splitter<RefHist_t>;
-    cuttree::Tree_t<MCRefHist_t> cuttreeRef;
+    cuttree::Flat_t<MCRefHist_t> cuttreeRef;
 
     EtapOmegaG_plot_Ref(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         EtapOmegaG_plot("Ref", name, input, opts)
@@ -512,7 +517,7 @@ struct EtapOmegaG_plot_Ref : EtapOmegaG_plot {
         init_tree(input, treeRef, "EtapOmegaG/Ref/Ref");
         check_entries(treeRef);
 
-        cuttreeRef = cuttree::Make<MCRefHist_t>(HistFac);
+        cuttreeRef = cuttree::MakeFlat<MCRefHist_t>(HistFac);
     }
 
     virtual void ProcessEntry(const long long entry) override
@@ -531,8 +536,8 @@ struct EtapOmegaG_plot_Sig : EtapOmegaG_plot {
 
     using MCSigPi0Hist_t = MCTrue_Splitter<SigPi0Hist_t>;
     using MCSigOmegaPi0Hist_t = MCTrue_Splitter<SigOmegaPi0Hist_t>;
-    cuttree::Tree_t<MCSigPi0Hist_t>      cuttreeSigPi0;
-    cuttree::Tree_t<MCSigOmegaPi0Hist_t> cuttreeSigOmegaPi0;
+    cuttree::Flat_t<MCSigPi0Hist_t>      cuttreeSigPi0;
+    cuttree::Flat_t<MCSigOmegaPi0Hist_t> cuttreeSigOmegaPi0;
 
     EtapOmegaG_plot_Sig(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         EtapOmegaG_plot("Sig", name, input, opts)
@@ -545,8 +550,8 @@ struct EtapOmegaG_plot_Sig : EtapOmegaG_plot {
         check_entries(treeSigPi0);
         check_entries(treeSigOmegaPi0);
 
-        cuttreeSigPi0 = cuttree::Make<MCSigPi0Hist_t>(HistogramFactory("SigPi0",HistFac,"SigPi0"));
-        cuttreeSigOmegaPi0 = cuttree::Make<MCSigOmegaPi0Hist_t>(HistogramFactory("SigOmegaPi0",HistFac,"SigOmegaPi0"));
+        cuttreeSigPi0 = cuttree::MakeFlat<MCSigPi0Hist_t>(HistogramFactory("SigPi0",HistFac,"SigPi0"));
+        cuttreeSigOmegaPi0 = cuttree::MakeFlat<MCSigOmegaPi0Hist_t>(HistogramFactory("SigOmegaPi0",HistFac,"SigOmegaPi0"));
     }
 
     virtual void ProcessEntry(const long long entry) override
@@ -100,9 +100,9 @@ double Etap3pi0::applyEnergyMomentumConservation(double EBeam, const ant::TParti
    return result.ChiSquare;
 }
 
-void Etap3pi0::ProcessEvent(const TEvent& event, manager_t&)
+void Etap3pi0::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     /// TODO:geo-cuts ??
 
     const auto& data   = event.Reconstructed();
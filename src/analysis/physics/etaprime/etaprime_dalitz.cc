@@ -248,9 +248,9 @@ EtapDalitz::EtapDalitz(const string& name, OptionsPtr opts) :
     }
 }
 
-void EtapDalitz::ProcessEvent(const TEvent& event, manager_t&)
+void EtapDalitz::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data = event.Reconstructed();
     const bool MC = data.ID.isSet(TID::Flags_t::MC);
@@ -322,7 +322,7 @@ void EtapDalitz::ProcessEvent(const TEvent& event, manager_t&)
         ref.CBSumE = sig.CBSumE;
         ref.CBAvgTime = sig.CBAvgTime;
 
-        etap2g->Process(event);
+        etap2g->Process(event, manager);
 
         if (reference_only)
             return;
@@ -912,14 +912,14 @@ Etap2g::Etap2g(const string& name, OptionsPtr opts) :
     }
 }
 
-void Etap2g::ProcessEvent(const TEvent& event, manager_t&)
+void Etap2g::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    Process(event);
+    Process(event, manager);
 }
 
-void Etap2g::Process(const TEvent& event)
+void Etap2g::Process(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     const auto& cands = event.Reconstructed().Candidates;
 
     if (t->nCands != N_FINAL_STATE)
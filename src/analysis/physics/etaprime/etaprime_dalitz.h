@@ -368,7 +368,7 @@ public:
     void linkTree(RefTree_t&);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
-    void Process(const TEvent& event);
+    void Process(const TEvent& event, manager_t& manager);
 };
 
 }}} // namespace ant::analysis::physics
@@ -81,7 +81,7 @@ EtapProton::EtapProton(const string& name, OptionsPtr opts):
 
 void EtapProton::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     steps->Fill("Seen",1.0);
 
@@ -0,0 +1,55 @@
+#include "manager_t.h"
+
+#include "analysis/utils/ParticleTools.h"
+#include "analysis/utils/ProtonPhotonCombs.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+#include "base/std_ext/memory.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+using namespace ant::analysis::physics;
+
+manager_t::manager_t() {}
+
+manager_t::~manager_t() {}
+
+void manager_t::UseCacheFor(const TEvent& event)
+{
+    if(cachedEvent == addressof(event))
+        return;
+    cachedEvent = addressof(event);
+    hasTriggerSimulation = false;
+    particles = nullptr;
+    protonPhotonCombs = nullptr;
+}
+
+const utils::TriggerSimulation::info_t& manager_t::GetTriggerSimulation(const TEvent& event)
+{
+    UseCacheFor(event);
+    if(!hasTriggerSimulation) {
+        triggerSimulation = utils::TriggerSimulation::Calculate(event);
+        hasTriggerSimulation = true;
+    }
+    return triggerSimulation;
+}
+
+const utils::ParticleTypeList& manager_t::GetParticles(const TEvent& event)
+{
+    UseCacheFor(event);
+    if(!particles)
+        particles = std_ext::make_unique<utils::ParticleTypeList>(
+                        utils::ParticleTypeList::Make(event.Reconstructed().Candidates));
+    return *particles;
+}
+
+const utils::ProtonPhotonCombs& manager_t::GetProtonPhotonCombs(const TEvent& event)
+{
+    UseCacheFor(event);
+    if(!protonPhotonCombs)
+        protonPhotonCombs = std_ext::make_unique<utils::ProtonPhotonCombs>(
+                                event.Reconstructed().Candidates);
+    return *protonPhotonCombs;
+}
@@ -1,26 +1,75 @@
 #pragma once
 
+#include "analysis/utils/TriggerSimulation.h"
+
+#include <memory>
+
 namespace ant {
+
+struct TEvent;
+
 namespace analysis {
 
 class PhysicsManager;
 class SlowControlManager;
 
+namespace utils {
+struct ParticleTypeList;
+struct ProtonPhotonCombs;
+}
+
 namespace physics {
 
 struct manager_t {
+    manager_t();
+    ~manager_t();
+
     void SaveEvent() {
         saveEvent = true;
     }
     void KeepDetectorReadHits() {
         keepReadHits = true;
     }
+
+    /**
+     * @brief GetTriggerSimulation calculates the trigger information on first request,
+     * all physics classes processing the same event then share the result
+     * @param event the current event
+     * @return trigger information, see utils::TriggerSimulation
+     */
+    const utils::TriggerSimulation::info_t& GetTriggerSimulation(const TEvent& event);
+
+    /**
+     * @brief GetParticles identifies the reconstructed candidates with the default ParticleID,
+     * done on first request and shared by all physics classes processing the same event
+     * @param event the current event
+     * @return identified particles, use ParticleTypeList::Make for a different ParticleID
+     */
+    const utils::ParticleTypeList& GetParticles(const TEvent& event);
+
+    /**
+     * @brief GetProtonPhotonCombs pre-builds the proton/photon combinations of the reconstructed candidates,
+     * done on first request and shared by all physics classes processing the same event
+     * @param event the current event
+     * @return combinations, call operator() on it to get a copy for filtering
+     */
+    const utils::ProtonPhotonCombs& GetProtonPhotonCombs(const TEvent& event);
+
 private:
     friend class ant::analysis::PhysicsManager;
     friend class ant::analysis::SlowControlManager;
     bool saveEvent = false;
     bool keepReadHits = false;
 
+    // per-event cache, which is reset if asked for a different event
+    const TEvent* cachedEvent = nullptr;
+    void UseCacheFor(const TEvent& event);
+
+    bool hasTriggerSimulation = false;
+    utils::TriggerSimulation::info_t triggerSimulation;
+    std::unique_ptr<const utils::ParticleTypeList> particles;
+    std::unique_ptr<const utils::ProtonPhotonCombs> protonPhotonCombs;
+
 };
 
 }
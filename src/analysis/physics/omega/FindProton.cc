@@ -87,9 +87,9 @@ FindProton::~FindProton()
 
 }
 
-void FindProton::ProcessEvent(const TEvent& event, manager_t&)
+void FindProton::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     steps->Fill("Total", 1.0);
 
@@ -49,10 +49,10 @@ GeoAcceptance::~GeoAcceptance()
 {
 }
 
-void GeoAcceptance::ProcessEvent(const TEvent& event, manager_t&)
+void GeoAcceptance::ProcessEvent(const TEvent& event, manager_t& manager)
 {
     auto mctrue_particles = utils::ParticleTypeList::Make(event.MCTrue().ParticleTree);
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     for( auto& a : analyses ) {
         a.Fill(mctrue_particles.Get(ParticleTypeDatabase::Photon),
                recon_particles.Get(ParticleTypeDatabase::Photon)
@@ -51,9 +51,9 @@ Omega_EpEm::Omega_EpEm(const string &name, OptionsPtr opts) :
 
 }
 
-void Omega_EpEm::ProcessEvent(const TEvent& event, manager_t&)
+void Omega_EpEm::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     for(auto& taggerhit : event.Reconstructed().TaggerHits) {
         promptrandom.SetTaggerTime(triggersimu.GetCorrectedTaggerTime(taggerhit));
         if(promptrandom.State() == PromptRandom::Case::Outside)
@@ -70,7 +70,7 @@ void Omega_EpEm::ProcessEvent(const TEvent& event, manager_t&)
     TCandidatePtrList cands_taps;
     TCandidatePtrList cands_cb;
 
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
     const auto& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
     h_nPhotons->Fill(photons.size());
     //utils::ParticleTools::FillIMCombinations([this] (double x) {h_IM_2g->Fill(x);},  2, photons);
@@ -45,7 +45,7 @@ using namespace ant::std_ext;
 
 void OmegaBase::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     const auto& data = mode==DataMode::Reconstructed ? event.Reconstructed() : event.MCTrue();
     Analyse(data, event, manager);
 }
@@ -1696,7 +1696,7 @@ public:
     long long GetNumEntries() const override { return t->GetEntries(); }
     void ProcessEntry(const long long entry) override;
 
-    plot::cuttree::Tree_t<MCTrue_Splitter<OmegaHist_t>> signal_hists;
+    plot::cuttree::Flat_t<MCTrue_Splitter<OmegaHist_t>> signal_hists;
     OmegaHist_t::Tree_t tree;
 
 };
@@ -1776,7 +1776,7 @@ OmegaEtaG_Plot::OmegaEtaG_Plot(const string &name, const WrapTFileInput &input,
     };
 
     OmegaHist_t::opts = opts;
-    signal_hists = plot::cuttree::Make<MCTrue_Splitter<OmegaHist_t>>(HistFac,cuts());
+    signal_hists = plot::cuttree::MakeFlat<MCTrue_Splitter<OmegaHist_t>>(HistFac,cuts());
 
 }
 
@@ -39,9 +39,9 @@ JustPi0::JustPi0(const string& name, OptionsPtr opts) :
     }
 }
 
-void JustPi0::ProcessEvent(const TEvent& event, manager_t&)
+void JustPi0::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
     if(!triggersimu.HasTriggered())
         return;
 
@@ -88,9 +88,9 @@ singlePi0::singlePi0(const string& name, ant::OptionsPtr opts):
     tree.EMB_photons().resize(phSettings.nPhotons);
 }
 
-void singlePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
+void singlePi0::ProcessEvent(const ant::TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data   = event.Reconstructed();
 
@@ -195,9 +195,9 @@ triplePi0::fitRatings_t applyTreeFit(utils::TreeFitter& fitter,
     return fr;
 }
 
-void triplePi0::ProcessEvent(const ant::TEvent& event, manager_t&)
+void triplePi0::ProcessEvent(const ant::TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data   = event.Reconstructed();
 
@@ -864,7 +864,7 @@ protected:
 
     };
 
-    plot::cuttree::Tree_t<MCTrue_Splitter<TriplePi0Hist_t>> signal_hists;
+    plot::cuttree::Flat_t<MCTrue_Splitter<TriplePi0Hist_t>> signal_hists;
 
     // Plotter interface
 public:
@@ -872,7 +872,7 @@ public:
     triplePi0_Plot(const string& name, const WrapTFileInput& input, OptionsPtr opts):
         triplePi0_PlotBase(name,input,opts)
     {
-        signal_hists = cuttree::Make<MCTrue_Splitter<TriplePi0Hist_t>>(HistFac);
+        signal_hists = cuttree::MakeFlat<MCTrue_Splitter<TriplePi0Hist_t>>(HistFac);
     }
 
 
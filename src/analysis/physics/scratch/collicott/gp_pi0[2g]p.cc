@@ -36,9 +36,9 @@ scratch_collicott_ppi0_2gamma::scratch_collicott_ppi0_2gamma(const std::string&
 }
 
 
-void scratch_collicott_ppi0_2gamma::ProcessEvent(const TEvent& event, manager_t&)
+void scratch_collicott_ppi0_2gamma::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     // Check the decay string for MC
     // ******************************
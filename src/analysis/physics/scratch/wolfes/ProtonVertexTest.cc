@@ -38,9 +38,9 @@ ProtonVertexTest::ProtonVertexTest(const string& name, OptionsPtr opts):
     tree.CreateBranches(HistFac.makeTTree("ptree"));
 }
 
-void ProtonVertexTest::ProcessEvent(const TEvent& event, manager_t&)
+void ProtonVertexTest::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data   = event.Reconstructed();
 
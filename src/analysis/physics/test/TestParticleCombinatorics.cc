@@ -34,9 +34,9 @@ TestParticleCombinatorics::TestParticleCombinatorics(const std::string& name, Op
 }
 
 
-void TestParticleCombinatorics::ProcessEvent(const TEvent& event, manager_t&)
+void TestParticleCombinatorics::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
+    const auto& recon_particles = manager.GetParticles(event);
 
     const TParticleList& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
     const TParticleList& protons = recon_particles.Get(ParticleTypeDatabase::Proton);
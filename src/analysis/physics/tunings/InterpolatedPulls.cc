@@ -82,9 +82,9 @@ InterpolatedPulls::InterpolatedPulls(const string& name, OptionsPtr opts) :
 
 }
 
-void InterpolatedPulls::ProcessEvent(const TEvent& event, manager_t&)
+void InterpolatedPulls::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const TEventData& data = event.Reconstructed();
 
@@ -89,12 +89,12 @@ void TriggerSimulation::ClusterPlots_t::Show(canvas &c) const
       << endr;
 }
 
-void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t&)
+void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t& manager)
 {
 
     steps->Fill("Seen",1);
 
-    if(!triggersimu.ProcessEvent(event)) {
+    if(!triggersimu.ProcessEvent(event, manager)) {
         steps->Fill("TriggerSimu failed", 1.0);
         return;
     }
@@ -136,7 +136,7 @@ void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t&)
     if(t.nPhotons != 2 && t.nPhotons != 4)
         return;
 
-    utils::ProtonPhotonCombs proton_photons(recon.Candidates);
+    const auto& proton_photons = manager.GetProtonPhotonCombs(event);
 
     for(const TTaggerHit& taggerhit : recon.TaggerHits) {
 
@@ -176,7 +176,7 @@ void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t&)
         t.FitProb = std_ext::NaN;
         for(const auto& comb : filtered_combs) {
 
-            const auto& result = fitter.DoFit(taggerhit.PhotonEnergy, comb.Proton, comb.Photons);
+            const auto& result = fitter.DoFit(taggerhit.PhotonEnergy, comb.Proton(), comb.Photons());
 
             if(result.Status != APLCON::Result_Status_t::Success)
                 continue;
@@ -196,7 +196,7 @@ void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t&)
             };
 
             fill_IM_Combs(t.IM_Combs_fitted, fitter.GetFittedPhotons());
-            fill_IM_Combs(t.IM_Combs_raw, comb.Photons);
+            fill_IM_Combs(t.IM_Combs_raw, comb.Photons());
         }
 
         if(t.FitProb>0.01) {
@@ -317,7 +317,7 @@ struct TriggerSimulation_plot : Plotter {
 
     Hist_t::Tree_t tree;
 
-    cuttree::Tree_t<DataMC_Splitter> mycuttree;
+    cuttree::Flat_t<DataMC_Splitter> mycuttree;
 
     TriggerSimulation_plot(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -326,7 +326,7 @@ struct TriggerSimulation_plot : Plotter {
             throw Exception("Cannot find tree TriggerSimulation/tree");
         tree.LinkBranches();
 
-        mycuttree = cuttree::Make<DataMC_Splitter>(HistFac);
+        mycuttree = cuttree::MakeFlat<DataMC_Splitter>(HistFac);
     }
 
     virtual long long GetNumEntries() const override
@@ -334,6 +334,11 @@ struct TriggerSimulation_plot : Plotter {
         return tree.Tree->GetEntries();
     }
 
+    virtual bool IsParallelSafe() const override
+    {
+        return true;
+    }
+
     virtual void ProcessEntry(const long long entry) override
     {
         tree.Tree->GetEntry(entry);
@@ -342,7 +347,7 @@ struct TriggerSimulation_plot : Plotter {
 
     virtual void ShowResult() override {
         canvas c(GetName());
-        mycuttree->Get().Hist.Draw(c);
+        mycuttree.GetTree()->Get().Hist.Draw(c);
         c << endc;
     }
 
@@ -39,9 +39,9 @@ TwoPi0_MCSmearing::TwoPi0_MCSmearing(const string& name, OptionsPtr opts) :
 
 }
 
-void TwoPi0_MCSmearing::ProcessEvent(const TEvent& event, manager_t&)
+void TwoPi0_MCSmearing::ProcessEvent(const TEvent& event, manager_t& manager)
 {
-    triggersimu.ProcessEvent(event);
+    triggersimu.ProcessEvent(event, manager);
 
     const auto& data = event.Reconstructed();
 
@@ -13,6 +13,8 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <cstdint>
+#include <algorithm>
 
 namespace ant {
 namespace analysis {
@@ -138,6 +140,136 @@ void Fill(Tree_t<Hist_t> cuttree, const Fill_t& f) {
     }
 }
 
+/**
+ * @brief The Flat_t class is a compiled version of the cuttree
+ *
+ * The nodes are stored level by level in a flat array with their parent indices,
+ * which is usually much faster when having thousands of cut combinations:
+ * Each distinct cut is evaluated only once per Fill (and only if any node on the
+ * previous level has passed), then the pass flags of all nodes are computed without
+ * branching, and finally the histograms of all passing nodes are filled in one linear pass.
+ *
+ * Use MakeFlat/Fill instead of Make/Fill, the underlying tree is available via GetTree()
+ */
+template<typename Hist_t>
+class Flat_t {
+public:
+    using Fill_t = typename Hist_t::Fill_t;
+
+    Flat_t() = default;
+
+    Flat_t(Tree_t<Hist_t> cuttree, const Cuts_t<Fill_t>& cuts) :
+        tree(cuttree)
+    {
+        // the cut of the root node
+        Cuts.emplace_back(tree->Get().PassesCut);
+        for(const auto& multicut : cuts)
+            for(const auto& cut : multicut)
+                Cuts.emplace_back(cut.Passes);
+
+        // breadth-first, such that the levels are contiguous in Nodes
+        // and parents always come before their daughters
+        std::vector<Tree_t<Hist_t>> current{tree};
+        Nodes.emplace_back(0, 0, std::addressof(tree->Get().Hist));
+        Levels.emplace_back(0, 1, 0, 1);
+
+        std::size_t cutOffset = 1;
+        for(const auto& multicut : cuts) {
+            std::vector<Tree_t<Hist_t>> next;
+            const auto levelBegin = Nodes.size();
+            for(std::size_t parent=0; parent<current.size(); parent++) {
+                const auto& daughters = current[parent]->Daughters();
+                if(daughters.size() != multicut.size())
+                    throw std::runtime_error("Cuttree does not match given cuts");
+                // the daughters are created in the order of the multicut, see Build()
+                std::size_t i = 0;
+                for(const auto& d : daughters) {
+                    Nodes.emplace_back(Levels.back().NodesBegin + parent, cutOffset + i, std::addressof(d->Get().Hist));
+                    next.emplace_back(d);
+                    ++i;
+                }
+            }
+            Levels.emplace_back(levelBegin, Nodes.size(), cutOffset, cutOffset + multicut.size());
+            cutOffset += multicut.size();
+            current = std::move(next);
+        }
+
+        CutResults.resize(Cuts.size());
+        Passed.resize(Nodes.size());
+    }
+
+    void Fill(const Fill_t& f) {
+        // the root node does not have a parent
+        Passed[0] = Cuts[0](f);
+
+        for(std::size_t l=1; l<Levels.size(); l++) {
+            const auto& prev = Levels[l-1];
+            const auto& level = Levels[l];
+
+            // evaluate the cuts only if any node on the previous level has passed,
+            // that's exactly when the recursive Fill would evaluate them
+            const auto passed_begin = std::next(Passed.begin(), prev.NodesBegin);
+            const auto passed_end   = std::next(Passed.begin(), prev.NodesEnd);
+            if(std::find(passed_begin, passed_end, 1) == passed_end) {
+                std::fill(std::next(Passed.begin(), level.NodesBegin), Passed.end(), 0);
+                break;
+            }
+
+            for(auto i = level.CutsBegin; i < level.CutsEnd; i++)
+                CutResults[i] = Cuts[i](f);
+
+            for(auto i = level.NodesBegin; i < level.NodesEnd; i++) {
+                const auto& node = Nodes[i];
+                Passed[i] = Passed[node.Parent] & CutResults[node.Cut];
+            }
+        }
+
+        for(std::size_t i=0; i<Nodes.size(); i++) {
+            if(Passed[i])
+                Nodes[i].Hist->Fill(f);
+        }
+    }
+
+    const Tree_t<Hist_t>& GetTree() const { return tree; }
+
+private:
+    struct node_t {
+        std::size_t Parent;
+        std::size_t Cut;
+        Hist_t* Hist;
+        node_t(std::size_t parent, std::size_t cut, Hist_t* hist) :
+            Parent(parent), Cut(cut), Hist(hist) {}
+    };
+
+    struct level_t {
+        std::size_t NodesBegin;
+        std::size_t NodesEnd;
+        std::size_t CutsBegin;
+        std::size_t CutsEnd;
+        level_t(std::size_t nodesBegin, std::size_t nodesEnd,
+                std::size_t cutsBegin, std::size_t cutsEnd) :
+            NodesBegin(nodesBegin), NodesEnd(nodesEnd),
+            CutsBegin(cutsBegin), CutsEnd(cutsEnd) {}
+    };
+
+    Tree_t<Hist_t> tree; // owns the histograms
+    std::vector<typename Cut_t<Fill_t>::Passes_t> Cuts;
+    std::vector<node_t>       Nodes;
+    std::vector<level_t>      Levels;
+    std::vector<std::uint8_t> CutResults;
+    std::vector<std::uint8_t> Passed;
+};
+
+template<typename Hist_t, typename Fill_t = typename Hist_t::Fill_t>
+Flat_t<Hist_t> MakeFlat(HistogramFactory histFac, const Cuts_t<Fill_t>& cuts = Hist_t::GetCuts()) {
+    return {Make<Hist_t>(histFac, cuts), cuts};
+}
+
+template<typename Hist_t, typename Fill_t = typename Hist_t::Fill_t>
+void Fill(Flat_t<Hist_t>& flattree, const Fill_t& f) {
+    flattree.Fill(f);
+}
+
 template<typename Hist_t>
 struct StackedHists_t {
 public:
@@ -1,6 +1,9 @@
 #include "HistogramFactory.h"
 
 #include "base/std_ext/string.h"
+#include "base/std_ext/memory.h"
+#include "base/Logger.h"
+#include "root-addons/analysis_codes/hstack.h"
 
 #include "TDirectory.h"
 #include "TGraph.h"
@@ -10,6 +13,7 @@
 #include "TH3D.h"
 #include "TMath.h"
 #include "TTree.h"
+#include "TList.h"
 
 #include <algorithm>
 #include <cmath>
@@ -263,3 +267,74 @@ HistogramFactory::DirStackPush::~DirStackPush()
 {
     dir->cd();
 }
+
+HistogramFactory::DirectoryBuffer::DirectoryBuffer(const string& name) :
+    dir([&name] () {
+        // create it without mother, so it is not registered in the list of gDirectory,
+        // which also makes the paths of the contained objects identical to the registered ones
+        TDirectory::TContext context(nullptr);
+        return std_ext::make_unique<TDirectory>(name.c_str(), "HistogramFactory directory buffer");
+    }())
+{}
+
+HistogramFactory::DirectoryBuffer::~DirectoryBuffer()
+{}
+
+HistogramFactory::DirectoryBuffer::Scope::Scope(const DirectoryBuffer& buffer) :
+    dir(gDirectory)
+{
+    buffer.dir->cd();
+}
+
+HistogramFactory::DirectoryBuffer::Scope::~Scope()
+{
+    dir->cd();
+}
+
+namespace {
+
+void merge_into(TDirectory& target, TDirectory& source) {
+    TIter next(source.GetList());
+    while(auto obj = next()) {
+        const auto name = obj->GetName();
+        if(auto source_dir = dynamic_cast<TDirectory*>(obj)) {
+            auto target_dir = dynamic_cast<TDirectory*>(target.Get(name));
+            if(!target_dir)
+                target_dir = target.mkdir(name);
+            merge_into(*target_dir, *source_dir);
+        }
+        else if(auto source_hist = dynamic_cast<TH1*>(obj)) {
+            if(auto target_hist = dynamic_cast<TH1*>(target.Get(name))) {
+                target_hist->Add(source_hist);
+            }
+            else {
+                // for example lazily created by cuttree::StackedHists_t
+                auto clone = dynamic_cast<TH1*>(source_hist->Clone());
+                clone->SetDirectory(addressof(target));
+            }
+            source_hist->Reset();
+        }
+        else if(auto source_stack = dynamic_cast<hstack*>(obj)) {
+            if(auto target_stack = dynamic_cast<hstack*>(target.Get(name))) {
+                // adds the paths of missing histograms only
+                TList l;
+                l.Add(source_stack);
+                target_stack->Merge(addressof(l), nullptr);
+            }
+            else {
+                // like the histograms, the stack refers to them by path
+                target.Append(source_stack->Clone());
+            }
+        }
+        else {
+            VLOG(5) << "Not merging buffered object " << name << " of class " << obj->ClassName();
+        }
+    }
+}
+
+}
+
+void HistogramFactory::DirectoryBuffer::MergeInto(TDirectory* target) const
+{
+    merge_into(*target, *dir);
+}
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 class TDirectory;
 class TNamed;
@@ -137,6 +138,48 @@ public:
         return dynamic_cast<T*>(obj->Clone(newName.c_str()));
     }
 
+    /**
+     * @brief The DirectoryBuffer class provides histograms which can be filled by another thread
+     *
+     * While a DirectoryBuffer::Scope exists, HistogramFactory instances without explicit root directory
+     * (for example Physics::HistFac and hence also PromptRandom::Hist1/Hist2 and cuttree nodes)
+     * create their objects in a private in-memory directory tree instead of gDirectory.
+     * Constructing a physics class once normally and once within the scope gives two instances
+     * with identical relative histogram paths, where the buffered one may be filled by one other thread.
+     * MergeInto() adds the buffered histograms to the registered ones, see PhysicsManager::AddBuffer
+     * to do this before Physics::Finish is called.
+     *
+     * @note The buffer itself is not thread-safe: creating it, the Scope and MergeInto()
+     * change or read gDirectory and must happen in the thread owning the registered histograms,
+     * and MergeInto() must not run while the buffered histograms are still filled.
+     */
+    class DirectoryBuffer {
+    public:
+        explicit DirectoryBuffer(const std::string& name = "DirectoryBuffer");
+        ~DirectoryBuffer();
+
+        DirectoryBuffer(const DirectoryBuffer&) = delete;
+        DirectoryBuffer& operator=(const DirectoryBuffer&) = delete;
+
+        struct Scope {
+        private:
+            TDirectory* dir;
+        public:
+            explicit Scope(const DirectoryBuffer& buffer);
+            ~Scope();
+        };
+
+        /**
+         * @brief MergeInto adds all buffered histograms to the ones found at the same path
+         * @param target the directory which was gDirectory when the registered instances were created
+         * @note the buffers are reset afterwards, histograms not present in target are copied to target
+         */
+        void MergeInto(TDirectory* target) const;
+
+    private:
+        std::unique_ptr<TDirectory> dir;
+    };
+
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error;
     };
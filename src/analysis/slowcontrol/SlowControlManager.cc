@@ -153,4 +153,81 @@ slowcontrol::event_t SlowControlManager::PopEvent() {
     return event;
 }
 
+slowcontrol::epoch_t SlowControlManager::PopEpoch()
+{
+    slowcontrol::epoch_t epoch;
+
+    while(!eventbuffer.empty()) {
+
+        auto& front = eventbuffer.front();
+
+        // backward processors change their value after this event
+        std::vector<processor_t*> changed_after;
+
+        if(front.Event.HasReconstructed()) {
+
+            // check first if all processors are still complete
+            // otherwise go back to filling
+            bool all_complete = true;
+            for(auto& p : processors)
+                all_complete &= p.IsComplete();
+            if(!all_complete)
+                break;
+
+            const auto& id = front.Event.Reconstructed().ID;
+
+            // forward processors change their value before this event,
+            // so it starts a new epoch
+            std::vector<processor_t*> changed_before;
+            for(auto& p : processors) {
+                if(p.Type == processor_t::type_t::Forward) {
+                    if(p.CompletionPoints.size()>1 && *std::next(p.CompletionPoints.begin()) == id)
+                        changed_before.push_back(std::addressof(p));
+                }
+                else if(p.Type == processor_t::type_t::Backward) {
+                    if(p.CompletionPoints.front() == id)
+                        changed_after.push_back(std::addressof(p));
+                }
+            }
+
+            if(!changed_before.empty()) {
+                if(epoch)
+                    break;
+                for(auto p : changed_before) {
+                    p->CompletionPoints.pop_front();
+                    p->Processor->PopQueue();
+                    p->Changed = true;
+                }
+            }
+        }
+
+        // the first event determines the values of the epoch
+        if(!epoch) {
+            for(auto& p : processors) {
+                // an empty queue is only possible for skipped events, which do not need the value
+                p.Processor->GetStates(epoch.States);
+                epoch.Changed.emplace_back(p.Processor.get(), p.Changed);
+            }
+        }
+
+        // changed flags are kept until a non-skipped event was processed
+        if(!front.WantsSkip) {
+            for(auto& p : processors)
+                p.Changed = false;
+        }
 
+        epoch.Events.emplace_back(std::move(front));
+        eventbuffer.pop();
+
+        if(!changed_after.empty()) {
+            for(auto p : changed_after) {
+                p->CompletionPoints.pop_front();
+                p->Processor->PopQueue();
+                p->Changed = true;
+            }
+            break;
+        }
+    }
+
+    return epoch;
+}
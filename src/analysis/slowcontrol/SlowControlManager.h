@@ -1,6 +1,7 @@
 #pragma once
 
 #include "event_t.h"
+#include "epoch_t.h"
 #include "SlowControlProcessors.h"
 
 #include <queue>
@@ -27,6 +28,9 @@ protected:
         };
         type_t Type = type_t::Unknown;
 
+        // changed flag used by PopEpoch, processors start in changed state
+        bool Changed = true;
+
         bool IsComplete() const;
     };
 
@@ -41,6 +45,14 @@ public:
 
     slowcontrol::event_t PopEvent();
 
+    /**
+     * @brief PopEpoch pops all buffered events up to the next change of any processor
+     * @return epoch carrying the processor values, empty if manager is not complete
+     *
+     * Use either PopEvent or PopEpoch, but do not mix them.
+     */
+    slowcontrol::epoch_t PopEpoch();
+
     size_t BufferSize() const { return eventbuffer.size(); }
 
 };
@@ -0,0 +1,49 @@
+#include "epoch_t.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::slowcontrol;
+
+namespace {
+thread_local const epoch_t* current = nullptr;
+}
+
+epoch_t::Scope::Scope(const epoch_t& epoch) :
+    previous(current)
+{
+    current = addressof(epoch);
+}
+
+epoch_t::Scope::~Scope()
+{
+    current = previous;
+}
+
+const epoch_t* epoch_t::Current()
+{
+    return current;
+}
+
+Processor::StatePtr epoch_t::GetState(const Processor& processor) const
+{
+    auto it = find_if(States.begin(), States.end(), [&processor] (const Processor::states_t::value_type& s) {
+        return s.first == addressof(processor);
+    });
+    return it == States.end() ? nullptr : it->second;
+}
+
+bool epoch_t::HasChanged(const Processor& processor) const
+{
+    auto it = find_if(Changed.begin(), Changed.end(), [&processor] (const changed_t& c) {
+        return c.Processor == addressof(processor);
+    });
+    return it != Changed.end() && it->Changed;
+}
+
+void epoch_t::ClearChanged()
+{
+    for(auto& c : Changed)
+        c.Changed = false;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "event_t.h"
+#include "processors/Processor.h"
+
+#include <list>
+#include <vector>
+#include <memory>
+
+namespace ant {
+namespace analysis {
+
+class SlowControlManager;
+
+namespace slowcontrol {
+
+/**
+ * @brief The epoch_t struct holds consecutive events sharing the same slowcontrol values
+ *
+ * An epoch carries its own copy of the values of all processors and their changed flags,
+ * so it does not depend on the SlowControlManager, which might already buffer later events.
+ * While a Scope exists, the processors, and thus the slowcontrol variables, look up their
+ * values in that epoch instead of their queues. As the Scope is local to the thread
+ * creating it, different epochs can be processed concurrently in different threads.
+ */
+struct epoch_t {
+    std::list<event_t> Events;
+
+    epoch_t() = default;
+    epoch_t& operator=(epoch_t&&) = default;
+    epoch_t(epoch_t&&) = default;
+
+    // makes "while(auto e = scm.PopEpoch()) {}" loops possible
+    explicit operator bool() const {
+        return !Events.empty();
+    }
+
+    /**
+     * @brief The Scope struct makes the values of an epoch visible to the slowcontrol variables in this thread
+     */
+    struct Scope {
+        explicit Scope(const epoch_t& epoch);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const epoch_t* previous;
+    };
+
+    /// the epoch of the innermost Scope in this thread, nullptr if there is none
+    static const epoch_t* Current();
+
+    /// the state the processor added to this epoch, nullptr if it did not
+    Processor::StatePtr GetState(const Processor& processor) const;
+
+    bool HasChanged(const Processor& processor) const;
+
+    /**
+     * @brief ClearChanged should be called after the first non-skipped event was processed
+     */
+    void ClearChanged();
+
+protected:
+    friend class ant::analysis::SlowControlManager;
+
+    // the values of the processors and their members
+    Processor::states_t States;
+
+    struct changed_t {
+        changed_t(const Processor* processor, bool changed) :
+            Processor(processor), Changed(changed)
+        {}
+        const slowcontrol::Processor* Processor;
+        bool Changed;
+    };
+    std::vector<changed_t> Changed;
+};
+
+}}} // namespace ant::analysis::slowcontrol
@@ -40,7 +40,17 @@ void AcquScalerVector::PopQueue() {
     queue.pop();
 }
 
+bool AcquScalerVector::GetStates(states_t& states) const {
+    if(queue.empty())
+        return false;
+    states.emplace_back(this, make_shared<value_state_t>(queue.front()));
+    return true;
+}
+
 AcquScalerVector::value_t AcquScalerVector::Get() const {
+    // only added by GetStates above
+    if(auto state = static_pointer_cast<const value_state_t>(GetEpochState()))
+        return state->Value;
     // if this assert fails, probably a physics class forgot
     // to request the slowcontrol variable in its constructor
     // see DebugPhysics how to it properly
@@ -21,6 +21,8 @@ struct AcquScalerVector : Processor {
 
     virtual void PopQueue() override;
 
+    virtual bool GetStates(states_t& states) const override;
+
     value_t Get() const;
 
 
@@ -28,6 +30,11 @@ private:
     bool firstScalerSeen = false;
     const std::string name;
     std::queue<value_t> queue;
+
+    struct value_state_t : state_t {
+        explicit value_state_t(value_t v) : Value(std::move(v)) {}
+        const value_t Value;
+    };
 };
 
 
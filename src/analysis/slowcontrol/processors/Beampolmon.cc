@@ -27,3 +27,7 @@ void Beampolmon::PopQueue() {
     FaradayCup.PopQueue();
 }
 
+bool Beampolmon::GetStates(states_t& states) const
+{
+    return CollectStates(states, {&Reference_1MHz, &PbGlass, &FaradayCup});
+}
@@ -25,6 +25,8 @@ struct Beampolmon : Processor {
 
     virtual void PopQueue() override;
 
+    virtual bool GetStates(states_t& states) const override;
+
 };
 
 
@@ -29,3 +29,7 @@ void ExpTrigger::PopQueue() {
     L1Trigger.PopQueue();
 }
 
+bool ExpTrigger::GetStates(states_t& states) const
+{
+    return CollectStates(states, {&Reference_1MHz, &LiveCounter, &Trigger, &L1Trigger});
+}
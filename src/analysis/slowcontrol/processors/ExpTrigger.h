@@ -27,6 +27,8 @@ struct ExpTrigger : Processor {
 
     virtual void PopQueue() override;
 
+    virtual bool GetStates(states_t& states) const override;
+
 };
 
 
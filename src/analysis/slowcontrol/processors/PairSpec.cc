@@ -27,3 +27,8 @@ void Beam::PopQueue()
     IonChamber.PopQueue();
     PairSpecGate.PopQueue();
 }
+
+bool Beam::GetStates(states_t& states) const
+{
+    return CollectStates(states, {&IonChamber, &PairSpecGate});
+}
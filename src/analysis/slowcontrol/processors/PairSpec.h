@@ -23,6 +23,8 @@ struct Beam : Processor {
 
     virtual void PopQueue() override;
 
+    virtual bool GetStates(states_t& states) const override;
+
 };
 
 
@@ -0,0 +1,21 @@
+#include "Processor.h"
+
+#include "slowcontrol/epoch_t.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::slowcontrol;
+
+bool Processor::HasChanged() const
+{
+    if(auto epoch = epoch_t::Current())
+        return epoch->HasChanged(*this);
+    return hasChanged;
+}
+
+Processor::StatePtr Processor::GetEpochState() const
+{
+    if(auto epoch = epoch_t::Current())
+        return epoch->GetState(*this);
+    return nullptr;
+}
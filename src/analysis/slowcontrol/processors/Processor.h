@@ -3,6 +3,12 @@
 #include "analysis/physics/manager_t.h"
 #include "tree/TEventData.h"
 
+#include <memory>
+#include <vector>
+#include <utility>
+#include <initializer_list>
+#include <stdexcept>
+
 namespace ant {
 namespace analysis {
 namespace slowcontrol {
@@ -15,13 +21,29 @@ struct Processor {
         Skip,      // skip that whole event (unprocessable)
     };
 
-    bool HasChanged() const { return hasChanged; }
+    /// the changed flag of the epoch active in this thread, see epoch_t::Scope, otherwise of this processor
+    bool HasChanged() const;
     void SetHasChanged(bool value) { hasChanged = value; }
 
     virtual void Init() {} // accessing the ExpConfig in the ctor is too early
     virtual return_t ProcessEventData(const TEventData& recon, physics::manager_t& manager) =0;
     virtual void PopQueue() = 0;
 
+    /**
+     * @brief The state_t struct holds the current value of a processor
+     *
+     * Used by SlowControlManager::PopEpoch to make epochs independent
+     * of the processor's queue, which may already contain later values.
+     */
+    struct state_t {
+        virtual ~state_t() = default;
+    };
+    using StatePtr = std::shared_ptr<const state_t>;
+    using states_t = std::vector<std::pair<const Processor*, StatePtr>>;
+
+    /// adds the current values of this processor (or its members) to states, false if the queue is empty
+    virtual bool GetStates(states_t& states) const =0;
+
     class Exception : public std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
@@ -32,6 +54,18 @@ protected:
     // by default, the processor is in changed state
     // simplifies SlowControlManager for first completion
     bool hasChanged = true;
+
+    /// the state added by GetStates to the epoch active in this thread, nullptr if there is none
+    StatePtr GetEpochState() const;
+
+    // helper for processors consisting of several other processors
+    static bool CollectStates(states_t& states, std::initializer_list<const Processor*> processors) {
+        for(auto p : processors) {
+            if(!p->GetStates(states))
+                return false;
+        }
+        return true;
+    }
 };
 
 }}}
\ No newline at end of file
@@ -0,0 +1,389 @@
+#include "FileMerger.h"
+
+#include "tree/TAntHeader.h"
+#include "root-addons/analysis_codes/hstack.h"
+
+#include "base/Logger.h"
+#include "base/ProgressCounter.h"
+#include "base/ProcessPool.h"
+#include "base/tmpfile_t.h"
+#include "base/std_ext/memory.h"
+#include "base/std_ext/system.h"
+
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TKey.h"
+#include "TClass.h"
+#include "TH1.h"
+#include "TTree.h"
+
+#include <list>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+namespace {
+
+template<typename T>
+using unique_ptrs_t = vector<unique_ptr<T>>;
+
+template<typename T>
+struct pair_t {
+    explicit pair_t(const string& name) : Name(name) {}
+    string Name;
+    T Item;
+};
+
+template<typename C, typename... Args>
+void add_by_name(C& c, const string& name, Args&&... args) {
+    using T = typename C::value_type;
+    auto it = std::find_if(c.begin(), c.end(), [name] (const T& item) {
+        return item.Name == name;
+    });
+    if(it == c.end()) {
+        c.emplace_back(name);
+        c.back().Item.emplace_back(std::forward<Args>(args)...);
+    }
+    else {
+        it->Item.emplace_back(std::forward<Args>(args)...);
+    }
+}
+
+/**
+ * @brief Estimate the memory footprint of a mergeable object
+ * @param obj the object
+ * @return size in bytes, only histograms are considered relevant
+ */
+size_t EstimateBytes(const TObject& obj)
+{
+    auto h = dynamic_cast<const TH1*>(addressof(obj));
+    if(!h)
+        return 0;
+    // assume double precision bins, which overestimates for TH1F and friends
+    const size_t nArrays = h->GetSumw2N() > 0 ? 2 : 1;
+    return nArrays * h->GetNcells() * sizeof(double);
+}
+
+/**
+ * @brief Accumulate adds obj to acc and releases obj afterwards
+ * @param acc accumulator, takes ownership of obj if still empty
+ * @param obj the object to be added
+ */
+void Accumulate(unique_ptr<TObject>& acc, unique_ptr<TObject> obj)
+{
+    if(!acc) {
+        // detach histograms from their file, so that closing
+        // the file does not delete the accumulator
+        if(auto h = dynamic_cast<TH1*>(obj.get()))
+            h->SetDirectory(nullptr);
+        acc = move(obj);
+        return;
+    }
+
+    TList c;
+    c.Add(obj.get());
+
+    if(auto h = dynamic_cast<TH1*>(acc.get())) {
+        h->Add(dynamic_cast<TH1*>(obj.get()));
+    }
+    else if(auto s = dynamic_cast<hstack*>(acc.get())) {
+        s->Merge(addressof(c), nullptr);
+    }
+    else if(auto header = dynamic_cast<TAntHeader*>(acc.get())) {
+        header->Merge(addressof(c));
+    }
+}
+
+/**
+ * @brief The accumulators_t class keeps one accumulator per object name of a directory level
+ *
+ * Each added source object is released right after adding it to its accumulator.
+ * If a new accumulator would exceed the memory budget, the partial sums are
+ * merged into one running spill file in a temporary folder and the accumulation starts afresh.
+ */
+class accumulators_t {
+private:
+    const size_t memoryBudget;
+    const string spillParent;
+    vector<pair_t<unique_ptr<TObject>>> items;
+    vector<string> names; // ordered by first appearance, including spilled ones
+    size_t bytes = 0;
+    unique_ptr<tmpfolder_t> spillfolder;
+    unique_ptr<tmpfile_t> spill;
+
+    unique_ptr<TObject>& GetItem(const string& name) {
+        auto it = std::find_if(items.begin(), items.end(), [&name] (const pair_t<unique_ptr<TObject>>& item) {
+            return item.Name == name;
+        });
+        if(it != items.end())
+            return it->Item;
+        if(std::find(names.begin(), names.end(), name) == names.end())
+            names.emplace_back(name);
+        items.emplace_back(name);
+        return items.back().Item;
+    }
+
+    static unique_ptr<TFile> OpenSpill(const tmpfile_t& spill, const char* option) {
+        auto file = std_ext::make_unique<TFile>(spill.filename.c_str(), option);
+        if(file->IsZombie())
+            throw runtime_error("Cannot open spill file " + spill.filename);
+        return file;
+    }
+
+    /**
+     * @brief Merge the previous spill and the partial sums into target, one name at a time
+     * @param target the directory to write to
+     *
+     * The previous spill comes first, which keeps the order of the sources for hstacks and TAntHeader.
+     */
+    void MergeSpillAndItems(TDirectory& target) {
+        unique_ptr<TFile> spillfile;
+        if(spill)
+            spillfile = OpenSpill(*spill, "READ");
+        for(const auto& name : names) {
+            unique_ptr<TObject> acc;
+            if(spillfile) {
+                unique_ptr<TObject> obj(spillfile->Get(name.c_str()));
+                if(obj)
+                    Accumulate(acc, move(obj));
+            }
+            auto it_item = std::find_if(items.begin(), items.end(), [&name] (const pair_t<unique_ptr<TObject>>& item) {
+                return item.Name == name;
+            });
+            if(it_item != items.end() && it_item->Item)
+                Accumulate(acc, move(it_item->Item));
+            if(!acc)
+                continue;
+            target.WriteTObject(acc.get(), name.c_str());
+        }
+        items.clear();
+        bytes = 0;
+    }
+
+    void Spill() {
+        if(!spillfolder)
+            spillfolder = std_ext::make_unique<tmpfolder_t>(spillParent);
+        auto next_spill = std_ext::make_unique<tmpfile_t>(*spillfolder, ".root");
+        VLOG(3) << "Spilling " << items.size() << " partial sums (" << bytes/(1 << 20)
+                << " MB) to " << next_spill->filename;
+        {
+            // at most the previous and the next spill file are open
+            auto next_spillfile = OpenSpill(*next_spill, "RECREATE");
+            MergeSpillAndItems(*next_spillfile);
+            next_spillfile->Close();
+        }
+        // deletes the previous spill file
+        spill = move(next_spill);
+    }
+
+public:
+    accumulators_t(size_t memoryBudget_, const string& spillParent_) :
+        memoryBudget(memoryBudget_), spillParent(spillParent_) {}
+
+    void Add(const string& name, unique_ptr<TObject> obj) {
+        {
+            auto& acc = GetItem(name);
+            if(acc) {
+                // adding to an existing accumulator does not need more memory
+                Accumulate(acc, move(obj));
+                return;
+            }
+        }
+        // spill only the others, a single object exceeding the budget is kept anyway
+        const auto objBytes = EstimateBytes(*obj);
+        if(memoryBudget > 0 && bytes > 0 && bytes + objBytes > memoryBudget)
+            Spill();
+        bytes += objBytes;
+        Accumulate(GetItem(name), move(obj));
+    }
+
+    /**
+     * @brief Write the merged objects into target, one at a time
+     * @param target the output directory
+     */
+    void Write(TDirectory& target) {
+        MergeSpillAndItems(target);
+        names.clear();
+        spill = nullptr;
+        spillfolder = nullptr;
+    }
+};
+
+} // namespace
+
+void FileMerger::MergeRecursive(TDirectory& target, const sources_t& sources)
+{
+    nPaths++;
+    ProgressCounter::Tick();
+
+    vector<pair_t<sources_t>> dirs;
+    vector<pair_t<vector<TTree*>>> trees;
+    // spill next to the output file, like the partial results of MergeParallel
+    const auto file = target.GetFile();
+    accumulators_t accumulators(MemoryBudget, tmpfolder_t::ParentFor(file ? file->GetName() : ""));
+
+    for(auto& source : sources) {
+        TList* keys = source->GetListOfKeys();
+        if(!keys)
+            continue;
+
+        // first create a unique list of names,
+        // this prevents object with different cycles
+        TIter nextk(keys);
+        string prev_keyname;
+        while(auto key = dynamic_cast<TKey*>(nextk()))
+        {
+            const string keyname = key->GetName();
+            if(prev_keyname == keyname)
+                continue;
+            prev_keyname = keyname;
+
+            auto cl = TClass::GetClass(key->GetClassName());
+
+            if(cl->InheritsFrom(TDirectory::Class())) {
+                auto dir = dynamic_cast<TDirectory*>(key->ReadObj());
+                add_by_name(dirs, keyname, dir);
+            }
+            else if(cl->InheritsFrom(TH1::Class())
+                    || cl->InheritsFrom(hstack::Class())
+                    || cl->InheritsFrom(TAntHeader::Class())) {
+                // the source object is released right after adding it
+                accumulators.Add(keyname, unique_ptr<TObject>(key->ReadObj()));
+            }
+            else if(MergeTrees && cl->InheritsFrom(TTree::Class())) {
+                // owned by the source directory
+                add_by_name(trees, keyname, dynamic_cast<TTree*>(key->ReadObj()));
+            }
+        }
+    }
+
+    target.cd();
+    accumulators.Write(target);
+
+    for(const auto& it_trees : trees) {
+        TList l;
+        for(auto tree : it_trees.Item)
+            l.Add(tree);
+        // the merged tree is created in target and written
+        // together with the output file
+        target.cd();
+        if(!TTree::MergeTrees(addressof(l)))
+            LOG(WARNING) << "Could not merge trees " << target.GetPath() << "/" << it_trees.Name;
+    }
+
+    for(const auto& it_dirs : dirs) {
+        auto newdir = target.mkdir(it_dirs.Name.c_str());
+        MergeRecursive(*newdir, it_dirs.Item);
+    }
+}
+
+bool FileMerger::MergeFiles(const string& outputfilename, const vector<string>& inputfilenames)
+{
+    auto outputfile = std_ext::make_unique<TFile>(outputfilename.c_str(), "RECREATE");
+    if(outputfile->IsZombie()) {
+        LOG(ERROR) << "Cannot open output file " << outputfilename;
+        return false;
+    }
+
+    sources_t sources;
+    for(const auto& filename : inputfilenames) {
+        auto file = std_ext::make_unique<TFile>(filename.c_str(), "READ");
+        if(file->IsZombie()) {
+            LOG(ERROR) << "Cannot open input file " << filename;
+            return false;
+        }
+        sources.emplace_back(move(file));
+    }
+
+    MergeRecursive(*outputfile, sources);
+
+    VLOG(3) << "Writing file " << outputfile->GetName();
+    outputfile->Write();
+    return true;
+}
+
+bool FileMerger::MergeParallel(const string& outputfilename, const vector<string>& inputfilenames, unsigned nJobs)
+{
+    struct merge_task_t {
+        vector<string> Inputs;
+        string Output;
+    };
+
+    // the partial results are as large as the output, so keep them next to it
+    tmpfolder_t tmpfolder(tmpfolder_t::ParentFor(outputfilename));
+    list<tmpfile_t> tmpfiles;
+    vector<string> current = inputfilenames;
+    size_t groupsize = (current.size() + nJobs - 1)/nJobs;
+
+    unsigned level = 0;
+    while(true) {
+        const auto nGroups = (current.size() + groupsize - 1)/groupsize;
+
+        vector<merge_task_t> tasks;
+        vector<string> next_level;
+        for(size_t i=0;i<nGroups;i++) {
+            const auto begin = next(current.cbegin(), i*groupsize);
+            const auto end = next(current.cbegin(), min(current.size(), (i+1)*groupsize));
+            if(level > 0 && distance(begin, end) == 1) {
+                // single partial result, no need to merge it again
+                next_level.emplace_back(*begin);
+                continue;
+            }
+            merge_task_t task;
+            task.Inputs.assign(begin, end);
+            if(nGroups == 1) {
+                task.Output = outputfilename;
+            }
+            else {
+                tmpfiles.emplace_back(tmpfolder, ".root");
+                task.Output = tmpfiles.back().filename;
+            }
+            next_level.emplace_back(task.Output);
+            tasks.emplace_back(move(task));
+        }
+
+        LOG(INFO) << "Merge level " << level << ": " << current.size() << " files in " << tasks.size() << " merges";
+
+        const auto start = chrono::steady_clock::now();
+
+        // worker processes are used since ROOT's file I/O is not thread-safe,
+        // a failed merge simply recreates its output when retried
+        ProcessPool pool(nJobs);
+        double inputMB = 0;
+        for(const auto& task : tasks) {
+            double taskMB = 0;
+            for(const auto& input : task.Inputs)
+                taskMB += std_ext::system::getFileSizeMB(input);
+            pool.Add(task.Output, [this, task, taskMB] () {
+                // the fraction of the input read so far is shown by the parent,
+                // the byte counter was inherited and thus starts at some offset
+                ProgressCounter::Interval = 1;
+                const auto bytesRead_start = TFile::GetFileBytesRead();
+                ProgressCounter progress([bytesRead_start, taskMB] (chrono::duration<double>) {
+                    const double readMB = double(TFile::GetFileBytesRead() - bytesRead_start)/(1 << 20);
+                    ProcessPool::ReportProgress(taskMB > 0 ? readMB/taskMB : 0);
+                });
+                return MergeFiles(task.Output, task.Inputs);
+            });
+            inputMB += taskMB;
+        }
+
+        if(!pool.Wait())
+            return false;
+
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        LOG(INFO) << "Merge level " << level << " done, " << inputMB/elapsed.count() << " MB/s";
+
+        if(nGroups == 1)
+            return true;
+
+        current = move(next_level);
+        groupsize = 2;
+        level++;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+class TDirectory;
+
+namespace ant {
+namespace analysis {
+namespace utils {
+
+/**
+ * @brief The FileMerger class merges the output files of Ant, Ant-plot and friends
+ *
+ * Directories are merged recursively, histograms are added, hstacks and TAntHeaders are merged.
+ * Trees are copied entry by entry if MergeTrees is enabled, any other object is ignored.
+ * The order of the inputs is kept, which matters for hstacks and TAntHeader.
+ */
+class FileMerger {
+public:
+
+    /// memory budget in bytes for the accumulators of one directory level, 0 means unlimited
+    std::size_t MemoryBudget = 0;
+
+    /// copy the entries of all trees with the same path into one tree
+    bool MergeTrees = false;
+
+    using sources_t = std::vector<std::unique_ptr<const TDirectory>>;
+
+    void MergeRecursive(TDirectory& target, const sources_t& sources);
+
+    /**
+     * @brief MergeFiles merges all inputs into the output in one go
+     * @param outputfilename is recreated
+     * @param inputfilenames files to be merged
+     * @return true on success
+     */
+    bool MergeFiles(const std::string& outputfilename, const std::vector<std::string>& inputfilenames);
+
+    /**
+     * @brief MergeParallel performs a tree reduction over the input files
+     * @param outputfilename final output
+     * @param inputfilenames files to be merged
+     * @param nJobs number of concurrent worker processes
+     * @return true on success
+     *
+     * First, the inputs are split into nJobs contiguous groups, each merged into a temporary file.
+     * Then, the partial results are merged pairwise until only one remains.
+     * The partial results are kept in TMPDIR if set, otherwise next to the output.
+     * The workers report the fraction of their input read so far, which ProcessPool::Wait shows.
+     */
+    bool MergeParallel(const std::string& outputfilename, const std::vector<std::string>& inputfilenames,
+                       unsigned nJobs);
+
+    /// number of merged directories so far, for progress output
+    unsigned long long GetNPaths() const { return nPaths; }
+
+protected:
+    unsigned long long nPaths = 0;
+};
+
+}}} // namespace ant::analysis::utils
@@ -0,0 +1,255 @@
+#include "IMCombinatorics.h"
+#include "Combinatorics.h"
+
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+constexpr unsigned IMCombinatorics::MaxN;
+constexpr size_t IMCombinatorics::MaxCachedSubsets;
+
+void IMCombinatorics::Clear() noexcept
+{
+    E.clear();
+    Px.clear();
+    Py.clear();
+    Pz.clear();
+}
+
+void IMCombinatorics::Add(const LorentzVec& lv)
+{
+    E.push_back(lv.E);
+    Px.push_back(lv.p.x);
+    Py.push_back(lv.p.y);
+    Pz.push_back(lv.p.z);
+}
+
+namespace {
+
+inline double mass(double e, double px, double py, double pz) {
+    const double m2 = e*e - px*px - py*py - pz*pz;
+    return copysign(sqrt(abs(m2)), m2);
+}
+
+size_t nchoosek(unsigned n, unsigned k) {
+    size_t r = 1;
+    for(unsigned i=1;i<=k;i++)
+        r = r*(n-k+i)/i;
+    return r;
+}
+
+/**
+ * @brief The revolving_door_t class visits all k-subsets of n elements in revolving-door order
+ *
+ * This is Algorithm R of Knuth, TAOCP 7.2.1.3, which corresponds to the recursive definition
+ * R(n,k) = R(n-1,k), reversed R(n-1,k-1) with element n-1 added.
+ * Consecutive subsets differ by removing one element and adding another.
+ */
+class revolving_door_t {
+    using mask_t = IMCombinatorics::mask_t;
+    const unsigned n;
+    const unsigned t;
+    // c[1] < ... < c[t] are the elements of the subset, c[t+1] = c[t+2] = n
+    unsigned c[IMCombinatorics::MaxN+3];
+    mask_t mask = 0;
+
+    bool exchange(unsigned out, unsigned in, unsigned& out_, unsigned& in_) {
+        mask ^= (mask_t(1) << out) | (mask_t(1) << in);
+        out_ = out;
+        in_ = in;
+        return true;
+    }
+
+public:
+    revolving_door_t(unsigned n_, unsigned k) : n(n_), t(k) {
+        for(unsigned j=1;j<=t;j++) {
+            c[j] = j-1;
+            mask |= mask_t(1) << (j-1);
+        }
+        c[t+1] = n;
+        c[t+2] = n;
+    }
+
+    mask_t Mask() const { return mask; }
+
+    /// advance to the next subset, returns false if there is none
+    bool Next(unsigned& out, unsigned& in) {
+        if(t == 0 || t == n)
+            return false;
+
+        if(t == 1) {
+            if(c[1]+1 >= n)
+                return false;
+            c[1]++;
+            return exchange(c[1]-1, c[1], out, in);
+        }
+
+        // the easy case only moves the smallest element
+        if(t % 2 == 1 && c[1]+1 < c[2]) {
+            c[1]++;
+            return exchange(c[1]-1, c[1], out, in);
+        }
+        if(t % 2 == 0 && c[1] > 0) {
+            c[1]--;
+            return exchange(c[1]+1, c[1], out, in);
+        }
+
+        // otherwise, alternately try to decrease and increase c[j]
+        bool decrease = t % 2 == 1;
+        for(unsigned j=2;;j++, decrease = !decrease) {
+            if(decrease) {
+                // here c[j] = c[j-1]+1
+                if(c[j] >= j) {
+                    const auto removed = c[j];
+                    c[j] = c[j-1];
+                    c[j-1] = j-2;
+                    return exchange(removed, j-2, out, in);
+                }
+            }
+            else {
+                // here c[j-1] = j-2
+                if(c[j]+1 < c[j+1]) {
+                    c[j-1] = c[j];
+                    c[j]++;
+                    return exchange(j-2, c[j], out, in);
+                }
+                if(j+1 > t)
+                    return false;
+            }
+        }
+    }
+};
+
+}
+
+const IMCombinatorics::sequence_t* IMCombinatorics::GetSequence(unsigned n, unsigned k)
+{
+    if(sequences.size() > n && sequences[n].size() > k) {
+        // a built sequence contains at least one subset
+        const auto& seq = sequences[n][k];
+        if(!seq.Masks.empty())
+            return addressof(seq);
+    }
+
+    const auto nSubsets = nchoosek(n, k);
+    if(nCachedSubsets + nSubsets > MaxCachedSubsets)
+        return nullptr;
+
+    if(sequences.size() <= n)
+        sequences.resize(n+1);
+    auto& sequences_n = sequences[n];
+    if(sequences_n.size() <= k)
+        sequences_n.resize(k+1);
+    auto& seq = sequences_n[k];
+
+    revolving_door_t door(n, k);
+    seq.First = door.Mask();
+    seq.Masks.reserve(nSubsets);
+    seq.Steps.reserve(nSubsets-1);
+    seq.Masks.push_back(door.Mask());
+    unsigned out, in;
+    while(door.Next(out, in)) {
+        seq.Masks.push_back(door.Mask());
+        seq.Steps.push_back({uint8_t(out), uint8_t(in)});
+    }
+    nCachedSubsets += nSubsets;
+    return addressof(seq);
+}
+
+size_t IMCombinatorics::CalculateFromScratch(unsigned k)
+{
+    // the masks cannot represent the subsets
+    masks.clear();
+    im.clear();
+    vector<unsigned> indices(N());
+    iota(indices.begin(), indices.end(), 0);
+    for(auto comb = makeCombination(indices, k); !comb.done(); ++comb) {
+        double e = 0, px = 0, py = 0, pz = 0;
+        for(auto i : comb) {
+            e  += E[i];
+            px += Px[i];
+            py += Py[i];
+            pz += Pz[i];
+        }
+        im.push_back(mass(e, px, py, pz));
+    }
+    return im.size();
+}
+
+size_t IMCombinatorics::Calculate(unsigned k)
+{
+    lastCached = false;
+    const auto n = N();
+    if(k > n) {
+        im.clear();
+        masks.clear();
+        return 0;
+    }
+
+    if(n > MaxN)
+        return CalculateFromScratch(k);
+
+    const auto seq = GetSequence(n, k);
+    const auto nSubsets = seq ? seq->Masks.size() : nchoosek(n, k);
+
+    sumE.resize(nSubsets);
+    sumPx.resize(nSubsets);
+    sumPy.resize(nSubsets);
+    sumPz.resize(nSubsets);
+
+    // the first subset is summed up directly...
+    revolving_door_t door(n, k);
+    const auto first = door.Mask();
+    double e = 0, px = 0, py = 0, pz = 0;
+    for(unsigned i=0;i<n;i++) {
+        if(first & (mask_t(1) << i)) {
+            e  += E[i];
+            px += Px[i];
+            py += Py[i];
+            pz += Pz[i];
+        }
+    }
+    sumE[0]  = e;
+    sumPx[0] = px;
+    sumPy[0] = py;
+    sumPz[0] = pz;
+
+    // ...and all following ones are updated by exchanging one four-vector
+    auto exchange = [this, &e, &px, &py, &pz] (size_t i, unsigned out, unsigned in) {
+        e  += E[in]  - E[out];
+        px += Px[in] - Px[out];
+        py += Py[in] - Py[out];
+        pz += Pz[in] - Pz[out];
+        sumE[i]  = e;
+        sumPx[i] = px;
+        sumPy[i] = py;
+        sumPz[i] = pz;
+    };
+
+    if(seq) {
+        for(size_t i=0;i<seq->Steps.size();i++)
+            exchange(i+1, seq->Steps[i].Out, seq->Steps[i].In);
+        lastCached = true;
+        lastN = n;
+        lastK = k;
+    }
+    else {
+        masks.resize(nSubsets);
+        masks[0] = first;
+        unsigned out, in;
+        for(size_t i=1;door.Next(out, in);i++) {
+            exchange(i, out, in);
+            masks[i] = door.Mask();
+        }
+    }
+
+    im.resize(nSubsets);
+    for(size_t i=0;i<nSubsets;i++)
+        im[i] = mass(sumE[i], sumPx[i], sumPy[i], sumPz[i]);
+
+    return nSubsets;
+}
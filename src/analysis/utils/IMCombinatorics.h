@@ -0,0 +1,113 @@
+#pragma once
+
+#include "base/vec/LorentzVec.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace ant {
+namespace analysis {
+namespace utils {
+
+/**
+ * @brief IMCombinatorics calculates the invariant masses of all k-subsets of n four-vectors
+ *
+ * The four-vectors are stored as structure of arrays. The k-subsets are enumerated in
+ * revolving-door order (Knuth, TAOCP 7.2.1.3), where consecutive subsets differ
+ * by exchanging exactly one element. So each sum is obtained from the previous one
+ * by one subtraction and one addition instead of summing up k four-vectors again.
+ *
+ * The invariant masses are then calculated in one loop over contiguous arrays.
+ *
+ * Results are written to buffers owned by this class, which are reused
+ * for the next call of Calculate. Keep one instance around to avoid any allocation.
+ *
+ * The exchange steps only depend on n and k, so they are cached up to MaxCachedSubsets.
+ * Larger sequences are generated on the fly on every call, which is still free of recursion and allocation.
+ *
+ * @note The subsets are not in the lexicographic order of NchooseK,
+ * use Masks() to know which particles contributed to an invariant mass.
+ * For more than MaxN four-vectors, the subsets are summed up from scratch in the order
+ * of NchooseK instead, and no masks are provided.
+ */
+class IMCombinatorics {
+public:
+    /// bit i set means the i-th added four-vector is part of the subset
+    using mask_t = std::uint32_t;
+    static constexpr unsigned MaxN = 32;
+
+    /// at most that many subsets are kept in the sequence cache over all n and k
+    static constexpr std::size_t MaxCachedSubsets = 1 << 16;
+
+    void Clear() noexcept;
+
+    void Add(const LorentzVec& lv);
+
+    /**
+     * @brief Set replaces the four-vectors with the given list
+     * @param particles list of pointers to something convertible to LorentzVec, like TParticleList
+     */
+    template<typename List>
+    void Set(const List& particles) {
+        Clear();
+        for(const auto& p : particles)
+            Add(*p);
+    }
+
+    unsigned N() const noexcept { return unsigned(E.size()); }
+
+    /**
+     * @brief Calculate the invariant masses of all k-subsets
+     * @param k number of four-vectors in each subset
+     * @return the number of subsets, which is n choose k (0 if k>n)
+     */
+    std::size_t Calculate(unsigned k);
+
+    /// invariant masses of the last Calculate call, negative if the mass squared was negative
+    const std::vector<double>& IMs() const noexcept { return im; }
+
+    /// which four-vectors were summed up for the corresponding entry in IMs(), empty if N()>MaxN
+    const std::vector<mask_t>& Masks() const noexcept {
+        return lastCached ? sequences[lastN][lastK].Masks : masks;
+    }
+
+protected:
+
+    // the input four-vectors
+    std::vector<double> E, Px, Py, Pz;
+
+    // the sums of the current subsets
+    std::vector<double> sumE, sumPx, sumPy, sumPz;
+
+    std::vector<double> im;
+
+    // the masks of uncached sequences, otherwise Masks() refers to the cached ones
+    std::vector<mask_t> masks;
+    bool lastCached = false;
+    unsigned lastN = 0;
+    unsigned lastK = 0;
+
+    /// exchange one four-vector by another
+    struct step_t {
+        std::uint8_t Out;
+        std::uint8_t In;
+    };
+
+    /// the first subset and the steps to the following ones, depends only on n and k
+    struct sequence_t {
+        mask_t First = 0;
+        std::vector<mask_t> Masks;
+        std::vector<step_t> Steps;
+    };
+
+    /// sequences indexed by [n][k], built on first use as long as MaxCachedSubsets is not exceeded
+    std::vector<std::vector<sequence_t>> sequences;
+    std::size_t nCachedSubsets = 0;
+
+    /// nullptr if the sequence does not fit into the cache
+    const sequence_t* GetSequence(unsigned n, unsigned k);
+
+    std::size_t CalculateFromScratch(unsigned k);
+};
+
+}}} // namespace ant::analysis::utils
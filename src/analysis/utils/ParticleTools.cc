@@ -1,5 +1,6 @@
 #include "ParticleTools.h"
 #include "Combinatorics.h"
+#include "IMCombinatorics.h"
 
 #include "utils/ParticleID.h"
 
@@ -261,18 +262,21 @@ const TParticleList ParticleTools::FindParticles(const ParticleTypeDatabase::Typ
 
 void ParticleTools::FillIMCombinations(TH1* h, unsigned n, const TParticleList& particles)
 {
-    FillIMCombinations([h] (double x) {h->Fill(x);}, n, particles);
+    thread_local IMCombinatorics combinatorics;
+    combinatorics.Set(particles);
+    combinatorics.Calculate(n);
+    for(auto im : combinatorics.IMs())
+        h->Fill(im);
 }
 
 void ParticleTools::FillIMCombinations(std::function<void(double)> filler, unsigned n, const TParticleList& particles)
 {
-    for( auto comb = makeCombination(particles,n); !comb.done(); ++comb) {
-         LorentzVec sum({0,0,0},0);
-         for(const auto& p : comb) {
-             sum += *p;
-         }
-         filler(sum.M());
-    }
+    // keep the buffers around to avoid allocations
+    thread_local IMCombinatorics combinatorics;
+    combinatorics.Set(particles);
+    combinatorics.Calculate(n);
+    for(auto im : combinatorics.IMs())
+        filler(im);
 }
 
 bool ParticleTools::SortParticleByName(const TParticlePtr& a, const TParticlePtr& b)
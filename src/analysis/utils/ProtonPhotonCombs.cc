@@ -1,9 +1,53 @@
 #include "ProtonPhotonCombs.h"
 
+#include <numeric>
+#include <algorithm>
+#include <cassert>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
 
+constexpr unsigned ProtonPhotonCombs::MaxCandidates;
+
+namespace {
+
+// removes the combinations for which keep returns false,
+// without reallocating and in order, as keep may call the observer
+template<typename Keep>
+void keep_if(vector<ProtonPhotonCombs::comb_t>& combs, Keep keep) {
+    auto out = combs.begin();
+    for(auto it = combs.begin(); it != combs.end(); ++it) {
+        if(!keep(*it))
+            continue;
+        if(out != it)
+            *out = move(*it);
+        ++out;
+    }
+    combs.erase(out, combs.end());
+}
+
+// calls f(i) for each set bit i in ascending order
+template<typename F>
+void for_each_bit(ProtonPhotonCombs::mask_t mask, F f) {
+    while(mask) {
+        f(unsigned(__builtin_ctzll(mask)));
+        mask &= mask - 1;
+    }
+}
+
+}
+
+TParticleList ProtonPhotonCombs::comb_t::Photons() const
+{
+    TParticleList photons;
+    photons.reserve(NPhotons());
+    for_each_bit(PhotonMask, [this, &photons] (unsigned i) {
+        photons.emplace_back(particles->Photons[i]);
+    });
+    return photons;
+}
+
 ProtonPhotonCombs::Combinations_t&
 ProtonPhotonCombs::Combinations_t::Observe(const Observer_t& observer, const string& prefix) noexcept
 {
@@ -20,48 +64,46 @@ ProtonPhotonCombs::Combinations_t::Observe(const Observer_t& observer, const str
 ProtonPhotonCombs::Combinations_t&
 ProtonPhotonCombs::Combinations_t::FilterMult(unsigned nPhotonsRequired, double maxDiscardedEk) noexcept
 {
-    auto it = this->begin();
-    while(it != this->end()) {
-        const auto nPhotons = it->Photons.size();
-        if(nPhotons < nPhotonsRequired) {
-            it = this->erase(it);
-            continue;
-        }
-        // calc discarded Ek and do cu
-        it->DiscardedEk = 0;
-        for(auto i=nPhotonsRequired;i<nPhotons;i++) {
-            it->DiscardedEk += it->Photons[i]->Ek();
-        }
-        if(it->DiscardedEk >= maxDiscardedEk) {
-            it = this->erase(it);
-            continue;
-        }
+    keep_if(*this, [this, nPhotonsRequired, maxDiscardedEk] (comb_t& comb) {
+        if(comb.NPhotons() < nPhotonsRequired)
+            return false;
+        // calc discarded Ek and do cut,
+        // the photons beyond nPhotonsRequired have the lowest Ek
+        comb.DiscardedEk = 0;
+        mask_t kept = 0;
+        unsigned n = 0;
+        for_each_bit(comb.PhotonMask, [&comb, &kept, &n, nPhotonsRequired] (unsigned i) {
+            if(n++ < nPhotonsRequired)
+                kept |= mask_t(1) << i;
+            else
+                comb.DiscardedEk += comb.particles->PhotonsEk[i];
+        });
+        if(comb.DiscardedEk >= maxDiscardedEk)
+            return false;
         if(Observer && isfinite(maxDiscardedEk)) {
             Observer(std_ext::formatter() << ObserverPrefix << "DiscEk<" << maxDiscardedEk);
         }
-        it->Photons.resize(nPhotonsRequired); // will always shrink, as nPhotons >= nPhotonsRequired
-        ++it;
-    }
+        comb.PhotonMask = kept;
+        return true;
+    });
     return *this;
 }
 
 ProtonPhotonCombs::Combinations_t&
 ProtonPhotonCombs::Combinations_t::FilterIM(const IntervalD& photon_IM_sum_cut) noexcept
 {
-    auto it = this->begin();
-    while(it != this->end()) {
-        it->PhotonSum = LorentzVec{{0,0,0}, 0};
-        for(const auto& p : it->Photons)
-            it->PhotonSum += *p;
-        if(!photon_IM_sum_cut.Contains(it->PhotonSum.M())) {
-            it = this->erase(it);
-        }
-        else {
-            if(Observer && photon_IM_sum_cut != nocut)
-                Observer(ObserverPrefix+photon_IM_sum_cut.AsRangeString("IM(#gamma)"));
-            ++it;
-        }
-    }
+    keep_if(*this, [this, &photon_IM_sum_cut] (comb_t& comb) {
+        comb.PhotonSum = LorentzVec{{0,0,0}, 0};
+        const auto& lvs = comb.particles->PhotonLVs;
+        for_each_bit(comb.PhotonMask, [&comb, &lvs] (unsigned i) {
+            comb.PhotonSum += lvs[i];
+        });
+        if(!photon_IM_sum_cut.Contains(comb.PhotonSum.M()))
+            return false;
+        if(Observer && photon_IM_sum_cut != nocut)
+            Observer(ObserverPrefix+photon_IM_sum_cut.AsRangeString("IM(#gamma)"));
+        return true;
+    });
     called_FilterIM = true;
     return *this;
 }
@@ -75,52 +117,63 @@ ProtonPhotonCombs::Combinations_t::FilterMM(const TTaggerHit& taggerhit,
     if(!called_FilterIM)
         FilterIM();
 
-    auto it = this->begin();
     const auto beam_target = taggerhit.GetPhotonBeam() + LorentzVec::AtRest(target.Mass());
-    while(it != this->end()) {
+    keep_if(*this, [this, &missingmass_cut, &beam_target] (comb_t& comb) {
         // remember hit and cut on missing mass
-        it->MissingMass = (beam_target - it->PhotonSum).M();
-        if(!missingmass_cut.Contains(it->MissingMass))
-            it = this->erase(it);
-        else {
-            if(Observer && missingmass_cut != nocut)
-                // note that in A2's speech is often "missing mass of proton",
-                // but it's actually the "missing mass of photons" expected to be close to the
-                // rest mass of the proton
-                Observer(ObserverPrefix+missingmass_cut.AsRangeString("MM(#gamma)"));
-            ++it;
-        }
-    }
+        comb.MissingMass = (beam_target - comb.PhotonSum).M();
+        if(!missingmass_cut.Contains(comb.MissingMass))
+            return false;
+        if(Observer && missingmass_cut != nocut)
+            // note that in A2's speech is often "missing mass of proton",
+            // but it's actually the "missing mass of photons" expected to be close to the
+            // rest mass of the proton
+            Observer(ObserverPrefix+missingmass_cut.AsRangeString("MM(#gamma)"));
+        return true;
+    });
     return *this;
 }
 
 ProtonPhotonCombs::Combinations_t
 ProtonPhotonCombs::MakeCombinations(const TCandidateList& cands) noexcept
 {
-    TParticleList all_protons;
+    Combinations_t combs;
+    if(cands.size() > MaxCandidates)
+        return combs;
+
+    auto particles = std::make_shared<particles_t>();
+
     TParticleList all_photons;
     for(auto cand : cands.get_iter()) {
-        all_protons.emplace_back(std::make_shared<TParticle>(ParticleTypeDatabase::Proton, cand));
+        particles->Protons.emplace_back(std::make_shared<TParticle>(ParticleTypeDatabase::Proton, cand));
         all_photons.emplace_back(std::make_shared<TParticle>(ParticleTypeDatabase::Photon, cand));
     }
 
     // important for DiscardedEk cut later
-    std::sort(all_photons.begin(), all_photons.end(), [] (const TParticlePtr& a, const TParticlePtr& b) {
+    vector<unsigned> order(all_photons.size());
+    iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&all_photons] (unsigned a, unsigned b) {
         // sort by descending kinetic energy
-        return a->Ek() > b->Ek();
+        return all_photons[a]->Ek() > all_photons[b]->Ek();
     });
 
-    Combinations_t combs;
-    for(const auto& proton : all_protons) {
-        combs.emplace_back(proton);
-        auto& comb = combs.back();
-        for(auto photon : all_photons) {
-            if(photon->Candidate == proton->Candidate)
-                continue;
-            comb.Photons.emplace_back(photon);
-        }
-        assert(comb.Photons.size()+1 == all_photons.size());
+    // photon_index[i] is the index of the photon made from the i-th candidate
+    vector<unsigned> photon_index(order.size());
+    for(unsigned k=0;k<order.size();k++) {
+        const auto& photon = all_photons[order[k]];
+        particles->Photons.emplace_back(photon);
+        particles->PhotonsEk.emplace_back(photon->Ek());
+        particles->PhotonLVs.emplace_back(*photon);
+        photon_index[order[k]] = k;
+    }
+
+    const auto nPhotons = particles->Photons.size();
+    const mask_t all = nPhotons == MaxCandidates ? ~mask_t(0) : (mask_t(1) << nPhotons) - 1;
+
+    combs.reserve(particles->Protons.size());
+    for(unsigned i=0;i<particles->Protons.size();i++) {
+        // every candidate is the proton once, all others are photons
+        combs.emplace_back(particles, i, all & ~(mask_t(1) << photon_index[i]));
+        assert(combs.back().NPhotons()+1 == nPhotons);
     }
-    // as every candidate is the proton, it's only
     return combs;
 }
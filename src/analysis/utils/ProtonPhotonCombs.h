@@ -4,6 +4,9 @@
 #include "tree/TTaggerHit.h"
 
 #include <functional>
+#include <memory>
+#include <vector>
+#include <cstdint>
 
 namespace ant {
 namespace analysis {
@@ -14,30 +17,68 @@ constexpr IntervalD nocut{-std_ext::inf, std_ext::inf};
 
 /**
  * @brief The ProtonPhotonCombs struct provides convenient management of the proton/photons fitter loop
+ *
+ * The proton and photon particles are made once for all candidates and shared by all combinations.
+ * A combination only refers to them by index, so copying and filtering the combinations
+ * works on a flat vector without touching the particles.
  */
 struct ProtonPhotonCombs {
+
+    /// bit i set means the i-th photon (by descending Ek) belongs to the combination
+    using mask_t = std::uint64_t;
+    static constexpr unsigned MaxCandidates = 64;
+
+    /**
+     * @brief The particles_t struct holds the particles of all candidates, shared by the combinations
+     */
+    struct particles_t {
+        TParticleList Protons;          /// one for each candidate, in order of candidates
+        TParticleList Photons;          /// one for each candidate, sorted by descending Ek
+        std::vector<double> PhotonsEk;  /// same order as Photons
+        std::vector<LorentzVec> PhotonLVs;
+    };
+
     /**
      * @brief The comb_t struct holds the information of one particular proton/photons selection
      *
      * The fields TaggerHit/MissingMass/PhotonSum/DiscardedEk are set by the Combinations::Filter* methods
      */
     struct comb_t {
-        explicit comb_t(const TParticlePtr& proton) :
-            Proton(proton) {}
-        TParticleList Photons;
-        TParticlePtr  Proton;
+        comb_t(const std::shared_ptr<const particles_t>& particles_, unsigned proton_, mask_t photons_) :
+            PhotonMask(photons_), particles(particles_), proton(proton_) {}
+
+        mask_t PhotonMask;
+
+        const TParticlePtr& Proton() const { return particles->Protons[proton]; }
+
+        /// number of photons, without building them
+        unsigned NPhotons() const noexcept { return __builtin_popcountll(PhotonMask); }
+
+        /**
+         * @brief Photons materializes the photons of this combination
+         * @return list of photons, sorted by descending Ek
+         */
+        TParticleList Photons() const;
 
         double DiscardedEk{std_ext::NaN}; /// set by Combinations_t::FilterMult
         LorentzVec PhotonSum{{0,0,0},0};  /// set by Combinations_t::FilterIM
         double MissingMass{std_ext::NaN}; /// set by Combinations_t::FilterMM
+
+    private:
+        friend struct ProtonPhotonCombs;
+        std::shared_ptr<const particles_t> particles;
+        unsigned proton;
     };
 
     using Observer_t =  std::function<void(const std::string&)>;
 
     /**
      * @brief The Combinations_t struct manages the available proton/photon combinations as a whole
+     *
+     * The Filter* methods work in place, kicked out combinations are simply
+     * removed from the vector, which keeps the order of the remaining ones.
      */
-    struct Combinations_t : std::list<comb_t> {
+    struct Combinations_t : std::vector<comb_t> {
 
         /**
          * @brief Observe sets the filtering observer and an optional prefix,
@@ -92,7 +133,8 @@ struct ProtonPhotonCombs {
     /**
      * @brief ProtonPhotonCombs pre-builds the particle combinations from given candidates
      * @param cands typically pass event.Reconstructed().Candidates
-     * @note call only once per ProcessEvent to stay performant
+     * @note call only once per ProcessEvent to stay performant,
+     * no combinations are built for more than MaxCandidates candidates
      */
     ProtonPhotonCombs(const TCandidateList& cands) :
         Combinations(MakeCombinations(cands))
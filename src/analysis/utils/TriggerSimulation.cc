@@ -1,5 +1,7 @@
 #include "TriggerSimulation.h"
 
+#include "analysis/physics/manager_t.h"
+
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
 
@@ -7,9 +9,9 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
 
-bool TriggerSimulation::ProcessEvent(const TEvent& event)
+TriggerSimulation::info_t TriggerSimulation::Calculate(const TEvent& event)
 {
-    info.Reset();
+    info_t info;
 
     const auto& recon = event.Reconstructed();
 
@@ -59,10 +61,22 @@ bool TriggerSimulation::ProcessEvent(const TEvent& event)
     /// \todo The multiplicity is a much harder business, see acqu/root/src/TA2BasePhysics.cc
     /// the code there might only apply to the old trigger system before 2012
 
+    return info;
+}
+
+bool TriggerSimulation::ProcessEvent(const TEvent& event)
+{
+    info = Calculate(event);
     // return true if information is complete and sane
     return info.IsSane();
 }
 
+bool TriggerSimulation::ProcessEvent(const TEvent& event, physics::manager_t& manager)
+{
+    info = manager.GetTriggerSimulation(event);
+    return info.IsSane();
+}
+
 double TriggerSimulation::GetCorrectedTaggerTime(const TTaggerHit& taggerhit) const {
     return taggerhit.Time - GetRefTiming();
 }
@@ -8,9 +8,15 @@ struct TEvent;
 struct TTaggerHit;
 
 namespace analysis {
+
+namespace physics {
+struct manager_t;
+}
+
 namespace utils {
 
 class TriggerSimulation {
+public:
 
     struct info_t {
         bool   hasTriggered;
@@ -24,14 +30,21 @@ class TriggerSimulation {
             CBEnergySum = std_ext::NaN;
             CBTiming = std_ext::NaN;
         }
-        bool IsSane() {
+        bool IsSane() const {
             return std::isfinite(CBEnergySum) &&
                     std::isfinite(CBTiming);
         }
     };
 
-    info_t info;
+    /**
+     * @brief Calculate inspects the full event to tell the trigger decision
+     * @param event the event under investigation
+     * @return the trigger information, check it with IsSane()
+     */
+    static info_t Calculate(const TEvent& event);
 
+protected:
+    info_t info;
 
 public:
     /**
@@ -41,6 +54,15 @@ public:
      */
     bool ProcessEvent(const TEvent& event);
 
+    /**
+     * @brief ProcessEvent uses the trigger information cached by the manager,
+     * so that it's only calculated once per event for all physics classes
+     * @param event the event under investigation
+     * @param manager the manager of the current event
+     * @return true if successful, false on failure
+     */
+    bool ProcessEvent(const TEvent& event, physics::manager_t& manager);
+
     /**
      * @brief HasTriggered returns true if the experiment would have accepted this event
      * @return the trigger decision
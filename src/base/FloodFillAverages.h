@@ -4,71 +4,114 @@
 #include <limits>
 #include <algorithm>
 
-#include "base/std_ext/container.h"
-
 namespace ant {
 
-// suppose you have N elements
+/**
+ * @brief The FloodFillNeighbours struct stores the neighbours of N elements in one flat array
+ *
+ * The neighbours of element i are Indices[Offsets[i]] ... Indices[Offsets[i+1]-1],
+ * so they are looked up without allocating anything. Build it once from the detector
+ * and reuse it for each flood fill.
+ */
+struct FloodFillNeighbours {
+    std::vector<int> Offsets;
+    std::vector<int> Indices;
+
+    // getNeighbours = container of int-convertibles(int i)
+    template<typename GetNeighbours_t>
+    FloodFillNeighbours(int N, GetNeighbours_t getNeighbours) {
+        Offsets.reserve(N+1);
+        Offsets.push_back(0);
+        for(int i=0;i<N;i++) {
+            for(auto j : getNeighbours(i))
+                Indices.push_back(j);
+            Offsets.push_back(Indices.size());
+        }
+    }
+
+    int Size() const { return int(Offsets.size())-1; }
+    const int* begin(int i) const { return Indices.data()+Offsets[i]; }
+    const int* end(int i) const { return Indices.data()+Offsets[i+1]; }
+};
+
+// suppose you have N elements, with neighbours.Size()==N
 // getVal        = double(int i)
 // setVal        = void(int i, double newval)
-// getNeighbours = vector<int>(int i)
 // getValid      = bool(int i)
-template<typename GetVal_t, typename SetVal_t, typename GetNeighbours_t, typename GetValid_t>
-inline void floodFillAverages(int N, GetVal_t getVal, SetVal_t setVal,
-                              GetNeighbours_t getNeighbours, GetValid_t getValid)
+template<typename GetVal_t, typename SetVal_t, typename GetValid_t>
+inline void floodFillAverages(const FloodFillNeighbours& neighbours, GetVal_t getVal, SetVal_t setVal,
+                              GetValid_t getValid)
 {
+    const int N = neighbours.Size();
+
     struct invalid_t {
         int Index;
         explicit invalid_t(int i) : Index(i) {}
         int ValidNeighbours = 0;
-        std::vector<int> InvalidNeighbours;
-        double Value = std::numeric_limits<double>::quiet_NaN();
         bool Visited = false;
     };
 
     std::vector<invalid_t> invalids;
+    std::vector<char> valid(N);
+    for(int i=0;i<N;i++)
+        valid[i] = getValid(i);
+
+    // referrers[j] lists the invalids having the invalid j as neighbour,
+    // which get one more valid neighbour once j is set
+    std::vector<std::vector<int>> referrers(N);
 
     for(int i=0;i<N;i++) {
-        if(getValid(i))
+        if(valid[i])
             continue;
         invalids.emplace_back(i);
-        for(auto j : getNeighbours(i)) {
-            if(getValid(j))
+        for(auto it_j = neighbours.begin(i); it_j != neighbours.end(i); ++it_j) {
+            const int j = *it_j;
+            if(valid[j]) {
                 invalids.back().ValidNeighbours++;
-            else
-                invalids.back().InvalidNeighbours.push_back(j);
+            }
+            else if(j != i) {
+                auto& r = referrers[j];
+                if(std::find(r.begin(), r.end(), i) == r.end())
+                    r.push_back(i);
+            }
         }
     }
 
+    // values of already set invalids
+    std::vector<char> visited(N);
+    std::vector<double> visitedValues(N, std::numeric_limits<double>::quiet_NaN());
+
     // average calculation takes into account already set invalids
-    auto getAvg = [&invalids, getNeighbours, getVal, getValid] (int i) {
+    auto getAvg = [&neighbours, &valid, &visited, &visitedValues, getVal] (int i) {
         double sum = 0;
         int n = 0;
-        // average over valid neighbours
-        for(int j : getNeighbours(i)) {
-            if(getValid(j)) {
+        for(auto it_j = neighbours.begin(i); it_j != neighbours.end(i); ++it_j) {
+            const int j = *it_j;
+            // average over valid neighbours
+            if(valid[j]) {
                 sum += getVal(j);
                 n++;
             }
-            else {
-                // and possibly visited invalids
-                auto it = std::find_if(invalids.begin(), invalids.end(), [j] (const invalid_t& i) {
-                    return j == i.Index && i.Visited;
-                });
-                if(it != invalids.end()) {
-                    sum += it->Value;
-                    n++;
-                }
+            // and possibly visited invalids
+            else if(visited[j]) {
+                sum += visitedValues[j];
+                n++;
             }
         }
         return sum/n;
     };
 
+    // position of each invalid in the sorted invalids
+    std::vector<int> position(N, -1);
+
     while(true) {
         std::sort(invalids.begin(), invalids.end(),
                   [] (const invalid_t& a, const invalid_t& b) {
             return a.ValidNeighbours > b.ValidNeighbours;
         });
+        for(int k=0;k<int(invalids.size());k++)
+            position[invalids[k].Index] = k;
+
         // find the first unvisited item (if any left)
         // with the highest number of ValidNeighbours
         auto it = std::find_if(invalids.begin(), invalids.end(), [] (const invalid_t& i) {
@@ -91,25 +134,31 @@ inline void floodFillAverages(int N, GetVal_t getVal, SetVal_t setVal,
         for(const auto& it : unvisited) {
 
             // important to set the value for getAvg in next iteration
-            it->Value = getAvg(it->Index);
-            setVal(it->Index, it->Value);
-
-            // neighbour relatings might not be reflexive
-            // so we cannot iterate over getNeighbours(i.Index),
-            // but need to check if it->Index is neighbour of all other invalids
-            for(auto& invalid : invalids) {
-                if(invalid.Index == it->Index)
-                    continue;
-
-                if(std_ext::contains(invalid.InvalidNeighbours, it->Index)) {
-                    invalid.ValidNeighbours++;
-                }
-            }
+            const double value = getAvg(it->Index);
+            setVal(it->Index, value);
 
-            it->Visited = true;
+            // neighbour relatings might not be reflexive,
+            // so the referrers of it->Index are used instead of its neighbours
+            for(int j : referrers[it->Index])
+                invalids[position[j]].ValidNeighbours++;
 
+            visited[it->Index] = true;
+            visitedValues[it->Index] = value;
+            it->Visited = true;
         }
     }
 }
 
-}
\ No newline at end of file
+// suppose you have N elements
+// getVal        = double(int i)
+// setVal        = void(int i, double newval)
+// getNeighbours = vector<int>(int i)
+// getValid      = bool(int i)
+template<typename GetVal_t, typename SetVal_t, typename GetNeighbours_t, typename GetValid_t>
+inline void floodFillAverages(int N, GetVal_t getVal, SetVal_t setVal,
+                              GetNeighbours_t getNeighbours, GetValid_t getValid)
+{
+    floodFillAverages(FloodFillNeighbours(N, getNeighbours), getVal, setVal, getValid);
+}
+
+}
@@ -0,0 +1,302 @@
+#include "ProcessPool.h"
+
+#include "ProgressCounter.h"
+#include "Logger.h"
+#include "std_ext/string.h"
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace ant;
+
+// tells programs started by Exec where to report their progress
+constexpr auto progressFdEnv = "ANT_PROCESSPOOL_FD";
+
+// -2 means not yet looked up in the environment
+int ProcessPool::progressFd = -2;
+
+ProcessPool::ProcessPool(unsigned nJobs_, volatile bool* interrupt_) :
+    nJobs(max(nJobs_, 1u)),
+    interrupt(interrupt_)
+{
+}
+
+ProcessPool::~ProcessPool()
+{
+    // don't leave orphaned workers behind, for example if the parent failed with an exception
+    for(auto& t : tasks) {
+        if(t.State != state_t::Running)
+            continue;
+        kill(t.PID, SIGTERM);
+        int status;
+        waitpid(t.PID, addressof(status), 0);
+        close(t.ProgressFd);
+    }
+}
+
+unsigned ProcessPool::Add(const string& name, task_t task)
+{
+    tasks.emplace_back(name, move(task));
+    return GetNTasks()-1;
+}
+
+void ProcessPool::Prune()
+{
+    while(!tasks.empty()) {
+        const auto state = tasks.front().State;
+        if(state != state_t::Succeeded && state != state_t::Failed)
+            break;
+        if(state == state_t::Succeeded)
+            nPrunedSucceeded++;
+        nPruned++;
+        tasks.pop_front();
+    }
+}
+
+const ProcessPool::task_item_t& ProcessPool::at(unsigned index) const
+{
+    if(index < nPruned)
+        throw Exception(std_ext::formatter() << "Task " << index << " was already pruned");
+    return tasks.at(index - nPruned);
+}
+
+void ProcessPool::start(task_item_t& t)
+{
+    int fds[2];
+    if(pipe(fds) != 0)
+        throw Exception(std_ext::formatter() << "Cannot create progress pipe: " << strerror(errno));
+    // a slow parent must not block the worker
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    // otherwise buffered output appears twice
+    cout.flush();
+    cerr.flush();
+
+    const auto pid = fork();
+    if(pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw Exception(std_ext::formatter() << "Cannot fork worker process: " << strerror(errno));
+    }
+
+    if(pid == 0) {
+        // worker process, never return from here
+        close(fds[0]);
+        progressFd = fds[1];
+        setenv(progressFdEnv, to_string(progressFd).c_str(), 1);
+        bool ok = false;
+        try {
+            ok = t.Task();
+        }
+        catch(const exception& e) {
+            LOG(ERROR) << "Exception in task " << t.Name << ": " << e.what();
+        }
+        cout.flush();
+        cerr.flush();
+        // skips the cleanup of the inherited state, such as writing the parent's open files
+        _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    t.PID = pid;
+    t.ProgressFd = fds[0];
+    t.Progress = 0;
+    t.State = state_t::Running;
+    t.Attempts++;
+    VLOG(3) << "Started task " << t.Name << " as process " << pid << ", attempt " << t.Attempts;
+}
+
+void ProcessPool::readProgress(task_item_t& t)
+{
+    // each report is written at once, so only complete values are read
+    double buf[64];
+    ssize_t n;
+    while((n = read(t.ProgressFd, buf, sizeof(buf))) > 0) {
+        const auto nValues = n/sizeof(double);
+        if(nValues > 0)
+            t.Progress = min(max(buf[nValues-1], 0.0), 1.0);
+    }
+}
+
+void ProcessPool::finished(task_item_t& t, int status)
+{
+    readProgress(t);
+    close(t.ProgressFd);
+    t.ProgressFd = -1;
+    t.PID = 0;
+
+    if(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+        t.State = state_t::Succeeded;
+        t.Progress = 1;
+        VLOG(3) << "Task " << t.Name << " succeeded";
+        return;
+    }
+
+    std_ext::formatter reason;
+    if(WIFSIGNALED(status))
+        reason << "killed by signal " << WTERMSIG(status);
+    else
+        reason << "exit status " << WEXITSTATUS(status);
+
+    t.Progress = 0;
+    if(t.Attempts <= MaxRetries && !interrupted) {
+        LOG(WARNING) << "Task " << t.Name << " failed (" << reason.str() << "), retrying";
+        t.State = state_t::Pending;
+    }
+    else {
+        LOG(ERROR) << "Task " << t.Name << " failed (" << reason.str() << ") after "
+                   << t.Attempts << " attempts";
+        t.State = state_t::Failed;
+    }
+}
+
+bool ProcessPool::Poll()
+{
+    if(interrupt && *interrupt && !interrupted) {
+        interrupted = true;
+        LOG(WARNING) << "Interrupted, waiting for " << GetNRunning() << " running workers";
+        for(auto& t : tasks) {
+            if(t.State == state_t::Running)
+                kill(t.PID, SIGINT);
+        }
+    }
+
+    for(auto& t : tasks) {
+        if(t.State != state_t::Running)
+            continue;
+        readProgress(t);
+        int status;
+        const auto pid = waitpid(t.PID, addressof(status), WNOHANG);
+        if(pid == 0)
+            continue;
+        if(pid < 0)
+            throw Exception(std_ext::formatter() << "Waiting for worker process failed: " << strerror(errno));
+        finished(t, status);
+    }
+
+    // start in order of adding, retried tasks first
+    unsigned nRunning = GetNRunning();
+    for(auto& t : tasks) {
+        if(t.State != state_t::Pending)
+            continue;
+        if(interrupted) {
+            t.State = state_t::Failed;
+            continue;
+        }
+        if(nRunning >= nJobs)
+            break;
+        start(t);
+        nRunning++;
+    }
+
+    return any_of(tasks.begin(), tasks.end(), [] (const task_item_t& t) {
+        return t.State == state_t::Pending || t.State == state_t::Running;
+    });
+}
+
+bool ProcessPool::Wait()
+{
+    double last_progress = GetProgress();
+    ProgressCounter progress(
+                [this, &last_progress]
+                (std::chrono::duration<double> elapsed)
+    {
+        // workers started while waiting inherit this counter, but must stay quiet
+        if(progressFd >= 0)
+            return;
+        const double percent = GetProgress();
+        const double speed = (percent - last_progress)/elapsed.count();
+        LOG(INFO) << GetNSucceeded() << "/" << GetNTasks() << " tasks done, "
+                  << GetNRunning() << " running, "
+                  << setw(2) << std::setprecision(4) << percent*100 << " % done, ETA: "
+                  << ProgressCounter::TimeToStr((1-percent)/speed);
+        last_progress = percent;
+    });
+
+    while(Poll()) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        ProgressCounter::Tick();
+    }
+
+    return GetNSucceeded() == GetNTasks();
+}
+
+unsigned ProcessPool::GetNRunning() const
+{
+    return count_if(tasks.begin(), tasks.end(), [] (const task_item_t& t) {
+        return t.State == state_t::Running;
+    });
+}
+
+unsigned ProcessPool::GetNSucceeded() const
+{
+    return nPrunedSucceeded + count_if(tasks.begin(), tasks.end(), [] (const task_item_t& t) {
+        return t.State == state_t::Succeeded;
+    });
+}
+
+bool ProcessPool::Succeeded(unsigned index) const
+{
+    return at(index).State == state_t::Succeeded;
+}
+
+bool ProcessPool::Finished(unsigned index) const
+{
+    const auto state = at(index).State;
+    return state == state_t::Succeeded || state == state_t::Failed;
+}
+
+double ProcessPool::GetProgress() const
+{
+    if(GetNTasks() == 0)
+        return 1;
+    double sum = nPrunedSucceeded;
+    for(const auto& t : tasks) {
+        if(t.State == state_t::Succeeded || t.State == state_t::Running)
+            sum += t.Progress;
+    }
+    return sum/GetNTasks();
+}
+
+ProcessPool::task_t ProcessPool::Exec(const vector<string>& args)
+{
+    return [args] () {
+        if(args.empty())
+            return false;
+        vector<char*> argv;
+        for(const auto& arg : args)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+        execv(argv.front(), argv.data());
+        LOG(ERROR) << "Cannot execute " << args.front() << ": " << strerror(errno);
+        return false;
+    };
+}
+
+bool ProcessPool::ReportProgress(double fraction)
+{
+    if(progressFd == -2) {
+        const auto env = getenv(progressFdEnv);
+        progressFd = env ? atoi(env) : -1;
+    }
+    if(progressFd < 0)
+        return false;
+    // if the pipe is full, this report is simply dropped
+    if(write(progressFd, addressof(fraction), sizeof(fraction)) < 0 && errno != EAGAIN)
+        LOG_N_TIMES(1, WARNING) << "Cannot report progress: " << strerror(errno);
+    return true;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdexcept>
+
+#include <sys/types.h>
+
+namespace ant {
+
+/**
+ * @brief The ProcessPool class runs tasks in forked worker processes
+ *
+ * ROOT is not thread-safe, so parallelism is achieved with processes instead.
+ * Each task runs in its own forked worker, which exits with the result of the task.
+ * Failed tasks are started again, so tasks should only depend on their own inputs
+ * and recreate their outputs, which makes the results independent of the scheduling.
+ * Workers can report their progress with ReportProgress, which is sent over a pipe
+ * to the parent and shown by its ProgressCounter.
+ */
+class ProcessPool {
+public:
+    /// runs in the worker process, return true on success
+    using task_t = std::function<bool()>;
+
+    /**
+     * @brief ProcessPool
+     * @param nJobs number of concurrently running workers
+     * @param interrupt if set, no further tasks are started and the running ones are interrupted
+     */
+    explicit ProcessPool(unsigned nJobs, volatile bool* interrupt = nullptr);
+    ~ProcessPool();
+
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+
+    /// how often a failed task is started again
+    unsigned MaxRetries = 2;
+
+    /**
+     * @brief Add schedules a task, which is started by the next Poll or Wait
+     * @param name used for logging
+     * @param task the work to be done
+     * @return index of the task
+     */
+    unsigned Add(const std::string& name, task_t task);
+
+    /**
+     * @brief Poll collects finished workers, retries failed tasks and starts pending ones without blocking
+     * @return true if tasks are still pending or running
+     */
+    bool Poll();
+
+    /**
+     * @brief Wait polls until all tasks are done
+     * @return true if all tasks finally succeeded
+     */
+    bool Wait();
+
+    /**
+     * @brief Prune forgets the finished tasks added before any unfinished one
+     *
+     * Keeps long-living pools, which add tasks over time, small and fast to poll.
+     * The indices of forgotten tasks must not be used anymore, all others stay valid.
+     */
+    void Prune();
+
+    unsigned GetNTasks() const { return nPruned + tasks.size(); }
+    unsigned GetNRunning() const;
+    unsigned GetNSucceeded() const;
+    bool Succeeded(unsigned index) const;
+    /// true if the task succeeded or finally failed
+    bool Finished(unsigned index) const;
+
+    /// fraction of all work done, including reported progress of running tasks
+    double GetProgress() const;
+
+    /**
+     * @brief Exec makes a task replacing the worker with the given program
+     * @param args the program and its arguments
+     * @return the task, which only returns if the program could not be started
+     *
+     * The progress pipe stays open, so the program can still use ReportProgress.
+     */
+    static task_t Exec(const std::vector<std::string>& args);
+
+    /**
+     * @brief ReportProgress sends the progress of the current worker to the parent
+     * @param fraction between 0 and 1
+     * @return true if running as worker of a ProcessPool
+     */
+    static bool ReportProgress(double fraction);
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+protected:
+    enum class state_t { Pending, Running, Succeeded, Failed };
+
+    struct task_item_t {
+        task_item_t(const std::string& name, task_t task) :
+            Name(name), Task(std::move(task)) {}
+        std::string Name;
+        task_t      Task;
+        state_t     State = state_t::Pending;
+        unsigned    Attempts = 0;
+        pid_t       PID = 0;
+        int         ProgressFd = -1;
+        double      Progress = 0;
+    };
+
+    const unsigned nJobs;
+    volatile bool* interrupt;
+    bool interrupted = false;
+    std::deque<task_item_t> tasks;
+    unsigned nPruned = 0;
+    unsigned nPrunedSucceeded = 0;
+
+    const task_item_t& at(unsigned index) const;
+
+    void start(task_item_t& t);
+    void readProgress(task_item_t& t);
+    void finished(task_item_t& t, int status);
+
+    static int progressFd;
+};
+
+}
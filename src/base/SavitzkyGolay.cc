@@ -27,6 +27,10 @@ SavitzkyGolay::SavitzkyGolay(int window_left, int window_right, int polynom_orde
     m(polynom_order),
     h(MakeH(n_l,n_r,m))
 {
+    const auto points = n_l + n_r + 1;
+    coefficients.reserve(points);
+    for(int k = 0; k < points; k++)
+        coefficients.push_back(gsl_matrix_get(h, n_l, k));
 }
 
 SavitzkyGolay::gsl_unique_ptr<SavitzkyGolay::gsl_matrix> SavitzkyGolay::MakeH(int n_l, int n_r, int m)
@@ -108,13 +112,40 @@ vector<double> SavitzkyGolay::Smooth(const vector<double>& y) const
     for (int i = 0; i < d_n; i++){
         double convolution = 0.0;
         for (int k = 0; k < points; k++)
-            convolution += gsl_matrix_get(h, n_l, k) * get_y(i - n_l + k);
+            convolution += coefficients[k] * get_y(i - n_l + k);
         result[i] = convolution;
     }
 
     return result;
 }
 
+vector<double> SavitzkyGolay::Smooth(const vector<double>& y, unsigned nSeries) const
+{
+    if(nSeries == 0 || y.size() % nSeries != 0)
+        throw Exception(std_ext::formatter() << "Size " << y.size() << " is not a multiple of number of series " << nSeries);
+
+    const int points = n_l + n_r + 1;
+    const int d_n = y.size()/nSeries;
+    const interval<int> range(0, d_n-1);
+
+    vector<double> result(y.size(), 0.0);
+    for (int i = 0; i < d_n; i++) {
+        double* r = addressof(result[i*nSeries]);
+        for (int k = 0; k < points; k++) {
+            // mirror the input at the edges as in Smooth above
+            const int j = Mirror(i - n_l + k, range);
+            if(j < 0 || j >= d_n)
+                throw Exception(std_ext::formatter() << "Too few points " << d_n << " for window size " << points);
+            const double c = coefficients[k];
+            const double* y_j = addressof(y[j*nSeries]);
+            for (unsigned s = 0; s < nSeries; s++)
+                r[s] += c * y_j[s];
+        }
+    }
+
+    return result;
+}
+
 double SavitzkyGolay::gsl_matrix_get(const gsl_matrix* m, const size_t i, const size_t j)
 {
     return ::gsl_matrix_get(m, i, j);
@@ -4,6 +4,8 @@
 
 #include <memory>
 #include <vector>
+#include <functional>
+#include <stdexcept>
 
 namespace ant {
 
@@ -15,6 +17,17 @@ struct SavitzkyGolay {
 
     std::vector<double> Smooth(const std::vector<double>& y) const;
 
+    /**
+     * @brief Smooth many series of the same length at once
+     * @param y the n points of nSeries series, point i of series s is y[i*nSeries+s]
+     * @param nSeries number of series, for example channels
+     * @return smoothed series in the same layout
+     *
+     * The series are processed side by side, so the inner loop runs over contiguous memory.
+     * Used to smooth all channels across all ranges in one go.
+     */
+    std::vector<double> Smooth(const std::vector<double>& y, unsigned nSeries) const;
+
     template<typename GetY, typename SetY>
     void Convolute(const GetY& getY, const SetY& setY,
                    const interval<int>& range) const
@@ -22,19 +35,26 @@ struct SavitzkyGolay {
         double convolution = 0.0;
         const auto points = n_l + n_r + 1;
         for (int k = 0; k < points; k++) {
-            auto i = k - n_l; // i runs from -n_l to n_r (inclusive), -n_l <= i <= n_r
-
-            // do some wrap around to keep it in range
-            if(i<range.Start())
-                i = range.Start() + (range.Start() - i);
-            else if(i>range.Stop())
-                i = range.Stop()  - (i - range.Stop() );
-
-            convolution += gsl_matrix_get(h, n_l, k) * getY(i);
+            // i runs from -n_l to n_r (inclusive), -n_l <= i <= n_r
+            convolution += coefficients[k] * getY(Mirror(k - n_l, range));
         }
         setY(convolution); // implicitly assume i=0
     }
 
+    /// coefficients of the points -n_l...n_r around the smoothed point
+    const std::vector<double>& GetCoefficients() const { return coefficients; }
+    int GetWindowLeft() const { return n_l; }
+    int GetWindowRight() const { return n_r; }
+
+    /// do some wrap around to keep i in range
+    static int Mirror(int i, const interval<int>& range) {
+        if(i<range.Start())
+            return range.Start() + (range.Start() - i);
+        if(i>range.Stop())
+            return range.Stop()  - (i - range.Stop() );
+        return i;
+    }
+
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error;
     };
@@ -56,7 +76,10 @@ protected:
     const gsl_unique_ptr<gsl_matrix> h;
     static gsl_unique_ptr<gsl_matrix> MakeH(int n_l, int n_r, int m);
 
-    // define wrapper for above templated Convolute method
+    // row n_l of h, as only the smoothed value at i=0 is needed
+    std::vector<double> coefficients;
+
+    // wrapper for the forward declared gsl_matrix
     static double gsl_matrix_get(const gsl_matrix* m, const size_t i, const size_t j);
 };
 
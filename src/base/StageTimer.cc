@@ -0,0 +1,54 @@
+#include "StageTimer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+
+constexpr unsigned StageTimer::BinsPerOctave;
+constexpr int StageTimer::MinExponent;
+constexpr unsigned StageTimer::nBins;
+
+bool StageTimer::Enabled = true;
+StageTimer::registry_t StageTimer::registry;
+
+StageTimer::StageTimer(const string& name) :
+    Name(name)
+{
+    registry.push_back(this);
+}
+
+StageTimer::~StageTimer()
+{
+    auto it = std::find(registry.begin(), registry.end(), this);
+    registry.erase(it);
+}
+
+// the bins split each octave linearly,
+// which is cheap to compute from the bit representation
+constexpr unsigned subBits = 2;
+static_assert((1u << subBits) == StageTimer::BinsPerOctave, "BinsPerOctave must match subBits");
+
+double StageTimer::GetBinEdge(unsigned bin)
+{
+    const auto octave = MinExponent + int(bin/BinsPerOctave);
+    const auto sub = bin % BinsPerOctave;
+    return ldexp(1.0 + double(sub)/BinsPerOctave, octave)*1e-9;
+}
+
+void StageTimer::Add(clock_t::duration elapsed)
+{
+    Total += elapsed;
+    Calls++;
+
+    const auto ns = chrono::duration_cast<chrono::nanoseconds>(elapsed).count();
+    unsigned bin = 0;
+    if(ns >= (1 << MinExponent)) {
+        const auto u = static_cast<unsigned long long>(ns);
+        const int octave = 63 - __builtin_clzll(u);
+        const unsigned sub = (u >> (octave - subBits)) & (BinsPerOctave-1);
+        bin = std::min((octave - MinExponent)*BinsPerOctave + sub, nBins-1);
+    }
+    Histogram[bin]++;
+}
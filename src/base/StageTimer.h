@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <list>
+#include <array>
+#include <cstdint>
+
+namespace ant {
+
+/**
+ * @brief The StageTimer struct measures the time spent in a processing stage
+ *
+ * Each measured scope adds its duration to the total and to a histogram
+ * with logarithmic binning. Timers register themselves, so the PhysicsManager
+ * can report all stages, even if they live in the readers.
+ */
+struct StageTimer {
+
+    using clock_t = std::chrono::steady_clock;
+
+    explicit StageTimer(const std::string& name);
+    ~StageTimer();
+
+    // registered by address, so not copyable
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    const std::string Name;
+
+    /// summed durations of all measured scopes
+    std::chrono::duration<double> Total{0};
+    std::uint64_t Calls = 0;
+
+    /// number of bins per factor two in duration histogram, linear within each factor two
+    static constexpr unsigned BinsPerOctave = 4;
+    /// lower edge of first bin is 2^MinExponent nanoseconds
+    static constexpr int MinExponent = 6;
+    static constexpr unsigned nBins = 26*BinsPerOctave;
+
+    /// counts per duration bin, under/overflow go into first/last bin
+    std::array<std::uint64_t, nBins> Histogram{};
+
+    /// lower edge of bin in seconds, bin nBins gives the upper edge of last bin
+    static double GetBinEdge(unsigned bin);
+
+    void Add(clock_t::duration elapsed);
+
+    struct scope_t {
+        explicit scope_t(StageTimer& timer) :
+            Timer(timer),
+            Start(Enabled ? clock_t::now() : clock_t::time_point())
+        {}
+        scope_t(const scope_t&) = delete;
+        scope_t& operator=(const scope_t&) = delete;
+        ~scope_t() {
+            if(Enabled)
+                Timer.Add(clock_t::now() - Start);
+        }
+    private:
+        StageTimer& Timer;
+        const clock_t::time_point Start;
+    };
+
+    /**
+     * @brief The sum_t struct adds several scopes up and records them as one call
+     *
+     * Use it for stages which are interrupted by other stages,
+     * so that each event is still counted once in the histogram.
+     */
+    struct sum_t {
+        explicit sum_t(StageTimer& timer) : Timer(timer) {}
+        sum_t(const sum_t&) = delete;
+        sum_t& operator=(const sum_t&) = delete;
+        ~sum_t() {
+            if(Enabled)
+                Timer.Add(Elapsed);
+        }
+
+        struct scope_t {
+            explicit scope_t(sum_t& sum) :
+                Sum(sum),
+                Start(Enabled ? clock_t::now() : clock_t::time_point())
+            {}
+            scope_t(const scope_t&) = delete;
+            scope_t& operator=(const scope_t&) = delete;
+            ~scope_t() {
+                if(Enabled)
+                    Sum.Elapsed += clock_t::now() - Start;
+            }
+        private:
+            sum_t& Sum;
+            const clock_t::time_point Start;
+        };
+
+    private:
+        StageTimer& Timer;
+        clock_t::duration Elapsed{0};
+    };
+
+    /// timing costs two clock reads per scope, disable it if that's still too much
+    static bool Enabled;
+
+    using registry_t = std::list<const StageTimer*>;
+    static const registry_t& GetAll() { return registry; }
+
+protected:
+    static registry_t registry;
+};
+
+}
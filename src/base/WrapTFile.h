@@ -34,9 +34,11 @@ protected:
     std::unique_ptr<TFile> openFile(const std::string& filename, const std::string mode);
     WrapTFile(); // cannot be directly constructed, use WrapTFileInput or WrapTFileOutput
 
-    static bool hasROOTmagic(const std::string& filename);
 public:
 
+    /// check for the ROOT file signature without asking ROOT
+    static bool hasROOTmagic(const std::string& filename);
+
     /**
      * @brief Traverse applies given function to each leaf in the tree of TDirectory
      * @param func use TKey to inspect anything of that object
@@ -124,6 +124,14 @@ bool ant::std_ext::system::path_exists(const string& path) {
     return 0 == lstat(path.c_str(), &lbuf);
 }
 
+double system::getFileSizeMB(const string& filename)
+{
+    struct stat buf;
+    if(stat(filename.c_str(), &buf) != 0)
+        return 0;
+    return double(buf.st_size)/(1 << 20);
+}
+
 bool system::testopen(const string& filename)
 {
     string errmsg;
@@ -78,6 +78,12 @@ struct system {
      */
     static bool path_exists(const std::string& path);
 
+    /**
+     * @brief getFileSizeMB determines the size of a file
+     * @param filename
+     * @return size in MiB, zero if the file cannot be accessed
+     */
+    static double getFileSizeMB(const std::string& filename);
 
 };
 }
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <unistd.h>
 #include <stdexcept>
 #include <iterator>
 #include <fstream>
@@ -19,8 +20,11 @@ tmpfile_t::tmpfile_t() : filename(), testdata()
   // obtain some random filename
   char filename_[128];
   strcpy(filename_, "anttmpfile.XXXXXX");
-  if(mkstemp(filename_) == -1)
+  const int fd = mkstemp(filename_);
+  if(fd == -1)
     throw runtime_error("Cannot create tmpfile");
+  // only the name is needed, users open the file themselves
+  close(fd);
   filename = filename_;
 }
 
@@ -47,16 +51,34 @@ tmpfile_t::~tmpfile_t() {
 }
 
 
-tmpfolder_t::tmpfolder_t()
+tmpfolder_t::tmpfolder_t() : tmpfolder_t(".")
+{
+}
+
+tmpfolder_t::tmpfolder_t(const string& parent)
 {
     // obtain some random foldername
-    char foldername_[128];
-    strcpy(foldername_, "anttmpfile.XXXXXX");
-    if(mkdtemp(foldername_) == NULL)
-      throw runtime_error("Cannot create tmpfolder");
+    string foldername_ = parent + "/anttmpfile.XXXXXX";
+    if(mkdtemp(&foldername_[0]) == NULL)
+      throw runtime_error("Cannot create tmpfolder in "+parent);
     foldername = foldername_;
 }
 
+string tmpfolder_t::ParentFor(const string& outputfile)
+{
+    const auto tmpdir = getenv("TMPDIR");
+    if(tmpdir && *tmpdir)
+        return tmpdir;
+    if(outputfile.empty())
+        return P_tmpdir;
+    const auto pos = outputfile.find_last_of('/');
+    if(pos == outputfile.npos)
+        return ".";
+    if(pos == 0)
+        return "/";
+    return outputfile.substr(0, pos);
+}
+
 tmpfolder_t::~tmpfolder_t()
 {
     stringstream cmd;
@@ -11,9 +11,21 @@ namespace ant {
  */
 struct tmpfolder_t {
     std::string foldername;
+    /// creates the folder in the current working directory
     tmpfolder_t();
+    /// creates the folder inside the existing directory parent
+    explicit tmpfolder_t(const std::string& parent);
     ~tmpfolder_t();
 
+    /**
+     * @brief ParentFor chooses the place for intermediate files of some output file
+     * @param outputfile the final output, which may be empty
+     * @return TMPDIR if set, otherwise the directory of outputfile, or the system's default if empty
+     *
+     * Unlike the current working directory, both are expected to be writable.
+     */
+    static std::string ParentFor(const std::string& outputfile);
+
     // make it movable only, as the tmpfolder deletes its directory in dtor
     tmpfolder_t(tmpfolder_t&&) = default;
     tmpfolder_t(const tmpfolder_t&) = delete;
@@ -24,19 +24,41 @@ TF1* gaus::getTF1()
     return helper::makeTF1(fct, 3); // new TF1("",fct,0,1,3);
 }
 
-double timewalk::fct(double* x, double* p)
+namespace {
+double timewalk_value(double x, const double* p)
 {
-    const auto x_shift = x[0]-p[p::E0];
+    using p_t = timewalk::p;
+    const auto x_shift = x-p[p_t::E0];
     if(x_shift<=0)
         return 0;
     // using exp and not pow is really needed for numeric stability
-    return p[p::Offset] + p[p::Slope]*x_shift +
-            p[p::Scale]*std::exp(-p[p::Exp]*x_shift - p[p::Pow]*std::log(x_shift));
+    return p[p_t::Offset] + p[p_t::Slope]*x_shift +
+            p[p_t::Scale]*std::exp(-p[p_t::Exp]*x_shift - p[p_t::Pow]*std::log(x_shift));
+}
+}
+
+double timewalk::fct(double* x, double* p)
+{
+    return timewalk_value(x[0], p);
+}
+
+double timewalk::Eval(double x, double x_min, const double* p)
+{
+    // make sure raw energy is not less that miminum of fit range
+    if(x <= x_min)
+        x = x_min;
+    // make sure that raw energy is not beyond asymptote defined by E0
+    const auto E0 = p[p::E0];
+    if(x <= E0)
+        // as raw energy is digitized, +1 is meaningful here on non-log scale
+        // we get the value "very close" to the asymptote
+        x = std::log10(std::pow(10, E0) + 1);
+    return timewalk_value(x, p);
 }
 
 TF1* timewalk::getTF1()
 {
-    return helper::makeTF1(fct, 6);
+    return helper::makeTF1(fct, nParameters);
 }
 
 double exponential::fct(double *x, double *p)
@@ -18,6 +18,14 @@ struct gaus {
 struct timewalk {
     static double fct(double* x, double* p);
     static TF1* getTF1();
+    /**
+     * @brief Eval the function like TF1::Eval, but keeps x within the fit range and away from the asymptote
+     * @param x log10 of the raw energy
+     * @param x_min start of the fit range
+     * @param p parameters, see p
+     * @return time walk
+     */
+    static double Eval(double x, double x_min, const double* p);
     struct p {
         constexpr static auto Offset = 0;
         constexpr static auto Scale  = 1;
@@ -26,6 +34,7 @@ struct timewalk {
         constexpr static auto Exp    = 4;
         constexpr static auto Slope  = 5;
     };
+    constexpr static unsigned nParameters = 6;
 };
 
 struct exponential {
@@ -123,16 +123,12 @@ void FitTimewalk::Load(const SavedState_t &data)
 
 double FitTimewalk::Eval(double log10_raw_energy) const
 {
-    // make sure raw energy is not less that miminum of fit range
-    if(log10_raw_energy <= GetRange().Start())
-        log10_raw_energy = GetRange().Start();
-    // make sure that raw energy is not beyond asymptote defined by E0
-    const auto E0 = func->GetParameter(functions::timewalk::p::E0);
-    if(log10_raw_energy <= E0)
-        // as raw energy is digitized, +1 is meaningful here on non-log scale
-        // we get the value "very close" to the asymptote
-        log10_raw_energy = std::log10(std::pow(10, E0) + 1);
-    return func->Eval(log10_raw_energy);
+    return functions::timewalk::Eval(log10_raw_energy, GetRange().Start(), func->GetParameters());
+}
+
+std::vector<double> FitTimewalk::GetParameters() const
+{
+    return std::vector<double>(func->GetParameters(), func->GetParameters()+func->GetNpar());
 }
 
 
@@ -29,6 +29,9 @@ public:
 
     double Eval(double log10_raw_energy) const;
 
+    /// parameters of the function, to be used with functions::timewalk::Eval
+    std::vector<double> GetParameters() const;
+
 };
 
 }
@@ -3,6 +3,7 @@
 #include <memory>
 #include <list>
 #include <queue>
+#include <vector>
 #include <cassert>
 
 #include "AvgBuffer_traits.h"
@@ -135,16 +136,25 @@ protected:
         const interval<int> range(-std::distance(m_buffer.begin(), i),
                                   std::distance(i, m_buffer.end())-1);
 
-        for(auto bin=0;bin<nBins;bin++) {
-            auto getY = [i,bin,normalization] (const int i_) {
-                return Traits::GetBin(*std::next(i, i_)->hist, bin)/normalization;
-            };
-            auto setY = [h,bin] (const double v) {
-                Traits::SetBin(*h, bin, v);
-            };
-            sg.Convolute(getY, setY, range);
+        // look up the items of the window once, instead of walking the list for each bin
+        const auto& coefficients = sg.GetCoefficients();
+        std::vector<const AvgBufferItem*> window;
+        window.reserve(coefficients.size());
+        for(int k=0;k<int(coefficients.size());k++) {
+            const auto i_ = SavitzkyGolay::Mirror(k - sg.GetWindowLeft(), range);
+            window.push_back(std::next(i, i_)->hist.get());
         }
 
+        // then convolute all bins item by item
+        std::vector<double> smoothed(nBins, 0.0);
+        for(std::size_t k=0;k<window.size();k++) {
+            const double c = coefficients[k]/normalization;
+            for(auto bin=0;bin<nBins;bin++)
+                smoothed[bin] += c*Traits::GetBin(*window[k], bin);
+        }
+        for(auto bin=0;bin<nBins;bin++)
+            Traits::SetBin(*h, bin, smoothed[bin]);
+
         return h;
     }
 
@@ -9,18 +9,55 @@
 
 #include "base/interval.h"
 #include "base/std_ext/misc.h"
+#include "base/std_ext/memory.h"
 #include "base/WrapTFile.h"
+#include "base/ProcessPool.h"
+#include "base/tmpfile_t.h"
 #include "base/Logger.h"
 
 #include "TH2D.h"
+#include "TFile.h"
 
 #include <memory>
+#include <thread>
+#include <chrono>
 
 using namespace std;
 using namespace ant;
 using namespace ant::calibration;
 using namespace ant::calibration::gui;
 
+/**
+ * @brief The Manager::prefetch_t struct loads the histograms of the upcoming input files in worker processes
+ *
+ * ROOT is not thread-safe, so each histogram is loaded by a forked worker
+ * and handed over in a small uncompressed temporary file. This pays off if opening the input
+ * files and extracting the histogram is slow, for example for large files on network storage,
+ * as the parent only reads back one histogram from local disk.
+ * At most PrefetchFiles files are loaded ahead, which bounds the used memory and disk space.
+ */
+struct Manager::prefetch_t {
+    struct item_t {
+        item_t(list<input_file_t>::iterator it_file_, const tmpfolder_t& folder) :
+            it_file(it_file_), output(folder, ".root") {}
+        list<input_file_t>::iterator it_file;
+        tmpfile_t output;
+        unsigned task = 0;
+    };
+
+    explicit prefetch_t(unsigned nFiles) : pool(nFiles) {
+        // failed files are loaded again by the manager, which reports the error
+        pool.MaxRetries = 0;
+    }
+
+    // destroyed in reverse order, so running workers are killed
+    // before their output files and the folder are deleted
+    tmpfolder_t folder;
+    // in the order of the input files, the front one is needed next
+    list<item_t> items;
+    ProcessPool pool;
+};
+
 Manager::Manager(const std::vector<std::string>& inputfiles,
                  std::unique_ptr<AvgBuffer_traits<TH1>> buffer_,
                  bool confirmHeaderMismatch):
@@ -118,16 +155,65 @@ void Manager::BuildInputFiles(const vector<string>& filenames)
 
 
 
+shared_ptr<TH1> Manager::LoadHistogram(const string& filename) const
+{
+    WrapTFileInput file;
+    file.OpenFile(filename);
+    return module->GetHistogram(file);
+}
+
+shared_ptr<TH1> Manager::GetPrefetchedHistogram()
+{
+    // the manager never goes back, but start over if it does anyway,
+    // which stops the workers still loading other files
+    if(prefetch && !prefetch->items.empty() && prefetch->items.front().it_file != state.it_file)
+        prefetch = nullptr;
+
+    if(!prefetch)
+        prefetch = std_ext::make_unique<prefetch_t>(PrefetchFiles);
+    auto& items = prefetch->items;
+
+    // keep the next PrefetchFiles files in flight
+    auto it_next = items.empty() ? state.it_file : next(items.back().it_file);
+    while(items.size() < PrefetchFiles && it_next != input_files.end()) {
+        items.emplace_back(it_next, prefetch->folder);
+        auto& item = items.back();
+        const auto& filename = item.it_file->filename;
+        const auto& output = item.output.filename;
+        item.task = prefetch->pool.Add(filename, [this, filename, output] () {
+            auto hist = LoadHistogram(filename);
+            if(!hist)
+                return false;
+            // no compression, the file is read right away
+            TFile f(output.c_str(), "RECREATE", "", 0);
+            return f.WriteTObject(hist.get(), "hist") > 0;
+        });
+        ++it_next;
+    }
+
+    const auto& item = items.front();
+    std_ext::execute_on_destroy pop_item([this, &items] () {
+        items.pop_front();
+        // forget the finished tasks, so polling does not slow down over thousands of files
+        prefetch->pool.Prune();
+    });
+
+    while(prefetch->pool.Poll() && !prefetch->pool.Finished(item.task))
+        this_thread::sleep_for(chrono::milliseconds(10));
+
+    if(prefetch->pool.Succeeded(item.task))
+        return WrapTFileInput(item.output.filename).GetSharedHist<TH1>("hist");
+    return LoadHistogram(state.it_file->filename);
+}
+
 void Manager::FillBufferFromFiles()
 {
     while(buffer->Empty() && state.it_file != input_files.end()) {
         const input_file_t& file_input = *state.it_file;
         try
         {
-            WrapTFileInput file;
-            file.OpenFile(file_input.filename);
-
-            auto hist = module->GetHistogram(file);
+            auto hist = PrefetchFiles > 0 ?
+                            GetPrefetchedHistogram() : LoadHistogram(file_input.filename);
 
             if(!hist) {
                 LOG(WARNING) << "No histogram returned by module in " << file_input.filename;
@@ -60,6 +60,12 @@ protected:
 
     void FillBufferFromFiles();
 
+    std::shared_ptr<TH1> LoadHistogram(const std::string& filename) const;
+
+    struct prefetch_t;
+    std::unique_ptr<prefetch_t> prefetch;
+    std::shared_ptr<TH1> GetPrefetchedHistogram();
+
     int nChannels;
 
     bool confirmed_HeaderMismatch = false;
@@ -67,6 +73,12 @@ protected:
 public:
     std::string SetupName;
 
+    /**
+     * @brief number of input files loaded ahead by forked worker processes, zero loads them one by one
+     * @note only use it without GUI, as the workers are forked from this process
+     */
+    unsigned PrefetchFiles = 0;
+
     Manager(const std::vector<std::string>& inputfiles,
             std::unique_ptr<AvgBuffer_traits<TH1>> buffer_,
             bool confirmHeaderMismatch=false);
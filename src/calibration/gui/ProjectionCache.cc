@@ -0,0 +1,159 @@
+#include "ProjectionCache.h"
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration::gui;
+
+namespace {
+
+/// keeps the projections out of gDirectory, so that they don't replace histograms of the same name
+struct add_directory_guard {
+    const bool status = TH1::AddDirectoryStatus();
+    add_directory_guard() { TH1::AddDirectory(false); }
+    ~add_directory_guard() { TH1::AddDirectory(status); }
+};
+
+bool same_binning(const TAxis& a, const TAxis& b) {
+    return a.GetNbins() == b.GetNbins()
+            && a.GetXmin() == b.GetXmin()
+            && a.GetXmax() == b.GetXmax();
+}
+
+void copy_axis(TAxis& to, const TAxis& from) {
+    // variable bin sizes, ROOT leaves the array empty otherwise
+    if(from.GetXbins()->GetSize() > 0)
+        to.Set(from.GetNbins(), from.GetXbins()->GetArray());
+    to.SetTitle(from.GetTitle());
+}
+
+}
+
+ProjectionCache::ProjectionCache() = default;
+ProjectionCache::~ProjectionCache() = default;
+
+void ProjectionCache::fill(const TH1& h, unsigned nChannels)
+{
+    if(source == addressof(h) && source_entries == h.GetEntries())
+        return;
+
+    source = addressof(h);
+    source_entries = h.GetEntries();
+
+    // one pass over all bins, the global bin number is
+    // x + (nx+2)*(y + (ny+2)*z), so the channel axis varies slowest
+    const unsigned nCells = h.GetNcells();
+    channel_size = nCells/(nChannels+2);
+
+    contents.resize(nCells);
+    for(unsigned bin=0;bin<nCells;bin++)
+        contents[bin] = h.GetBinContent(bin);
+
+    sumw2.clear();
+    if(h.GetSumw2N()>0) {
+        const auto& w2 = *h.GetSumw2();
+        sumw2.assign(w2.GetArray(), w2.GetArray()+nCells);
+    }
+
+    // ROOT sets the entries of an unweighted projection to the sum of the projected contents
+    channel_entries.resize(nChannels);
+    for(unsigned ch=0;ch<nChannels;ch++) {
+        const auto begin = next(contents.cbegin(), (ch+1)*channel_size);
+        channel_entries[ch] = accumulate(begin, next(begin, channel_size), 0.0);
+    }
+}
+
+void ProjectionCache::copy_channel(TH1& projection, unsigned channel) const
+{
+    const auto offset = (channel+1)*channel_size;
+
+    auto& projection_contents = dynamic_cast<TArrayD&>(projection);
+    copy_n(next(contents.cbegin(), offset), channel_size, projection_contents.GetArray());
+
+    if(!sumw2.empty()) {
+        if(projection.GetSumw2N()==0)
+            projection.Sumw2();
+        copy_n(next(sumw2.cbegin(), offset), channel_size, projection.GetSumw2()->GetArray());
+    }
+    else if(projection.GetSumw2N()>0) {
+        // errors are the square root of the contents then
+        projection.GetSumw2()->Set(0);
+    }
+
+    // like ROOT, the effective entries are used for weighted histograms,
+    // which ResetStats already calculates
+    projection.ResetStats();
+    if(sumw2.empty())
+        projection.SetEntries(std::floor(channel_entries[channel]+0.5));
+}
+
+TH1D* ProjectionCache::ProjectionX(const TH2& h, unsigned channel, const string& name)
+{
+    const unsigned nChannels = h.GetNbinsY();
+    fill(h, nChannels);
+
+    const TAxis& xaxis = *h.GetXaxis();
+    if(!projection_1d || !same_binning(*projection_1d->GetXaxis(), xaxis)) {
+        add_directory_guard guard;
+        projection_1d = std::unique_ptr<TH1D>(
+                            new TH1D(name.c_str(), h.GetTitle(),
+                                     xaxis.GetNbins(), xaxis.GetXmin(), xaxis.GetXmax()));
+        copy_axis(*projection_1d->GetXaxis(), xaxis);
+    }
+    projection_1d->SetName(name.c_str());
+    projection_1d->GetXaxis()->SetRange(); // undo any zooming from the last channel
+
+    if(channel < nChannels)
+        copy_channel(*projection_1d, channel);
+    else
+        projection_1d->Reset();
+
+    return projection_1d.get();
+}
+
+TH2D* ProjectionCache::ProjectionYX(const TH3& h, unsigned channel, const string& name)
+{
+    const unsigned nChannels = h.GetNbinsZ();
+    fill(h, nChannels);
+
+    const TAxis& xaxis = *h.GetXaxis();
+    const TAxis& yaxis = *h.GetYaxis();
+    if(!projection_2d
+       || !same_binning(*projection_2d->GetXaxis(), xaxis)
+       || !same_binning(*projection_2d->GetYaxis(), yaxis)) {
+        add_directory_guard guard;
+        projection_2d = std::unique_ptr<TH2D>(
+                            new TH2D(name.c_str(), h.GetTitle(),
+                                     xaxis.GetNbins(), xaxis.GetXmin(), xaxis.GetXmax(),
+                                     yaxis.GetNbins(), yaxis.GetXmin(), yaxis.GetXmax()));
+        copy_axis(*projection_2d->GetXaxis(), xaxis);
+        copy_axis(*projection_2d->GetYaxis(), yaxis);
+    }
+    projection_2d->SetName(name.c_str());
+    projection_2d->GetXaxis()->SetRange();
+    projection_2d->GetYaxis()->SetRange();
+
+    if(channel < nChannels)
+        copy_channel(*projection_2d, channel);
+    else
+        projection_2d->Reset();
+
+    return projection_2d.get();
+}
+
+void ProjectionCache::Reset()
+{
+    source = nullptr;
+    source_entries = 0;
+    contents.clear();
+    sumw2.clear();
+    channel_entries.clear();
+    channel_size = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+
+class TH1;
+class TH1D;
+class TH2;
+class TH2D;
+class TH3;
+
+namespace ant {
+namespace calibration {
+namespace gui {
+
+/**
+ * @brief The ProjectionCache class provides the per-channel projections of a calibration histogram
+ *
+ * Calibration histograms have the channel on their last axis. Instead of letting ROOT
+ * project the full histogram each time a channel is visited, the bin contents are read
+ * once per histogram into flat arrays, which keep the bins of one channel contiguous.
+ * A projection then just copies those bins into a histogram owned by the cache,
+ * so going back and forth between channels is cheap.
+ *
+ * The cache is refilled whenever a different histogram is given,
+ * and should be reset in StartSlice, since the histograms of the previous slice are gone by then.
+ */
+class ProjectionCache {
+public:
+    ProjectionCache();
+    ~ProjectionCache();
+
+    /**
+     * @brief ProjectionX is the equivalent of h.ProjectionX(name, channel+1, channel+1)
+     * @param h histogram with the channels on the y axis
+     * @param channel
+     * @param name of the returned histogram
+     * @return projection owned by the cache, valid until the next call or Reset
+     */
+    TH1D* ProjectionX(const TH2& h, unsigned channel, const std::string& name = "h_projection");
+
+    /**
+     * @brief ProjectionYX is the equivalent of Project3D("yx") with the z range set to the channel
+     * @param h histogram with the channels on the z axis
+     * @param channel
+     * @param name of the returned histogram
+     * @return projection owned by the cache, valid until the next call or Reset
+     */
+    TH2D* ProjectionYX(const TH3& h, unsigned channel, const std::string& name = "h_projection_yx");
+
+    /// forget the cached histogram, for example at the start of a slice
+    void Reset();
+
+protected:
+    const TH1* source = nullptr;
+    double source_entries = 0;
+
+    // all bins including under- and overflow, in ROOT's global bin order,
+    // which puts the bins of one channel next to each other
+    std::vector<double> contents;
+    std::vector<double> sumw2;
+    std::vector<double> channel_entries;
+    unsigned channel_size = 0;
+
+    std::unique_ptr<TH1D> projection_1d;
+    std::unique_ptr<TH2D> projection_2d;
+
+    void fill(const TH1& h, unsigned nChannels);
+    void copy_channel(TH1& projection, unsigned channel) const;
+};
+
+}}} // namespace ant::calibration::gui
@@ -34,22 +34,39 @@ CB_Energy::CB_Energy(const std::shared_ptr<const expconfig::detector::CB>& cb,
            defaultRelativeGains),
     cb_detector(cb)
 {
+    // the neighbours are looked up once, as the flood fill runs on each load
+    const FloodFillNeighbours neighbours(cb->GetNChannels(), [cb] (int ch) -> const vector<unsigned>& {
+        return cb->GetClusterElement(ch)->Neighbours;
+    });
     // RelativeGains for elements flagged as NoCalib are flood filled
-    RelativeGains.NotifyLoad = [cb] (CalibType& relativeGains) {
+    RelativeGains.NotifyLoad = [cb, neighbours] (CalibType& relativeGains) {
+        // the flood fill visits all channels of the detector
+        relativeGains.FillUpWithDefaults(neighbours.Size());
         auto& v = relativeGains.Values;
         auto getVal = [&v] (int ch) { return v[ch]; };
         auto setVal = [&v] (int ch, double val) {
             v[ch] = val;
             VLOG(5) << "Channel=" << ch << " flood filled";
         };
-        auto getNeighbours = [cb] (int ch) { return cb->GetClusterElement(ch)->Neighbours; };
         auto getValid = [cb] (int ch) { return !cb->HasElementFlags(ch, Detector_t::ElementFlag_t::NoCalib); };
-        floodFillAverages(v.size(), getVal, setVal, getNeighbours, getValid);
+        floodFillAverages(neighbours, getVal, setVal, getValid);
     };
 }
 
 void CB_Energy::GetGUIs(list<unique_ptr<gui::CalibModule_traits> >& guis, OptionsPtr options)
 {
+    if(options->HasOption("UseIteratedGains")) {
+        LOG(INFO) << "Use gain factors iterated by physics class CB_Energy";
+        guis.emplace_back(std_ext::make_unique<GUI_IteratedGains>(
+                              GetName(),
+                              options,
+                              RelativeGains,
+                              calibrationManager,
+                              cb_detector
+                              ));
+        return;
+    }
+
     guis.emplace_back(std_ext::make_unique<GUI_Gains>(
                           GetName(),
                           options,
@@ -105,7 +122,7 @@ gui::CalibModule_traits::DoFitReturn_t CB_Energy::GUI_Gains::DoFit(const TH1& hi
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
 
     // stop at empty histograms
     if(h_projection->GetEntries()==0)
@@ -211,3 +228,96 @@ bool CB_Energy::GUI_Gains::FinishSlice()
     return true;
 }
 
+CB_Energy::GUI_IteratedGains::GUI_IteratedGains(const string& basename,
+                                                OptionsPtr options,
+                                                CalibType& type,
+                                                const std::shared_ptr<DataManager>& calmgr,
+                                                const std::shared_ptr<const expconfig::detector::CB>& cb_detector_) :
+    GUI_CalibType(basename, options, type, calmgr, cb_detector_),
+    cb_detector(cb_detector_)
+{
+}
+
+shared_ptr<TH1> CB_Energy::GUI_IteratedGains::GetHistogram(const WrapTFile& file) const
+{
+    // histogram name created by the physics class CB_Energy with option Iterate
+    return file.GetSharedHist<TH1>(options->Get<string>("HistogramPath", CalibModule_traits::GetName()) + "/h_GainFactors");
+}
+
+void CB_Energy::GUI_IteratedGains::InitGUI(gui::ManagerWindow_traits& window)
+{
+    GUI_CalibType::InitGUI(window);
+
+    canvas = window.AddCalCanvas();
+    h_relative = new TH1D("h_relative","Relative change from previous gains",GetNumberOfChannels(),0,GetNumberOfChannels());
+    h_relative->SetXTitle("Channel Number");
+    h_relative->SetYTitle("Relative change / %");
+    h_relative_cb = new TH2CB("h_relative_cb",h_relative->GetTitle());
+}
+
+gui::CalibModule_traits::DoFitReturn_t CB_Energy::GUI_IteratedGains::DoFit(const TH1& hist, unsigned channel)
+{
+    // the underflow bin counts the Ant outputs summed into this histogram,
+    // either by merging files or by the buffer of several input files
+    const auto nOutputs = hist.GetBinContent(0);
+    if(nOutputs != 1) {
+        if(channel == 0)
+            LOG(ERROR) << "Gain factors were summed from " << nOutputs << " outputs, keeping previous gains. "
+                       << "Iterate over all data in one Ant run and calibrate with one input file per slice.";
+        return DoFitReturn_t::Skip;
+    }
+
+    if(detector->IsIgnored(channel)) {
+        VLOG(6) << "Skipping ignored channel " << channel;
+        return DoFitReturn_t::Skip;
+    }
+
+    if(detector->HasElementFlags(channel, Detector_t::ElementFlag_t::NoCalib)) {
+        VLOG(6) << "Skipping NoCalib-flagged channel " << channel;
+        return DoFitReturn_t::Skip;
+    }
+
+    // nothing to fit, the factors were already determined
+    h_factors = addressof(hist);
+    return DoFitReturn_t::Next;
+}
+
+void CB_Energy::GUI_IteratedGains::DisplayFit()
+{
+    canvas->Clear();
+    canvas->cd();
+    if(h_factors)
+        h_factors->DrawCopy("P");
+}
+
+void CB_Energy::GUI_IteratedGains::StoreFit(unsigned channel)
+{
+    const double oldValue = previousValues[channel];
+    const double factor = h_factors->GetBinContent(channel+1);
+    const double newValue = oldValue * factor;
+
+    calibType.Values[channel] = newValue;
+
+    const double relative_change = 100*(newValue/oldValue-1);
+
+    LOG(INFO) << "Stored Ch=" << channel << ": Factor " << factor
+              << ",  gain changed " << oldValue << " -> " << newValue
+              << " (" << relative_change << " %)";
+
+    h_relative->SetBinContent(channel+1, relative_change);
+}
+
+bool CB_Energy::GUI_IteratedGains::FinishSlice()
+{
+    canvas->Clear();
+    canvas->Divide(2,1);
+
+    canvas->cd(1);
+    h_relative->SetStats(false);
+    h_relative->Draw("P");
+    canvas->cd(2);
+    h_relative_cb->SetElements(*h_relative);
+    h_relative_cb->Draw("colz");
+
+    return true;
+}
@@ -53,6 +53,34 @@ public:
         const std::shared_ptr<const expconfig::detector::CB> cb_detector;
     };
 
+    /**
+     * @brief The GUI_IteratedGains struct applies the gain factors iterated by the CB_Energy physics class
+     *
+     * The factors are only valid for the whole data they were iterated on,
+     * so outputs merged from several Ant runs are refused.
+     */
+    struct GUI_IteratedGains : GUI_CalibType {
+        GUI_IteratedGains(const std::string& basename,
+                          OptionsPtr options,
+                          CalibType& type,
+                          const std::shared_ptr<DataManager>& calmgr,
+                          const std::shared_ptr<const expconfig::detector::CB>& cb_detector_);
+
+        virtual std::shared_ptr<TH1> GetHistogram(const WrapTFile& file) const override;
+        virtual void InitGUI(gui::ManagerWindow_traits& window) override;
+        virtual DoFitReturn_t DoFit(const TH1& hist, unsigned channel) override;
+        virtual void DisplayFit() override;
+        virtual void StoreFit(unsigned channel) override;
+        virtual bool FinishSlice() override;
+    protected:
+        gui::CalCanvas* canvas;
+        const TH1* h_factors = nullptr;
+        TH1D* h_relative = nullptr;
+        TH2CB* h_relative_cb = nullptr;
+
+        const std::shared_ptr<const expconfig::detector::CB> cb_detector;
+    };
+
     CB_Energy(const std::shared_ptr<const expconfig::detector::CB>& cb,
             const std::shared_ptr<DataManager>& calmgr,
             const Calibration::Converter::ptr_t& converter,
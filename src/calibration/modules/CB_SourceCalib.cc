@@ -98,7 +98,7 @@ void CB_SourceCalib::TheGUI::InitGUI(gui::ManagerWindow_traits& window)
 
 void CB_SourceCalib::TheGUI::StartSlice(const interval<TID>&)
 {
-
+    projections.Reset();
 }
 
 gui::CalibModule_traits::DoFitReturn_t CB_SourceCalib::TheGUI::DoFit(const TH1& hist, unsigned channel)
@@ -107,7 +107,7 @@ gui::CalibModule_traits::DoFitReturn_t CB_SourceCalib::TheGUI::DoFit(const TH1&
         return DoFitReturn_t::Skip;
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
     sprintf(Histname, "AmBe-Peak of channel %d", channel);
     h_projection->SetTitle(Histname);
 
@@ -36,6 +36,7 @@ public:
         std::shared_ptr<gui::FitGausexpo> func;
 
         gui::CalCanvas* canvas;
+        gui::ProjectionCache projections;
         TH1* h_projection = nullptr;
         TH1D* AmBe_peaks = nullptr;
         TH1D* h_peaks = nullptr;
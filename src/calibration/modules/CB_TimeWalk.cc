@@ -3,6 +3,7 @@
 #include "DataManager.h"
 #include "gui/CalCanvas.h"
 #include "fitfunctions/FitTimewalk.h"
+#include "fitfunctions/BaseFunctions.h"
 #include "tree/TCalibrationData.h"
 
 #include "expconfig/detectors/CB.h"
@@ -22,6 +23,7 @@
 
 #include <limits>
 #include <cmath>
+#include <algorithm>
 
 using namespace ant;
 using namespace ant::calibration;
@@ -42,6 +44,7 @@ CB_TimeWalk::CB_TimeWalk(
     for(unsigned ch=0;ch<cb_detector->GetNChannels();ch++) {
         timewalks.emplace_back(make_shared<gui::FitTimewalk>());
     }
+    UpdateTimewalkTable();
 }
 
 CB_TimeWalk::~CB_TimeWalk()
@@ -60,6 +63,11 @@ void CB_TimeWalk::ApplyTo(clusterhits_t& sorted_clusterhits)
 
     auto& clusterhits = it_sorted_clusterhits->second;
 
+    // first gather the hits which need the timewalk correction,
+    // then evaluate the timewalk of all of them at once
+    hits.ClusterHits.clear();
+    hits.Log10RawEnergies.clear();
+    hits.Channels.clear();
 
     for(TClusterHit& clusterhit : clusterhits) {
 
@@ -76,15 +84,14 @@ void CB_TimeWalk::ApplyTo(clusterhits_t& sorted_clusterhits)
         // use uncalibrated energy for that
         // to stay independent of energy calibration
 
-
         double raw_energy = std_ext::NaN;
-        vector<double> timings;
+        bool has_timing = false;
         for(auto& datum : clusterhit.Data) {
             if(datum.Type == Channel_t::Type_t::Integral) {
                 raw_energy = datum.Value.Uncalibrated;
             }
             else if(datum.Type == Channel_t::Type_t::Timing) {
-                timings.push_back(datum.Value.Calibrated);
+                has_timing = true;
             }
         }
 
@@ -94,36 +101,71 @@ void CB_TimeWalk::ApplyTo(clusterhits_t& sorted_clusterhits)
             continue;
         }
 
-        if(timings.empty()) {
+        if(!has_timing) {
             VLOG(7) << "Found " << clusterhit << " without any timings.";
             continue;
         }
 
-        // Eval of Timewalk function handles
-        // case of low raw energy for us
-        auto deltaT = timewalks[clusterhit.Channel]->Eval(std::log10(raw_energy));
+        hits.ClusterHits.push_back(addressof(clusterhit));
+        hits.Log10RawEnergies.push_back(std::log10(raw_energy));
+        hits.Channels.push_back(clusterhit.Channel);
+    }
+
+    const auto nHits = hits.ClusterHits.size();
+    constexpr auto stride = functions::timewalk::nParameters+1;
+
+    // Eval of Timewalk function handles
+    // case of low raw energy for us
+    hits.DeltaTs.resize(nHits);
+    for(size_t i=0;i<nHits;i++) {
+        const double* row = addressof(timewalk_table[hits.Channels[i]*stride]);
+        hits.DeltaTs[i] = functions::timewalk::Eval(hits.Log10RawEnergies[i], row[0], row+1);
+    }
+
+    for(size_t i=0;i<nHits;i++) {
+        const auto deltaT = hits.DeltaTs[i];
 
         // still check if we got a finite value
         // else just do nothing with clusterhit
-        if(isfinite(deltaT)) {
+        if(!isfinite(deltaT))
+            continue;
 
-            // find the timing which is closest to deltaT
-            auto it_min_timing = std::min_element(
-                                     timings.begin(), timings.end(),
-                                     [deltaT] (double a, double b) {
-                return abs(a - deltaT) < abs(b - deltaT);
-            });
+        TClusterHit& clusterhit = *hits.ClusterHits[i];
 
-            clusterhit.Time = *it_min_timing - deltaT;
+        // find the timing which is closest to deltaT
+        bool first = true;
+        double min_timing = std_ext::NaN;
+        for(auto& datum : clusterhit.Data) {
+            if(datum.Type != Channel_t::Type_t::Timing)
+                continue;
+            const double timing = datum.Value.Calibrated;
+            if(first || abs(timing - deltaT) < abs(min_timing - deltaT))
+                min_timing = timing;
+            first = false;
+        }
 
-            // get rid of clusterhit if outside timewindow
-            if(!TimeWindow.Contains(clusterhit.Time)) {
-                clusterhit.Time = std_ext::NaN;
-            }
+        clusterhit.Time = min_timing - deltaT;
+
+        // get rid of clusterhit if outside timewindow
+        if(!TimeWindow.Contains(clusterhit.Time)) {
+            clusterhit.Time = std_ext::NaN;
         }
     }
 }
 
+void CB_TimeWalk::UpdateTimewalkTable()
+{
+    constexpr auto stride = functions::timewalk::nParameters+1;
+    timewalk_table.resize(timewalks.size()*stride);
+    for(size_t ch=0;ch<timewalks.size();ch++) {
+        const auto& timewalk = *timewalks[ch];
+        const auto params = timewalk.GetParameters();
+        auto row = next(timewalk_table.begin(), ch*stride);
+        *row = timewalk.GetRange().Start();
+        copy(params.begin(), params.end(), next(row));
+    }
+}
+
 void CB_TimeWalk::GetGUIs(list<unique_ptr<gui::CalibModule_traits> >& guis, OptionsPtr) {
     guis.emplace_back(std_ext::make_unique<TheGUI>(GetName(), calibrationManager, cb_detector, timewalks));
 }
@@ -143,6 +185,7 @@ std::list<Updateable_traits::Loader_t> CB_TimeWalk::GetLoaders()
                 }
                 timewalks[kv.Key]->Load(kv.Value);
             }
+            UpdateTimewalkTable();
         }
     };
 }
@@ -187,6 +230,7 @@ void CB_TimeWalk::TheGUI::InitGUI(gui::ManagerWindow_traits& window)
 
 void CB_TimeWalk::TheGUI::StartSlice(const interval<TID>& range)
 {
+    projections.Reset();
 
     TCalibrationData cdata;
     if(!calibrationManager->GetData(GetName(), range.Start(), cdata)) {
@@ -296,8 +340,7 @@ gui::CalibModule_traits::DoFitReturn_t CB_TimeWalk::TheGUI::DoFit(const TH1& his
 
     auto& h_timewalk = dynamic_cast<const TH3&>(hist);
 
-    h_timewalk.GetZaxis()->SetRange(ch+1,ch+1);
-    proj = dynamic_cast<TH2D*>(h_timewalk.Project3D("yx"));
+    proj = projections.ProjectionYX(h_timewalk, ch, "timewalk_yx");
 
     means = MyFitSlicesY(proj, slicesY_gaus,
                          slicesY_entryCut, slicesY_IQRFactor_lo, slicesY_IQRFactor_hi);
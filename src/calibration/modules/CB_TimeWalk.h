@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Calibration.h"
+#include "calibration/gui/ProjectionCache.h"
 
 class TGraph;
 class TH1D;
@@ -47,6 +48,7 @@ public:
 
         gui::CalCanvas* c_fit;
         gui::CalCanvas* c_extra;
+        gui::ProjectionCache projections;
         TH1D* means;
         TH2D* proj;
 
@@ -94,6 +96,19 @@ protected:
     bool IsMC = false;
     const double BadTDC_EnergyThreshold;
 
+    // flat copy of the timewalk functions, one row per channel
+    // with the start of the fit range followed by the parameters
+    std::vector<double> timewalk_table;
+    void UpdateTimewalkTable();
+
+    // CB hits of the current event to be corrected, kept to reuse the memory
+    struct hits_t {
+        std::vector<TClusterHit*> ClusterHits;
+        std::vector<double> Log10RawEnergies;
+        std::vector<unsigned> Channels;
+        std::vector<double> DeltaTs;
+    } hits;
+
 };
 
 }}
@@ -1,5 +1,7 @@
 #include "CalibType.h"
 
+#include "base/Logger.h"
+
 using namespace std;
 using namespace ant;
 using namespace ant::calibration;
@@ -7,18 +9,31 @@ using namespace ant::calibration;
 double CalibType::Get(unsigned channel) const {
 
     if(Values.empty()) {
-        if(DefaultValues.size() == 1) {
-            return DefaultValues.front();
-        }
-        else {
-            return DefaultValues.at(channel);
-        }
+        return GetDefault(channel);
     }
     else {
         return Values.at(channel);
     }
 }
 
+double CalibType::GetDefault(unsigned channel) const {
+    if(DefaultValues.size() == 1) {
+        return DefaultValues.front();
+    }
+    else {
+        return DefaultValues.at(channel);
+    }
+}
+
+void CalibType::FillUpWithDefaults(unsigned nChannels) {
+    if(Values.size() >= nChannels)
+        return;
+    LOG(WARNING) << "CalibType " << Name << ": Loaded " << Values.size() << " values for "
+                 << nChannels << " channels, padding " << nChannels - Values.size() << " channels with defaults";
+    for(auto ch = unsigned(Values.size()); ch < nChannels; ch++)
+        Values.push_back(GetDefault(ch));
+}
+
 CalibType::CalibType(
         const std::shared_ptr<const Detector_t>& det,
         const string& name,
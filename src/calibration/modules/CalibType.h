@@ -1,6 +1,7 @@
 #pragma once
 
 #include "calibration/Calibration.h"
+#include "calibration/gui/ProjectionCache.h"
 
 namespace ant {
 namespace calibration {
@@ -21,6 +22,10 @@ struct CalibType
     std::function<void(CalibType&)> NotifyLoad; // called if Values were loaded, see Energy::GetLoaders()
 
     double Get(unsigned channel) const;
+    double GetDefault(unsigned channel) const;
+
+    /// appends the default values to Values up to nChannels, for example if fewer values were loaded, and warns about it
+    void FillUpWithDefaults(unsigned nChannels);
 
     CalibType(const detector_ptr_t& det,
               const std::string& name,
@@ -72,6 +77,9 @@ protected:
     bool IgnorePreviousFitParameters = false;
     bool UsePreviousSliceParams = false;
 
+    // per-channel projections of the current slice's histogram
+    gui::ProjectionCache projections;
+
     Calibration::AddMode_t addMode;
 }; // GUI_CalibType
 
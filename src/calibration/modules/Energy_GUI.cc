@@ -62,6 +62,8 @@ void GUI_CalibType::InitGUI(gui::ManagerWindow_traits& window) {
 
 void GUI_CalibType::StartSlice(const interval<TID>& range)
 {
+    projections.Reset();
+
     // clear previous values from slice first
     // then calibType.Get(ch) will return default value
     calibType.Values.clear();
@@ -158,7 +160,7 @@ gui::CalibModule_traits::DoFitReturn_t GUI_Pedestals::DoFit(const TH1& hist, uns
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
 
     func->SetDefaults(h_projection);
     const auto it_fit_param = fitParameters.find(channel);
@@ -294,8 +296,7 @@ gui::CalibModule_traits::DoFitReturn_t GUI_Banana::DoFit(const TH1& hist, unsign
         return DoFitReturn_t::Skip;
 
     auto& h_bananas = dynamic_cast<const TH3&>(hist);
-    h_bananas.GetZaxis()->SetRange(ch+1,ch+1);
-    banana = dynamic_cast<TH2D*>(h_bananas.Project3D("yx"));
+    banana = projections.ProjectionYX(h_bananas, ch, "h_bananas_yx");
     auto xaxis = banana->GetXaxis();
     h_projection = dynamic_cast<TH1D*>(banana->ProjectionY(
                                            "_py",
@@ -431,7 +432,7 @@ gui::CalibModule_traits::DoFitReturn_t GUI_MIP::DoFit(const TH1& hist, unsigned
         return DoFitReturn_t::Skip;
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
-    h_projection = hist2.ProjectionX("h_projection",ch+1,ch+1);
+    h_projection = projections.ProjectionX(hist2, ch);
 
     // stop at empty histograms
     if(h_projection->GetEntries()==0)
@@ -568,7 +569,7 @@ gui::CalibModule_traits::DoFitReturn_t GUI_HEP::DoFit(const TH1& hist, unsigned
         return DoFitReturn_t::Skip;
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
-    h_projection = hist2.ProjectionX("h_projection",ch+1,ch+1);
+    h_projection = projections.ProjectionX(hist2, ch);
 
     // stop at empty histograms
     if(h_projection->GetEntries()==0)
@@ -123,6 +123,8 @@ void PID_PhiAngle::TheGUI::InitGUI(gui::ManagerWindow_traits& window)
 
 void PID_PhiAngle::TheGUI::StartSlice(const interval<TID>& range)
 {
+    projections.Reset();
+
     // ask the detector for some reasonable starting values
     angles.resize(GetNumberOfChannels());
     for(size_t ch=0;ch<GetNumberOfChannels();ch++)
@@ -152,7 +154,7 @@ gui::CalibModule_traits::DoFitReturn_t PID_PhiAngle::TheGUI::DoFit(const TH1& hi
 {
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
 
     func->SetDefaults(h_projection);
     const auto it_fit_param = fitParameters.find(channel);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Calibration.h"
+#include "calibration/gui/ProjectionCache.h"
 #include "base/interval.h"
 
 class TGraph;
@@ -38,6 +39,7 @@ public:
 
         gui::CalCanvas* canvas;
 
+        gui::ProjectionCache projections;
         TH1*  h_projection = nullptr;
         TGraph* h_result;
 
@@ -55,17 +55,22 @@ TAPS_Energy::TAPS_Energy(
            defaultRelativeGains),
     taps_detector(taps)
 {
+    // the neighbours are looked up once, as the flood fill runs on each load
+    const FloodFillNeighbours neighbours(taps->GetNChannels(), [taps] (int ch) -> const vector<unsigned>& {
+        return taps->GetClusterElement(ch)->Neighbours;
+    });
     // RelativeGains are flood filled
-    RelativeGains.NotifyLoad = [taps] (CalibType& relativeGains) {
+    RelativeGains.NotifyLoad = [taps, neighbours] (CalibType& relativeGains) {
+        // the flood fill visits all channels of the detector
+        relativeGains.FillUpWithDefaults(neighbours.Size());
         auto& v = relativeGains.Values;
         auto getVal = [&v] (int ch) { return v[ch]; };
         auto setVal = [&v] (int ch, double val) {
             v[ch] = val;
             VLOG(5) << "Channel=" << ch << " flood filled";
         };
-        auto getNeighbours = [taps] (int ch) { return taps->GetClusterElement(ch)->Neighbours; };
         auto getValid = [taps] (int ch) { return !taps->HasElementFlags(ch, Detector_t::ElementFlag_t::NoCalib); };
-        floodFillAverages(v.size(), getVal, setVal, getNeighbours, getValid);
+        floodFillAverages(neighbours, getVal, setVal, getValid);
     };
 }
 
@@ -160,7 +165,7 @@ gui::CalibModule_traits::DoFitReturn_t TAPS_Energy::GUI_Gains::DoFit(const TH1&
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
 
     // stop at empty histograms
     if(h_projection->GetEntries() < 1.0)
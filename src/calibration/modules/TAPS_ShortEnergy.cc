@@ -107,7 +107,7 @@ gui::CalibModule_traits::DoFitReturn_t TAPS_ShortEnergy::GUI_Gains::DoFit(const
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    h_projection = hist2.ProjectionX("h_projection",channel+1,channel+1);
+    h_projection = projections.ProjectionX(hist2, channel);
 
     func->SetDefaults(h_projection);
     func->SetRange(interval<double>(-1,3));
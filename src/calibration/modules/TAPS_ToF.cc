@@ -94,6 +94,7 @@ void TAPS_ToF::TheGUI::InitGUI(gui::ManagerWindow_traits& window)
 
 void TAPS_ToF::TheGUI::StartSlice(const interval<TID>& range)
 {
+    projections.Reset();
     offsets.resize(0);
     offsets.resize(GetNumberOfChannels(), 0);
     TCalibrationData cdata;
@@ -120,7 +121,7 @@ gui::CalibModule_traits::DoFitReturn_t TAPS_ToF::TheGUI::DoFit(const TH1& hist,
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    times = hist2.ProjectionX("times",channel+1,channel+1);
+    times = projections.ProjectionX(hist2, channel, "times");
 
     fitFunction->SetDefaults(times);
     const auto it_fit_param = fitParams.find(channel);
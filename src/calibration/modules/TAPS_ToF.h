@@ -1,6 +1,7 @@
 #pragma once
 
 #include "calibration/Calibration.h"
+#include "calibration/gui/ProjectionCache.h"
 
 #include "base/std_ext/math.h"
 #include "base/Detector_t.h"
@@ -40,6 +41,7 @@ public:
         std::map<unsigned,std::vector<double>> fitParams;
 
         gui::CalCanvas* theCanvas;
+        gui::ProjectionCache projections;
         TH1D*  times;
         TH1D*  timePeaks;
 
@@ -181,6 +181,7 @@ void Time::TheGUI::InitGUI(gui::ManagerWindow_traits& window)
 
 void Time::TheGUI::StartSlice(const interval<TID>& range)
 {
+    projections.Reset();
     offsets = defaultOffsets;
     TCalibrationData cdata;
     if (calmgr->GetData(GetName(),range.Start(),cdata))
@@ -206,7 +207,7 @@ gui::CalibModule_traits::DoFitReturn_t Time::TheGUI::DoFit(const TH1& hist, unsi
 
     auto& hist2 = dynamic_cast<const TH2&>(hist);
 
-    times = hist2.ProjectionX("times",channel+1,channel+1);
+    times = projections.ProjectionX(hist2, channel, "times");
 
     if(times->GetEntries() == 0 && SkipEmptyChannels) {
         channelWasEmpty = true;
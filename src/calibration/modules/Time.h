@@ -1,6 +1,7 @@
 #pragma once
 
 #include "calibration/Calibration.h"
+#include "calibration/gui/ProjectionCache.h"
 #include "fitfunctions/FitGaus.h"
 
 #include "base/std_ext/math.h"
@@ -44,6 +45,7 @@ public:
         std::map<unsigned,std::vector<double>> fitParams;
 
         gui::CalCanvas* theCanvas;
+        gui::ProjectionCache projections;
         TH1*  times;
         TH1*  timePeaks;
 
@@ -0,0 +1,162 @@
+#include "GainIterator.h"
+
+#include "calibration/fitfunctions/FitGausPol3.h"
+
+#include "tree/TCluster.h"
+#include "base/ParticleType.h"
+#include "base/Logger.h"
+
+#include "TH2D.h"
+#include "TH1D.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration::detail;
+
+GainIterator::settings_t::settings_t() :
+    IMBins(1000),
+    FitRange(20, 200),
+    PeakPosition(ParticleTypeDatabase::Pi0.Mass())
+{}
+
+GainIterator::GainIterator(unsigned nChannels_) :
+    nChannels(nChannels_),
+    Factors(nChannels_, 1.0)
+{
+    if(nChannels > numeric_limits<uint16_t>::max())
+        throw runtime_error("Too many channels for GainIterator");
+}
+
+void GainIterator::addCluster(const TCluster& cl, bool fill)
+{
+    double sum = 0;
+    for(const TClusterHit& hit : cl.Hits) {
+        if(hit.Channel >= nChannels)
+            throw runtime_error("Cluster hit channel out of range");
+        HitChannel.push_back(hit.Channel);
+        HitEnergy.push_back(hit.Energy);
+        sum += hit.Energy;
+    }
+    ClusterHitsEnd.push_back(HitChannel.size());
+    // the ratio accounts for any energy corrections applied to the cluster
+    ClusterCorrection.push_back(sum > 0 ? cl.Energy/sum : 0.0);
+    ClusterCentral.push_back(cl.CentralElement);
+    ClusterFill.push_back(fill && cl.CentralElement < nChannels);
+}
+
+void GainIterator::AddPair(const TCluster& cl1, const TCluster& cl2, double imass, bool fill1, bool fill2)
+{
+    if(!(cl1.Energy > 0) || !(cl2.Energy > 0))
+        return;
+    addCluster(cl1, fill1);
+    addCluster(cl2, fill2);
+    OpeningTerm.push_back(imass*imass/(cl1.Energy*cl2.Energy));
+}
+
+void GainIterator::Evaluate(std::vector<double>& imasses) const
+{
+    const auto nClusters = ClusterHitsEnd.size();
+
+    // first sweep over all hits, gathering the factors per channel
+    clusterEnergies.resize(nClusters);
+    const double* factors = Factors.data();
+    const uint16_t* channels = HitChannel.data();
+    const float* energies = HitEnergy.data();
+    uint32_t begin = 0;
+    for(size_t c=0;c<nClusters;c++) {
+        const auto end = ClusterHitsEnd[c];
+        double sum = 0;
+        for(auto h=begin;h<end;h++)
+            sum += energies[h]*factors[channels[h]];
+        clusterEnergies[c] = ClusterCorrection[c]*sum;
+        begin = end;
+    }
+
+    // second sweep over all pairs
+    const auto nPairs = OpeningTerm.size();
+    imasses.resize(nPairs);
+    const double* E = clusterEnergies.data();
+    const float* opening = OpeningTerm.data();
+    double* im = imasses.data();
+    for(size_t p=0;p<nPairs;p++)
+        im[p] = std::sqrt(opening[p]*E[2*p]*E[2*p+1]);
+}
+
+void GainIterator::Fill(TH2& h) const
+{
+    vector<double> imasses;
+    Evaluate(imasses);
+    for(size_t p=0;p<imasses.size();p++) {
+        for(size_t c=2*p;c<2*p+2;c++) {
+            if(ClusterFill[c])
+                h.Fill(imasses[p], ClusterCentral[c]);
+        }
+    }
+}
+
+unsigned GainIterator::Iterate(const settings_t& settings)
+{
+    // keep the temporary histograms out of any output file
+    struct AddDirectory_t {
+        const bool status = TH1::AddDirectoryStatus();
+        AddDirectory_t() { TH1::AddDirectory(false); }
+        ~AddDirectory_t() { TH1::AddDirectory(status); }
+    } addDirectory;
+
+    TH2D h("h_GainIterator", "", settings.IMBins.Bins(), settings.IMBins.Start(), settings.IMBins.Stop(),
+           nChannels, 0, nChannels);
+    gui::FitGausPol3 func;
+
+    for(unsigned iteration=1;iteration<=settings.MaxIterations;iteration++) {
+        h.Reset();
+        Fill(h);
+
+        double maxChange = 0;
+        unsigned nFitted = 0;
+        for(unsigned ch=0;ch<nChannels;ch++) {
+            unique_ptr<TH1D> proj(h.ProjectionX("h_GainIterator_px", ch+1, ch+1));
+            const auto& axis = *proj->GetXaxis();
+            const auto entries = proj->Integral(axis.FindFixBin(settings.FitRange.Start()),
+                                                axis.FindFixBin(settings.FitRange.Stop()));
+            if(entries < settings.MinEntries)
+                continue;
+
+            func.SetDefaults(proj.get());
+            func.SetRange(settings.FitRange);
+            func.FitBackground(proj.get());
+            func.Fit(proj.get());
+
+            const double peak = func.GetPeakPosition();
+            if(!std::isfinite(peak) || !settings.FitRange.Contains(peak)) {
+                VLOG(5) << "Channel " << ch << ": Peak " << peak << " outside fit range, skipped";
+                continue;
+            }
+
+            const double change = settings.ConvergenceFactor*(settings.PeakPosition/peak - 1);
+            Factors[ch] *= 1 + change;
+            maxChange = std::max(maxChange, std::abs(change));
+            nFitted++;
+        }
+
+        LOG(INFO) << "Iteration " << iteration << ": Fitted " << nFitted << " channels, "
+                  << "maximum relative change " << 100*maxChange << " %";
+
+        if(maxChange < settings.Tolerance)
+            return iteration;
+    }
+    LOG(WARNING) << "Gains did not converge within " << settings.MaxIterations << " iterations";
+    return settings.MaxIterations;
+}
+
+void GainIterator::SetFactors(const std::vector<double>& factors)
+{
+    if(factors.size() != nChannels)
+        throw runtime_error("Number of factors does not match number of channels");
+    Factors = factors;
+}
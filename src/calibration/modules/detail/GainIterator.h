@@ -0,0 +1,100 @@
+#pragma once
+
+#include "base/BinSettings.h"
+#include "base/interval.h"
+
+#include <vector>
+#include <cstdint>
+
+class TH2;
+
+namespace ant {
+
+struct TCluster;
+
+namespace calibration {
+namespace detail {
+
+/**
+ * @brief The GainIterator class iterates relative gains of calorimeter channels in memory
+ *
+ * For each added gamma-gamma pair, the hit energies of both clusters are kept in flat arrays.
+ * Applying new gain factors rescales the hit energies, so the invariant masses are re-evaluated
+ * in one sweep without re-reading any event. Energy corrections applied to the clusters and the
+ * opening angle are kept fixed. Each iteration fits the peak per central element and moves the
+ * factors such that the peak appears at the expected position, as done by the CB_Energy GUI.
+ */
+class GainIterator {
+public:
+    struct settings_t {
+        settings_t();
+        BinSettings IMBins;
+        interval<double> FitRange;
+        /// where the peak should be, usually the pi0 mass
+        double PeakPosition;
+        double ConvergenceFactor = 1.0;
+        /// channels with fewer entries in the fit range are not changed
+        unsigned MinEntries = 100;
+        unsigned MaxIterations = 20;
+        /// stop if no factor changed by more than that relative amount
+        double Tolerance = 1e-3;
+    };
+
+    explicit GainIterator(unsigned nChannels);
+
+    /**
+     * @brief AddPair stores a pair of clusters forming the given invariant mass
+     * @param cl1 first cluster, entry at its central element if fill1 is true
+     * @param cl2 second cluster, entry at its central element if fill2 is true
+     * @param imass the invariant mass as reconstructed
+     */
+    void AddPair(const TCluster& cl1, const TCluster& cl2, double imass,
+                 bool fill1 = true, bool fill2 = true);
+
+    std::size_t GetNPairs() const { return OpeningTerm.size(); }
+
+    /**
+     * @brief Evaluate calculates the invariant masses of all pairs with the current factors
+     * @param imasses one entry per pair
+     */
+    void Evaluate(std::vector<double>& imasses) const;
+
+    /**
+     * @brief Fill fills invariant mass vs. central element like the ggIM histogram
+     * @param h histogram to be filled
+     */
+    void Fill(TH2& h) const;
+
+    /**
+     * @brief Iterate fits and adjusts the factors until converged
+     * @param settings the settings
+     * @return number of iterations done
+     */
+    unsigned Iterate(const settings_t& settings);
+
+    /// factors to multiply the gains with, initially one
+    const std::vector<double>& GetFactors() const { return Factors; }
+    void SetFactors(const std::vector<double>& factors);
+
+protected:
+    const unsigned nChannels;
+    std::vector<double> Factors;
+
+    // per hit
+    std::vector<std::uint16_t> HitChannel;
+    std::vector<float>         HitEnergy;
+    // per cluster, two clusters per pair
+    std::vector<std::uint32_t> ClusterHitsEnd;
+    std::vector<float>         ClusterCorrection;
+    std::vector<std::uint16_t> ClusterCentral;
+    std::vector<bool>          ClusterFill;
+    // per pair, squared mass divided by both cluster energies
+    std::vector<float>         OpeningTerm;
+
+    void addCluster(const TCluster& cl, bool fill);
+
+    // scratch space for the sweep
+    mutable std::vector<double> clusterEnergies;
+};
+
+}}} // namespace ant::calibration::detail
@@ -22,11 +22,13 @@ Cocktail::Cocktail(const string& outfile,
                    bool saveUnstable, bool doBulk,
                    const int verbosity,
                    const string& energyDistribution,
-                   const data::Query::ChannelSelector_t& selector):
+                   const data::Query::ChannelSelector_t& selector,
+                   unsigned seed):
     _fileOutput(outfile),
     _energies(energies),
     _settings(saveUnstable,doBulk),
-    ChannelSelector(selector)
+    ChannelSelector(selector),
+    _seed(seed)
 {
     sort(_energies.begin(), _energies.end());
     _energyFunction = TF1("beamEnergy",energyDistribution.c_str(),_energies.front(),_energies.back());
@@ -48,7 +50,7 @@ void Cocktail::initLUT()
     _data = _fileOutput.CreateInside<TTree>("data","Event data");
 
     // -- Init root - random engine ---
-    _rndEngine = new TRandom3(0);
+    _rndEngine = new TRandom3(_seed);
 
     for(double energy : _energies)
     {
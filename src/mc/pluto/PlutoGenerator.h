@@ -88,6 +88,7 @@ private:
     std::vector<BinContent> _energyBins;
 
     //-- Tools ---
+    const unsigned _seed;
     TRandom3* _rndEngine;
 
     void initLUT();
@@ -102,13 +103,18 @@ private:
 
 public:
 
+    /**
+     * @param seed for drawing the reactions, 0 means random seed.
+     *        Note that Pluto itself uses gRandom for the decays.
+     */
     Cocktail(const std::string& outfile,
              const std::vector<double>& energies,
              bool saveUnstable = 0, bool doBulk = 1,
              const int verbosity = 0,
              const std::string& energyDistribution = "1.0 / x",
              const data::Query::ChannelSelector_t& selector
-                        = data::Query::GetSelector(data::Query::Selection::All));
+                        = data::Query::GetSelector(data::Query::Selection::All),
+             unsigned seed = 0);
 
     virtual unsigned long Sample(const unsigned long &nevts) const override;
 
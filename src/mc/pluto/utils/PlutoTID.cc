@@ -8,6 +8,7 @@
 #include "TRandom2.h"
 
 #include <ctime>
+#include <limits>
 
 using namespace std;
 using namespace ant;
@@ -23,8 +24,15 @@ bool CheckExists(WrapTFile& file, const std::string& name) {
 }
 
 void PlutoTID::AddTID(const std::string &filename)
+{
+    AddTID(filename, std::time(nullptr), 0, 0);
+}
+
+void PlutoTID::AddTID(const string& filename, uint32_t timestamp, uint64_t firstEvent, unsigned seed)
 {
     const auto random_bits = 4;
+    const auto counter_bits = sizeof(TID::Lower)*8 - random_bits;
+    const auto counter_mask = (uint64_t(1) << counter_bits) - 1;
 
     WrapTFileOutput file(filename, true, WrapTFileOutput::mode_t::update);
 
@@ -39,23 +47,27 @@ void PlutoTID::AddTID(const std::string &filename)
 
         TTree* data_tid = file.CreateInside<TTree>(tidtree_name.c_str(),"Ant-TID for pluto data");
 
-        TID tid(std::time(nullptr), 0, {TID::Flags_t::MC});
+        TID tid(timestamp, 0, {TID::Flags_t::MC});
 
         data_tid->Branch("tid",&tid);
 
         auto nEvents = data->GetEntries();
 
-        if(nEvents >= 1 << (sizeof(TID::Lower)*8 - random_bits)) {
+        // the event counter continues in the timestamp
+        const uint64_t lastEvent = firstEvent + nEvents;
+        if((lastEvent >> counter_bits) > numeric_limits<uint32_t>::max() - timestamp) {
            throw std::runtime_error("Too many entries to fit into TID together with random bits.");
         }
 
         TRandom2 rng;
-        rng.SetSeed();
+        rng.SetSeed(seed);
 
         for(decltype(nEvents) i=0; i<nEvents; ++i) {
 
             unsigned r = floor(rng.Uniform(1 << random_bits));
-            tid.Lower = (i << random_bits) + r;
+            const uint64_t event = firstEvent + i;
+            tid.Timestamp = timestamp + uint32_t(event >> counter_bits);
+            tid.Lower = (uint32_t(event & counter_mask) << random_bits) + r;
 
             data_tid->Fill();
         }
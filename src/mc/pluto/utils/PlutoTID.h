@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 
 namespace ant {
 namespace mc {
@@ -22,6 +23,19 @@ struct PlutoTID {
      */
     static void AddTID(const std::string& filename);
 
+    /**
+     * @brief Add a TID Tree to a chunk of a sharded pluto production
+     * @param filename File to edit
+     * @param timestamp of the first 2^28 events of the production
+     * @param firstEvent event counter of the first entry, makes TIDs of different chunks disjoint
+     * @param seed for the random bits, 0 means random seed
+     *
+     * TID::Lower holds the lower 28 bits of the event counter and 4 random bits.
+     * The higher bits of the event counter are added to the timestamp, so each further 2^28 events
+     * use the next second. Productions started less than that many seconds apart might thus share TIDs.
+     */
+    static void AddTID(const std::string& filename, std::uint32_t timestamp, std::uint64_t firstEvent, unsigned seed);
+
     static void CopyTIDPlutoGeant(const std::string& pluto_filename, const std::string& geant_filename);
 };
 
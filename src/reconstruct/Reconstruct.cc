@@ -82,44 +82,68 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
     if(reconstructed.DetectorReadHits.empty())
         return;
 
-    // update the updateables :)
-    updateablemanager->UpdateParameters(reconstructed.ID);
+    // the hooks run between the other stages,
+    // their times are summed up and recorded once per event
+    StageTimer::sum_t hooks(timers.Hooks);
 
-    // apply the hooks for detector read hits (mostly calibrations),
-    // note that this also changes the hits itself
+    {
+        StageTimer::sum_t::scope_t t(hooks);
 
-    ApplyHooksToReadHits(reconstructed.DetectorReadHits);
-    // the detectorReads are now calibrated as far as possible
-    // one might return now and detectorRead is just calibrated...
+        // update the updateables :)
+        updateablemanager->UpdateParameters(reconstructed.ID);
 
+        // apply the hooks for detector read hits (mostly calibrations),
+        // note that this also changes the hits itself
+        ApplyHooksToReadHits(reconstructed.DetectorReadHits);
+        // the detectorReads are now calibrated as far as possible
+        // one might return now and detectorRead is just calibrated...
+    }
 
     // do the hit matching, which builds the TClusterHit's
     // put into the AdaptorTClusterHit to track Energy/Timing information
     // for subsequent clustering
     sorted_bydetectortype_t<TClusterHit> sorted_clusterhits;
-    BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    {
+        StageTimer::scope_t t(timers.Hits);
+        BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    }
 
     // apply hooks which modify clusterhits
-    for(const auto& hook : hooks_clusterhits) {
-        hook->ApplyTo(sorted_clusterhits);
+    {
+        StageTimer::sum_t::scope_t t(hooks);
+        for(const auto& hook : hooks_clusterhits) {
+            hook->ApplyTo(sorted_clusterhits);
+        }
     }
 
     // then build clusters (at least for calorimeters this is not trivial)
     sorted_clusters_t sorted_clusters;
-    BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    {
+        StageTimer::scope_t t(timers.Clustering);
+        BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    }
 
     // apply hooks which modify clusters
-    for(const auto& hook : hooks_clusters) {
-        hook->ApplyTo(sorted_clusters);
+    {
+        StageTimer::sum_t::scope_t t(hooks);
+        for(const auto& hook : hooks_clusters) {
+            hook->ApplyTo(sorted_clusters);
+        }
     }
 
     // do the candidate building
-    candidatebuilder->Build(move(sorted_clusters),
-                            reconstructed.Candidates, reconstructed.Clusters);
+    {
+        StageTimer::scope_t t(timers.Candidates);
+        candidatebuilder->Build(move(sorted_clusters),
+                                reconstructed.Candidates, reconstructed.Clusters);
+    }
 
     // apply hooks which may modify the whole event
-    for(const auto& hook : hooks_eventdata) {
-        hook->ApplyTo(reconstructed);
+    {
+        StageTimer::sum_t::scope_t t(hooks);
+        for(const auto& hook : hooks_eventdata) {
+            hook->ApplyTo(reconstructed);
+        }
     }
 
 }
@@ -5,6 +5,8 @@
 
 #include "Reconstruct_traits.h"
 
+#include "base/StageTimer.h"
+
 namespace ant {
 
 struct TTaggerHit;
@@ -103,6 +105,16 @@ protected:
     const clustering_t       clustering;
     const candidatebuilder_t candidatebuilder;
     const std::unique_ptr<reconstruct::UpdateableManager> updateablemanager;
+
+    // timing of the reconstruction steps,
+    // reported by the PhysicsManager
+    struct timers_t {
+        StageTimer Hooks{"Reconstruct/Hooks"};
+        StageTimer Hits{"Reconstruct/Hits"};
+        StageTimer Clustering{"Reconstruct/Clustering"};
+        StageTimer Candidates{"Reconstruct/Candidates"};
+    };
+    mutable timers_t timers;
 };
 
 }
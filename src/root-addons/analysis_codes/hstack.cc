@@ -124,7 +124,7 @@ void hstack::checkHists()
 {
     auto it_hist = hists.begin();
     while(it_hist != hists.end()) {
-        hist_t hist = *it_hist;
+        hist_t& hist = *it_hist;
         if(hist.Ptr == nullptr) {
             // try to get it now, might be that after merge
             // the Ptr is not yet initialized
@@ -518,8 +518,12 @@ Long64_t hstack::Merge(TCollection* li, TFileMergeInfo*)
             return false;
         };
         for(const auto& hist : h->hists) {
-            if(!have_path(hists, hist.Path))
+            if(!have_path(hists, hist.Path)) {
                 hists.emplace_back(hist);
+                // the merged hstack might be gone soon,
+                // so look up the histogram by path later
+                hists.back().Ptr = nullptr;
+            }
         }
     }
 
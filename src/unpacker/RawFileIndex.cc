@@ -0,0 +1,191 @@
+#include "RawFileIndex.h"
+
+#include "base/std_ext/memory.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstring> // for strerror
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace ant;
+
+constexpr streamsize RawFileIndex::AccessPointSpacing;
+bool RawFileIndex::CreateOnRead = false;
+
+namespace {
+
+const string magic = "AntRawFileIndex";
+constexpr uint32_t version = 1;
+
+// the index is outdated if the raw file changed
+struct stamp_t {
+    int64_t Size = 0;
+    int64_t MTime = 0;
+    bool operator==(const stamp_t& o) const { return Size == o.Size && MTime == o.MTime; }
+};
+
+stamp_t get_stamp(const string& rawfile) {
+    struct stat st;
+    if(stat(rawfile.c_str(), &st) != 0)
+        throw RawFileIndex::Exception("Cannot stat "+rawfile+": "+strerror(errno));
+    stamp_t stamp;
+    stamp.Size = st.st_size;
+    stamp.MTime = st.st_mtime;
+    return stamp;
+}
+
+template<typename T>
+void write_pod(ostream& s, const T& v) {
+    s.write(reinterpret_cast<const char*>(addressof(v)), sizeof(T));
+}
+
+template<typename T>
+void read_pod(istream& s, T& v) {
+    s.read(reinterpret_cast<char*>(addressof(v)), sizeof(T));
+}
+
+template<typename T>
+void write_vector(ostream& s, const vector<T>& v) {
+    write_pod(s, uint64_t(v.size()));
+    s.write(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(T));
+}
+
+template<typename T>
+void read_vector(istream& s, vector<T>& v) {
+    uint64_t size = 0;
+    read_pod(s, size);
+    if(!s)
+        return;
+    v.resize(size);
+    s.read(reinterpret_cast<char*>(v.data()), v.size()*sizeof(T));
+}
+
+}
+
+unique_ptr<RawFileIndex> RawFileIndex::Load(const string& rawfile)
+{
+    ifstream s(GetFilename(rawfile), ios::binary);
+    if(!s)
+        return nullptr;
+
+    string magic_(magic.size(), '\0');
+    s.read(&magic_[0], magic_.size());
+    uint32_t version_ = 0;
+    read_pod(s, version_);
+    if(!s || magic_ != magic || version_ != version)
+        return nullptr;
+
+    stamp_t stamp;
+    read_pod(s, stamp.Size);
+    read_pod(s, stamp.MTime);
+    if(!(stamp == get_stamp(rawfile)))
+        return nullptr;
+
+    auto index = std_ext::make_unique<RawFileIndex>();
+
+    int64_t offset = 0, length = 0;
+    read_pod(s, offset);
+    read_pod(s, length);
+    index->FirstBufferOffset = offset;
+    index->RecordLength = length;
+
+    uint64_t nBuffers = 0;
+    read_pod(s, nBuffers);
+    index->Buffers.resize(nBuffers);
+    for(auto& b : index->Buffers) {
+        uint8_t hasScalers = 0;
+        read_pod(s, b.FirstEvent);
+        read_pod(s, b.nEvents);
+        read_pod(s, b.FirstAcquID);
+        read_pod(s, hasScalers);
+        b.HasScalers = hasScalers;
+    }
+
+    uint64_t nPoints = 0;
+    read_pod(s, nPoints);
+    index->AccessPoints.resize(nPoints);
+    for(auto& p : index->AccessPoints) {
+        int64_t out = 0, in = 0;
+        int32_t bits = 0;
+        read_pod(s, out);
+        read_pod(s, in);
+        read_pod(s, bits);
+        p.Out = out;
+        p.In = in;
+        p.Bits = bits;
+        read_vector(s, p.Window);
+    }
+
+    if(!s)
+        return nullptr;
+    return index;
+}
+
+void RawFileIndex::Save(const string& rawfile) const
+{
+    const auto stamp = get_stamp(rawfile);
+
+    // write to temporary file first, so that
+    // concurrent readers never see half-written indices
+    const auto filename = GetFilename(rawfile);
+    const auto tmpfilename = filename + "." + to_string(getpid());
+    {
+        ofstream s(tmpfilename, ios::binary);
+        if(!s)
+            throw Exception("Cannot open "+tmpfilename+": "+strerror(errno));
+
+        s.write(magic.data(), magic.size());
+        write_pod(s, version);
+        write_pod(s, stamp.Size);
+        write_pod(s, stamp.MTime);
+
+        write_pod(s, int64_t(FirstBufferOffset));
+        write_pod(s, int64_t(RecordLength));
+
+        write_pod(s, uint64_t(Buffers.size()));
+        for(auto& b : Buffers) {
+            write_pod(s, b.FirstEvent);
+            write_pod(s, b.nEvents);
+            write_pod(s, b.FirstAcquID);
+            write_pod(s, uint8_t(b.HasScalers));
+        }
+
+        write_pod(s, uint64_t(AccessPoints.size()));
+        for(auto& p : AccessPoints) {
+            write_pod(s, int64_t(p.Out));
+            write_pod(s, int64_t(p.In));
+            write_pod(s, int32_t(p.Bits));
+            write_vector(s, p.Window);
+        }
+
+        s.close();
+        if(!s) {
+            remove(tmpfilename.c_str());
+            throw Exception("Error while writing "+tmpfilename+": "+strerror(errno));
+        }
+    }
+
+    if(rename(tmpfilename.c_str(), filename.c_str()) != 0) {
+        remove(tmpfilename.c_str());
+        throw Exception("Cannot rename index to "+filename+": "+strerror(errno));
+    }
+}
+
+size_t RawFileIndex::FindBuffer(uint32_t event) const
+{
+    // buffers without events share their FirstEvent with the following buffer,
+    // so the last buffer starting at or before event is the right one
+    auto it = upper_bound(Buffers.begin(), Buffers.end(), event,
+                          [] (uint32_t e, const buffer_t& b) { return e < b.FirstEvent; });
+    if(it == Buffers.begin())
+        return Buffers.size();
+    --it;
+    if(event - it->FirstEvent >= it->nEvents)
+        return Buffers.size();
+    return distance(Buffers.begin(), it);
+}
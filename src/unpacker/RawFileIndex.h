@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RawFileReader.h"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace ant {
+
+/**
+ * @brief The RawFileIndex class maps event numbers to positions in raw files
+ *
+ * Acqu raw files consist of records of fixed size, each containing complete events.
+ * The index knows the events of each record, so the unpacker can start reading
+ * at the record containing the requested event instead of unpacking all previous ones.
+ * It is stored as a sidecar file next to the raw file.
+ */
+class RawFileIndex {
+public:
+
+    struct buffer_t {
+        std::uint32_t FirstEvent;   // TID lower of first event
+        std::uint32_t nEvents;      // number of successfully unpacked events
+        std::uint32_t FirstAcquID;  // Acqu's serial ID of first event
+        bool HasScalers;
+    };
+
+    std::streamsize FirstBufferOffset = 0; // in bytes of uncompressed data
+    std::streamsize RecordLength = 0;      // in bytes
+    std::vector<buffer_t> Buffers;
+
+    // for gzip'ed raw files
+    RawFileReader::access_points_t AccessPoints;
+
+    /// distance of recorded gzip access points
+    static constexpr std::streamsize AccessPointSpacing = 1 << 26;
+
+    /// unpacker creates the index when reading a file completely, if not present
+    static bool CreateOnRead;
+
+    static std::string GetFilename(const std::string& rawfile) {
+        return rawfile + ".idx";
+    }
+
+    /**
+     * @brief Load the index for the given raw file
+     * @param rawfile
+     * @return the index, nullptr if not present or outdated
+     */
+    static std::unique_ptr<RawFileIndex> Load(const std::string& rawfile);
+
+    /**
+     * @brief Save the index next to the given raw file
+     * @param rawfile
+     *
+     * Throws Exception if writing fails
+     */
+    void Save(const std::string& rawfile) const;
+
+    /**
+     * @brief FindBuffer containing the given event
+     * @param event the TID lower of the event
+     * @return index in Buffers, or Buffers.size() if not found
+     */
+    size_t FindBuffer(std::uint32_t event) const;
+
+    std::streamsize GetOffset(size_t buffer) const {
+        return FirstBufferOffset + buffer*RecordLength;
+    }
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+};
+
+} // namespace ant
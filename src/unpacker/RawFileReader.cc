@@ -7,6 +7,15 @@
 #include <cstring> // for strerror
 #include <limits>
 #include <iomanip>
+#include <algorithm>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 extern "C" {
 #include <lzma.h>
@@ -16,6 +25,13 @@ extern "C" {
 using namespace std;
 using namespace ant;
 
+namespace {
+// deflate refers back at most 32k bytes
+constexpr streamsize gz_window_size = 1 << 15;
+}
+
+RawFileReader::live_t RawFileReader::Live;
+
 ant::RawFileReader::~RawFileReader() {}
 
 double RawFileReader::PercentDone() const
@@ -23,7 +39,22 @@ double RawFileReader::PercentDone() const
     return double(p->pos()) / double(p->filesize_total());
 }
 
+bool RawFileReader::IsSocket(const string& filename)
+{
+    struct stat st;
+    if(stat(filename.c_str(), &st) != 0)
+        return false;
+    return S_ISSOCK(st.st_mode);
+}
+
 void RawFileReader::open(const string& filename, const size_t inbufsize) {
+    // sockets cannot be opened as files
+    if(IsSocket(filename)) {
+        p = std_ext::make_unique<LiveSource>(filename, true);
+        progress = MakeProgressCounter();
+        return;
+    }
+
     // open it as plain raw file
     ifstream file(filename.c_str());
 
@@ -39,13 +70,49 @@ void RawFileReader::open(const string& filename, const size_t inbufsize) {
     } else if(GZ::test(file)) {
         p = std_ext::make_unique<GZ>(filename, inbufsize);
     }
+    else if(Live.FollowFiles) {
+        p = std_ext::make_unique<LiveSource>(filename, false);
+    }
     else {
         p = std_ext::make_unique<PlainBase>(filename);
     }
 
+    if(Live.FollowFiles && !p->live())
+        LOG(WARNING) << "Cannot follow compressed file " << filename << ", reading until its current end";
+
     progress = MakeProgressCounter();
 }
 
+void RawFileReader::seek(streamsize pos, const access_points_t& access_points)
+{
+    p->seek(pos, access_points);
+    totalBytesRead = pos;
+    last_totalBytesRead = pos;
+}
+
+void RawFileReader::record_access_points(streamsize spacing)
+{
+    p->record_access_points(spacing);
+}
+
+const RawFileReader::access_points_t& RawFileReader::recorded_access_points() const
+{
+    static const access_points_t none;
+    auto points = p->access_points();
+    return points ? *points : none;
+}
+
+void RawFileReader::PlainBase::skip(streamsize n)
+{
+    vector<char> scratch(min<streamsize>(n, 1 << 20));
+    while(n > 0) {
+        read(scratch.data(), min<streamsize>(n, scratch.size()));
+        if(gcount() == 0)
+            throw Exception("Cannot seek beyond end of file");
+        n -= gcount();
+    }
+}
+
 RawFileReader::progress_t RawFileReader::MakeProgressCounter()
 {
     // in future, there might be more than one compressed reader
@@ -83,8 +150,106 @@ RawFileReader::progress_t RawFileReader::MakeProgressCounter()
     return std_ext::make_unique<ProgressCounter>(updater);
 }
 
+RawFileReader::LiveSource::LiveSource(const string& filename, bool socket_) :
+    socket(socket_),
+    settings(Live)
+{
+    if(socket) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if(filename.size() >= sizeof(addr.sun_path))
+            throw Exception("Socket path too long: "+filename);
+        filename.copy(addr.sun_path, filename.size());
+
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    else {
+        fd = ::open(filename.c_str(), O_RDONLY);
+    }
+
+    if(fd < 0)
+        throw Exception(string("Error when opening live source ")
+                        +filename
+                        +": "
+                        +string(strerror(errno)));
+}
+
+RawFileReader::LiveSource::~LiveSource()
+{
+    if(fd >= 0)
+        ::close(fd);
+}
+
+bool RawFileReader::LiveSource::wait(chrono::steady_clock::time_point last_data)
+{
+    // returns false if no more data should be waited for
+    int timeout_ms = -1;
+    if(settings.Timeout > 0) {
+        const chrono::duration<double> waited = chrono::steady_clock::now() - last_data;
+        if(waited.count() >= settings.Timeout)
+            return false;
+        timeout_ms = 1000*(settings.Timeout - waited.count()) + 1;
+    }
+
+    if(socket) {
+        pollfd pfd{fd, POLLIN, 0};
+        const int ret = poll(&pfd, 1, timeout_ms);
+        // ret==0 is timeout, and a signal (like SIGINT) stops waiting as well
+        if(ret < 0 && errno != EINTR) {
+            failed = true;
+            throw Exception(string("Error while waiting for socket: ")+string(strerror(errno)));
+        }
+        return ret > 0;
+    }
+
+    // regular files are always readable, so just sleep some time
+    const int poll_ms = 1000*settings.PollInterval;
+    return poll(nullptr, 0, timeout_ms < 0 ? poll_ms : min(poll_ms, timeout_ms)) == 0;
+}
+
+void RawFileReader::LiveSource::read(char* s, streamsize n)
+{
+    gcount_ = 0;
+    auto last_data = chrono::steady_clock::now();
+
+    while(gcount_ < n) {
+        const auto r = ::read(fd, s+gcount_, n-gcount_);
+        if(r > 0) {
+            gcount_ += r;
+            pos_ += r;
+            last_data = chrono::steady_clock::now();
+            continue;
+        }
+        if(r < 0 && errno != EINTR && errno != EAGAIN) {
+            failed = true;
+            throw Exception(string("Error while reading from live source: ")+string(strerror(errno)));
+        }
+        // a closed socket ends the stream,
+        // a file is only at its current end and might grow
+        if(socket && r == 0) {
+            eof_ = true;
+            return;
+        }
+        if(!wait(last_data)) {
+            eof_ = true;
+            return;
+        }
+    }
+}
+
 struct RawFileReader::XZ::lzma_stream : ::lzma_stream {};
 
+struct RawFileReader::XZ::xz_index {
+    lzma_index* idx = nullptr;
+    lzma_index_iter iter;
+    lzma_stream_flags flags;
+    ~xz_index() { lzma_index_end(idx, nullptr); }
+};
+
 RawFileReader::XZ::XZ(const std::string &filename, const size_t inbufsize) :
     PlainBase(filename),
     inbuf(inbufsize),
@@ -100,6 +265,112 @@ RawFileReader::XZ::XZ(const std::string &filename, const size_t inbufsize) :
 
 RawFileReader::XZ::~XZ() {}
 
+void RawFileReader::XZ::load_index()
+{
+    // the index is located just before the stream footer,
+    // only files consisting of one stream are supported
+    const streamsize size = filesize_total();
+    if(size < 2*LZMA_STREAM_HEADER_SIZE)
+        return;
+
+    uint8_t buf[LZMA_STREAM_HEADER_SIZE];
+    lzma_stream_flags header_flags;
+    seek_file(0);
+    PlainBase::read(reinterpret_cast<char*>(buf), sizeof(buf));
+    if(lzma_stream_header_decode(&header_flags, buf) != LZMA_OK)
+        return;
+
+    lzma_stream_flags footer_flags;
+    seek_file(size - LZMA_STREAM_HEADER_SIZE);
+    PlainBase::read(reinterpret_cast<char*>(buf), sizeof(buf));
+    if(lzma_stream_footer_decode(&footer_flags, buf) != LZMA_OK)
+        return;
+    if(lzma_stream_flags_compare(&header_flags, &footer_flags) != LZMA_OK)
+        return;
+
+    const streamsize index_size = footer_flags.backward_size;
+    if(size < 2*LZMA_STREAM_HEADER_SIZE + index_size)
+        return;
+    vector<uint8_t> index_buf(index_size);
+    seek_file(size - LZMA_STREAM_HEADER_SIZE - index_size);
+    PlainBase::read(reinterpret_cast<char*>(index_buf.data()), index_buf.size());
+
+    lzma_index* idx = nullptr;
+    uint64_t memlimit = UINT64_MAX;
+    size_t in_pos = 0;
+    if(lzma_index_buffer_decode(&idx, &memlimit, nullptr, index_buf.data(), &in_pos, index_buf.size()) != LZMA_OK)
+        return;
+
+    index = std_ext::make_unique<xz_index>();
+    index->idx = idx;
+    index->flags = header_flags;
+
+    // concatenated streams or stream padding
+    if(lzma_index_file_size(idx) != lzma_vli(size)) {
+        index = nullptr;
+        return;
+    }
+
+    lzma_index_iter_init(&index->iter, idx);
+}
+
+void RawFileReader::XZ::init_block_decoder()
+{
+    // the block header tells how to decode the block
+    seek_file(index->iter.block.compressed_file_offset);
+
+    uint8_t header[LZMA_BLOCK_HEADER_SIZE_MAX];
+    PlainBase::read(reinterpret_cast<char*>(header), 1);
+
+    lzma_filter filters[LZMA_FILTERS_MAX + 1];
+    lzma_block block{};
+    block.version = 1;
+    block.check = index->flags.check;
+    block.filters = filters;
+    block.header_size = lzma_block_header_size_decode(header[0]);
+    PlainBase::read(reinterpret_cast<char*>(header+1), block.header_size-1);
+    if(PlainBase::gcount() != block.header_size-1)
+        throw Exception("Compressed file is truncated");
+
+    if(lzma_block_header_decode(&block, nullptr, header) != LZMA_OK)
+        throw Exception("Cannot decode xz block header");
+
+    const auto ret_size = lzma_block_compressed_size(&block, index->iter.block.unpadded_size);
+    lzma_ret ret = ret_size == LZMA_OK ? lzma_block_decoder(strm.get(), &block) : ret_size;
+
+    // the decoder has copied the filter options
+    for(size_t i=0; filters[i].id != LZMA_VLI_UNKNOWN; i++)
+        free(filters[i].options);
+
+    if(ret != LZMA_OK)
+        throw Exception("Cannot initialize xz block decoder");
+
+    strm->avail_in = 0;
+    blockMode = true;
+    eof_ = false;
+}
+
+void RawFileReader::XZ::seek(streamsize pos, const access_points_t&)
+{
+    if(!index)
+        load_index();
+
+    if(index && !lzma_index_iter_locate(&index->iter, pos)) {
+        init_block_decoder();
+        skip(pos - index->iter.block.uncompressed_file_offset);
+        return;
+    }
+
+    // start all over if the index cannot be used
+    blockMode = false;
+    lzma_end(strm.get());
+    init_decoder();
+    seek_file(0);
+    strm->avail_in = 0;
+    eof_ = false;
+    skip(pos);
+}
+
 bool RawFileReader::XZ::test(ifstream& file) {
 
     const vector<char> magic_bytes_xz{ static_cast<char>(0xFD), '7', 'z', 'X', 'Z', 0x00 };
@@ -168,6 +439,17 @@ void RawFileReader::XZ::read(char* s, streamsize n) {
 
         lzma_ret ret = lzma_code(strm.get(), action);
 
+        // in block mode, the next block needs a new decoder
+        if(ret == LZMA_STREAM_END && blockMode
+           && !lzma_index_iter_next(&index->iter, LZMA_INDEX_ITER_BLOCK)) {
+            auto next_out = strm->next_out;
+            auto avail_out = strm->avail_out;
+            init_block_decoder();
+            strm->next_out = next_out;
+            strm->avail_out = avail_out;
+            continue;
+        }
+
         if(ret == LZMA_STREAM_END) {
             gcount_ = n - strm->avail_out; // number of decompressed bytes
             if(strm->avail_out > 0)
@@ -235,6 +517,71 @@ RawFileReader::GZ::GZ(const std::string &filename, const size_t inbufsize) :
 
 RawFileReader::GZ::~GZ() {}
 
+void RawFileReader::GZ::add_to_window(const uint8_t* data, streamsize n)
+{
+    // the window is filled up to its maximum size first,
+    // then the oldest data is overwritten
+    while(n > 0) {
+        const auto pos = streamsize(strm->total_out - n) % gz_window_size;
+        const auto k = min(n, gz_window_size - pos);
+        if(window.size() < size_t(pos+k))
+            window.resize(pos+k);
+        copy(data, data+k, window.begin()+pos);
+        data += k;
+        n -= k;
+    }
+}
+
+void RawFileReader::GZ::add_access_point()
+{
+    access_point_t point;
+    point.Out = strm->total_out;
+    point.In = strm->total_in;
+    point.Bits = strm->data_type & 7;
+    // unroll the ring buffer
+    const auto pos = streamsize(strm->total_out) % gz_window_size;
+    if(streamsize(strm->total_out) < gz_window_size) {
+        point.Window = window;
+    }
+    else {
+        point.Window.assign(window.begin()+pos, window.end());
+        point.Window.insert(point.Window.end(), window.begin(), window.begin()+pos);
+    }
+    points.emplace_back(move(point));
+    last_point = strm->total_out;
+}
+
+void RawFileReader::GZ::seek(streamsize pos, const access_points_t& access_points)
+{
+    // recorded positions are only valid when reading from beginning
+    spacing = 0;
+    strm->avail_in = 0;
+    eof_ = false;
+
+    auto it = upper_bound(access_points.begin(), access_points.end(), pos,
+                          [] (streamsize v, const access_point_t& p) { return v < p.Out; });
+    if(it == access_points.begin()) {
+        // start all over
+        inflateReset2(strm.get(), 15+32);
+        seek_file(0);
+        skip(pos);
+        return;
+    }
+    const access_point_t& point = *prev(it);
+
+    // see zran.c of zlib examples,
+    // the access point is inside the raw deflate stream
+    inflateReset2(strm.get(), -15);
+    seek_file(point.In - (point.Bits ? 1 : 0));
+    if(point.Bits) {
+        uint8_t byte;
+        PlainBase::read(reinterpret_cast<char*>(&byte), 1);
+        inflatePrime(strm.get(), point.Bits, byte >> (8 - point.Bits));
+    }
+    inflateSetDictionary(strm.get(), point.Window.data(), point.Window.size());
+    skip(pos - point.Out);
+}
+
 bool RawFileReader::GZ::test(ifstream& file) {
 
     // check some magic bytes in the beginning
@@ -308,7 +655,17 @@ void RawFileReader::GZ::read(char* s, streamsize n) {
             }
         }
 
-        int ret = inflate(strm.get(), action);
+        // stop at block boundaries if access points are recorded
+        const auto next_out = strm->next_out;
+        int ret = inflate(strm.get(), spacing > 0 ? Z_BLOCK : action);
+
+        if(spacing > 0) {
+            add_to_window(next_out, strm->next_out - next_out);
+            // at end of block, but not at the end of the last block
+            if((strm->data_type & 128) && !(strm->data_type & 64)
+               && (strm->total_out == 0 || streamsize(strm->total_out) - last_point > spacing))
+                add_access_point();
+        }
 
         if(ret == Z_STREAM_END) {
             gcount_ = n - strm->avail_out; // number of decompressed bytes
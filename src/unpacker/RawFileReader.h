@@ -7,6 +7,7 @@
 #include <memory>
 #include <cstdint>
 #include <vector>
+#include <chrono>
 
 namespace ant {
 
@@ -28,10 +29,75 @@ public:
    * @param filename
    * @param inbufsize
    *
-   * Parameter inbufsize is ignored if non-compressed data is read
+   * Parameter inbufsize is ignored if non-compressed data is read.
+   * UNIX sockets are always read live, see live_t
    */
     void open(const std::string& filename, const size_t inbufsize = BUFSIZ);
 
+    /**
+     * @brief The live_t struct configures reading from live sources
+     *
+     * Live sources are UNIX sockets or, if FollowFiles is set, uncompressed
+     * files still being written. Reading them waits for more data instead of
+     * stopping at the current end, until Timeout passes without new data,
+     * the writer closes the socket or a signal arrives.
+     */
+    struct live_t {
+        bool   FollowFiles = false;
+        double Timeout = 0;         // in seconds, 0 waits forever
+        double PollInterval = 0.05; // in seconds, for growing files
+    };
+    static live_t Live;
+
+    /**
+     * @brief IsLive
+     * @return true if reading from a socket or a followed file
+     */
+    bool IsLive() const {
+        return p->live();
+    }
+
+    static bool IsSocket(const std::string& filename);
+
+    /**
+     * @brief The access_point_t struct allows to start decompressing gzip files in the middle
+     *
+     * See zran.c of the zlib examples, Window holds the preceding uncompressed data
+     */
+    struct access_point_t {
+        std::streamsize Out;  // position in uncompressed data
+        std::streamsize In;   // position in compressed file
+        int Bits;             // number of bits of the byte before In to be used
+        std::vector<std::uint8_t> Window;
+    };
+    using access_points_t = std::vector<access_point_t>;
+
+    /**
+     * @brief seek to the given position in the uncompressed data
+     * @param pos
+     * @param access_points only used for gzip files, if empty decompression starts from beginning
+     *
+     * Xz files are decompressed from the block containing pos,
+     * so files with many blocks (see RawFileWriter) are seeked fast
+     */
+    void seek(std::streamsize pos, const access_points_t& access_points = {});
+
+    /**
+     * @brief tellg
+     * @return position in uncompressed data
+     */
+    std::streamsize tellg() const {
+        return totalBytesRead;
+    }
+
+    /**
+     * @brief record_access_points while reading gzip files, ignored for other files
+     * @param spacing minimum distance of access points in uncompressed data
+     */
+    void record_access_points(std::streamsize spacing);
+
+    const access_points_t& recorded_access_points() const;
+
     /**
    * @brief operator bool
    *
@@ -149,6 +215,30 @@ private:
 
         virtual std::streamsize pos() const { return gcount_total; }
 
+        virtual bool live() const { return false; }
+
+        virtual void seek(std::streamsize pos, const access_points_t&) {
+            seek_file(pos);
+        }
+
+        virtual void record_access_points(std::streamsize) {}
+
+        virtual const access_points_t* access_points() const { return nullptr; }
+
+    protected:
+        // for derived classes not reading via ifstream
+        PlainBase() : filesize(0), gcount_total(0) {}
+
+        // position in the underlying file
+        void seek_file(std::streamsize pos) {
+            file.clear();
+            file.seekg(pos);
+            gcount_total = pos;
+        }
+
+        // read and discard n bytes
+        void skip(std::streamsize n);
+
     private:
         std::ifstream file;
         std::streamsize filesize;
@@ -189,6 +279,8 @@ private:
             return eof_;
         }
 
+        virtual void seek(std::streamsize pos, const access_points_t&) override;
+
     private:
         std::vector<uint8_t> inbuf;
         bool decompressFailed;
@@ -203,6 +295,14 @@ private:
         deleted_unique_ptr<lzma_stream> strm;
         void init_decoder();
 
+        // after seeking, single blocks are decoded
+        // with help of the index at the end of the file
+        struct xz_index;
+        std::unique_ptr<xz_index> index;
+        bool blockMode = false;
+        void load_index();
+        void init_block_decoder();
+
     }; // class RawFileReader::XZ
 
 
@@ -233,6 +333,16 @@ private:
             return eof_;
         }
 
+        virtual void seek(std::streamsize pos, const access_points_t& access_points) override;
+
+        virtual void record_access_points(std::streamsize spacing_) override {
+            spacing = spacing_;
+        }
+
+        virtual const access_points_t* access_points() const override {
+            return std::addressof(points);
+        }
+
     private:
         std::vector<uint8_t> inbuf;
         bool decompressFailed;
@@ -247,9 +357,73 @@ private:
         deleted_unique_ptr<gz_stream> strm;
         void init_decoder();
 
+        // access point recording, only possible when reading from the beginning
+        std::streamsize spacing = 0;
+        access_points_t points;
+        std::vector<uint8_t> window; // ring buffer of last uncompressed data
+        std::streamsize last_point = 0;
+        void add_to_window(const uint8_t* data, std::streamsize n);
+        void add_access_point();
+
     }; // class RawFileReader::GZ
 
 
+    /**
+     * @brief The LiveSource class reads sockets or growing files
+     *
+     * Uses plain POSIX IO, since ifstream cannot wait for more data
+     */
+    class LiveSource : public PlainBase {
+    public:
+
+        LiveSource(const std::string& filename, bool socket);
+
+        virtual ~LiveSource();
+
+        virtual explicit operator bool() const override {
+            return fd >= 0 && !failed;
+        }
+
+        virtual void read(char *s, std::streamsize n) override;
+
+        virtual std::streamsize gcount() const override {
+            return gcount_;
+        }
+
+        virtual bool eof() const override {
+            return eof_;
+        }
+
+        // size is unknown while the source is still written
+        virtual std::streamsize filesize_remaining() const override {
+            return 0;
+        }
+
+        virtual std::streamsize filesize_total() const override {
+            return pos_;
+        }
+
+        virtual std::streamsize pos() const override { return pos_; }
+
+        virtual bool live() const override { return true; }
+
+        virtual void seek(std::streamsize, const access_points_t&) override {
+            throw Exception("Cannot seek in live source");
+        }
+
+    private:
+        int fd;
+        const bool socket;
+        const live_t settings;
+        bool failed = false;
+        bool eof_ = false;
+        std::streamsize gcount_ = 0;
+        std::streamsize pos_ = 0;
+
+        bool wait(std::chrono::steady_clock::time_point last_data);
+    }; // class RawFileReader::LiveSource
+
+
     // private stuff for RawFileReader
     std::unique_ptr<PlainBase> p;
 
@@ -0,0 +1,252 @@
+#include "RawFileWriter.h"
+
+#include "base/std_ext/memory.h"
+
+#include <cstdio> // for BUFSIZ
+#include <cstring> // for strerror
+#include <cerrno>
+#include <limits>
+#include <algorithm>
+
+extern "C" {
+#include <lzma.h>
+#include <zlib.h>
+}
+
+using namespace std;
+using namespace ant;
+
+RawFileWriter::Compression_t RawFileWriter::GetCompression(const string& name)
+{
+    if(name == "none")
+        return Compression_t::None;
+    if(name == "gz")
+        return Compression_t::GZ;
+    if(name == "xz")
+        return Compression_t::XZ;
+    throw Exception("Unknown compression '"+name+"'");
+}
+
+RawFileWriter::RawFileWriter(const string& filename, Compression_t compression, unsigned level,
+                             streamsize blockSize)
+{
+    switch(compression) {
+    case Compression_t::None:
+        p = std_ext::make_unique<PlainBase>(filename);
+        break;
+    case Compression_t::GZ:
+        p = std_ext::make_unique<GZ>(filename, level);
+        break;
+    case Compression_t::XZ:
+        p = std_ext::make_unique<XZ>(filename, level, blockSize);
+        break;
+    }
+}
+
+RawFileWriter::~RawFileWriter()
+{
+    // never throw from destructor,
+    // call close() explicitly to see errors
+    try {
+        close();
+    }
+    catch(...) {}
+}
+
+void RawFileWriter::write(const char* s, streamsize n)
+{
+    if(!p)
+        throw Exception("Writing to closed file");
+    p->write(s, n);
+    bytesWritten += n;
+}
+
+void RawFileWriter::close()
+{
+    if(!p)
+        return;
+    // reset before finishing, so that a
+    // throwing finish is not called twice
+    auto p_ = move(p);
+    p_->finish();
+}
+
+RawFileWriter::PlainBase::PlainBase(const string& filename) :
+    file(filename.c_str(), ios::binary)
+{
+    if(!file)
+        throw Exception(string("Error when opening file ")
+                        +filename
+                        +": "
+                        +string(strerror(errno)));
+}
+
+void RawFileWriter::PlainBase::write(const char* s, streamsize n)
+{
+    file.write(s, n);
+    if(!file)
+        throw Exception(string("Error while writing to file: ")+string(strerror(errno)));
+}
+
+void RawFileWriter::PlainBase::finish()
+{
+    file.close();
+    if(!file)
+        throw Exception(string("Error while closing file: ")+string(strerror(errno)));
+}
+
+struct RawFileWriter::XZ::lzma_stream : ::lzma_stream {};
+
+RawFileWriter::XZ::XZ(const string& filename, unsigned level, streamsize blockSize_) :
+    PlainBase(filename),
+    outbuf(BUFSIZ),
+    blockSize(blockSize_),
+    strm(new lzma_stream(),
+         [] (lzma_stream* strm) { lzma_end(strm); delete strm; })
+{
+    // using C-style init is a bit messy in C++
+    using lzma_stream_pod = ::lzma_stream;
+    auto ptr = reinterpret_cast<lzma_stream_pod*>(strm.get());
+    *ptr = LZMA_STREAM_INIT;
+
+    lzma_ret ret = lzma_easy_encoder(strm.get(), level, LZMA_CHECK_CRC64);
+
+    switch (ret) {
+    case LZMA_OK:
+        return;
+    case LZMA_MEM_ERROR:
+        throw Exception("Memory allocation failed");
+    case LZMA_OPTIONS_ERROR:
+        throw Exception("Unsupported compression level");
+    default:
+        throw Exception("Unknown error, possibly a bug");
+    }
+}
+
+RawFileWriter::XZ::~XZ() {}
+
+void RawFileWriter::XZ::write(const char* s, streamsize n)
+{
+    while(n > 0) {
+        // do not write beyond the current block
+        const auto k = blockSize > 0 ? min(n, blockSize - blockBytes) : n;
+        strm->next_in = reinterpret_cast<const uint8_t*>(s);
+        strm->avail_in = k;
+        encode(LZMA_RUN);
+        s += k;
+        n -= k;
+        blockBytes += k;
+
+        // a full flush starts a new block
+        if(blockSize > 0 && blockBytes == blockSize) {
+            encode(LZMA_FULL_FLUSH);
+            blockBytes = 0;
+        }
+    }
+}
+
+void RawFileWriter::XZ::finish()
+{
+    strm->next_in = nullptr;
+    strm->avail_in = 0;
+    encode(LZMA_FINISH);
+    PlainBase::finish();
+}
+
+void RawFileWriter::XZ::encode(int action_)
+{
+    // flushing and finishing are done when LZMA_STREAM_END is returned
+    const auto action = static_cast<lzma_action>(action_);
+    const bool finish = action != LZMA_RUN;
+
+    while(true) {
+        strm->next_out = outbuf.data();
+        strm->avail_out = outbuf.size();
+
+        lzma_ret ret = lzma_code(strm.get(), action);
+
+        if(ret != LZMA_OK && ret != LZMA_STREAM_END)
+            throw Exception("Compression failed with lzma error code "+to_string(ret));
+
+        PlainBase::write(reinterpret_cast<const char*>(outbuf.data()), outbuf.size() - strm->avail_out);
+
+        if(ret == LZMA_STREAM_END)
+            return;
+        // all input consumed and output not full, so nothing pending
+        if(!finish && strm->avail_in == 0 && strm->avail_out > 0)
+            return;
+    }
+}
+
+struct RawFileWriter::GZ::gz_stream : ::z_stream {};
+
+RawFileWriter::GZ::GZ(const string& filename, unsigned level) :
+    PlainBase(filename),
+    outbuf(BUFSIZ),
+    strm(new gz_stream(),
+         [] (gz_stream* strm) { deflateEnd(strm); delete strm; })
+{
+    strm->zalloc   = Z_NULL;
+    strm->zfree    = Z_NULL;
+    strm->opaque   = Z_NULL;
+
+    //see http://www.zlib.net/manual.html#Advanced
+    constexpr int def_window_bits  = 15;
+    constexpr int enable_gzip_bits = 16;
+    constexpr int def_mem_level    = 8;
+
+    int ret = deflateInit2(strm.get(), level, Z_DEFLATED,
+                           def_window_bits + enable_gzip_bits, def_mem_level,
+                           Z_DEFAULT_STRATEGY);
+
+    switch (ret) {
+    case Z_OK:
+        return;
+    case Z_MEM_ERROR:
+        throw Exception("Memory allocation failed");
+    case Z_STREAM_ERROR:
+        throw Exception("Unsupported compression level");
+    default:
+        throw Exception("Unknown error, possibly a bug");
+    }
+}
+
+RawFileWriter::GZ::~GZ() {}
+
+void RawFileWriter::GZ::write(const char* s, streamsize n)
+{
+    // zlib's interface is not const-correct
+    strm->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(s));
+    strm->avail_in = n;
+    encode(false);
+}
+
+void RawFileWriter::GZ::finish()
+{
+    strm->next_in = Z_NULL;
+    strm->avail_in = 0;
+    encode(true);
+    PlainBase::finish();
+}
+
+void RawFileWriter::GZ::encode(bool finish)
+{
+    const int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+
+    while(true) {
+        strm->next_out = outbuf.data();
+        strm->avail_out = outbuf.size();
+
+        int ret = deflate(strm.get(), flush);
+
+        if(ret == Z_STREAM_ERROR)
+            throw Exception("Compression failed with zlib error code "+to_string(ret));
+
+        PlainBase::write(reinterpret_cast<const char*>(outbuf.data()), outbuf.size() - strm->avail_out);
+
+        if(ret == Z_STREAM_END)
+            return;
+        if(!finish && strm->avail_in == 0 && strm->avail_out > 0)
+            return;
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+namespace ant {
+
+/**
+ * @brief The RawFileWriter class
+ *
+ * Counterpart of the RawFileReader, writes binary files, optionally compressed.
+ * Possible IO errors are propagated as exceptions
+ */
+class RawFileWriter {
+public:
+
+    enum class Compression_t {
+        None, GZ, XZ
+    };
+
+    /**
+     * @brief GetCompression converts the name to the compression
+     * @param name one of "none", "gz", "xz"
+     * @return the compression, throws Exception if unknown
+     */
+    static Compression_t GetCompression(const std::string& name);
+
+    /**
+     * @brief RawFileWriter opens the given filename for writing
+     * @param filename
+     * @param compression
+     * @param level compression level, ignored if not compressed
+     * @param blockSize for xz, uncompressed size of independently readable blocks, 0 for one block
+     *
+     * Many xz blocks make seeking fast, see RawFileReader::seek
+     */
+    RawFileWriter(const std::string& filename,
+                  Compression_t compression = Compression_t::None,
+                  unsigned level = 6,
+                  std::streamsize blockSize = 0);
+
+    virtual ~RawFileWriter();
+
+    /**
+     * @brief write n bytes from buffer s
+     * @param s
+     * @param n
+     */
+    void write(const char* s, std::streamsize n);
+
+    void write(const std::uint32_t* s, std::streamsize n) {
+        write(reinterpret_cast<const char*>(s), n*sizeof(std::uint32_t));
+    }
+
+    /**
+     * @brief close flushes the compressor and closes the file, also called by destructor
+     */
+    void close();
+
+    /// number of uncompressed bytes written so far
+    std::streamsize BytesWritten() const { return bytesWritten; }
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
+private:
+
+    class PlainBase {
+    public:
+        explicit PlainBase(const std::string& filename);
+        virtual ~PlainBase() = default;
+        virtual void write(const char* s, std::streamsize n);
+        virtual void finish();
+    protected:
+        std::ofstream file;
+    };
+
+    class XZ : public PlainBase {
+    public:
+        XZ(const std::string& filename, unsigned level, std::streamsize blockSize);
+        virtual ~XZ();
+        virtual void write(const char* s, std::streamsize n) override;
+        virtual void finish() override;
+    private:
+        std::vector<std::uint8_t> outbuf;
+        const std::streamsize blockSize;
+        std::streamsize blockBytes = 0;
+
+        template<typename T>
+        using deleted_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
+
+        struct lzma_stream;
+        deleted_unique_ptr<lzma_stream> strm;
+        void encode(int action); // lzma_action
+    };
+
+    class GZ : public PlainBase {
+    public:
+        GZ(const std::string& filename, unsigned level);
+        virtual ~GZ();
+        virtual void write(const char* s, std::streamsize n) override;
+        virtual void finish() override;
+    private:
+        std::vector<std::uint8_t> outbuf;
+
+        template<typename T>
+        using deleted_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
+
+        struct gz_stream;
+        deleted_unique_ptr<gz_stream> strm;
+        void encode(bool finish);
+    };
+
+    std::unique_ptr<PlainBase> p;
+    std::streamsize bytesWritten = 0;
+
+}; // class RawFileWriter
+
+} // namespace ant
@@ -32,6 +32,7 @@ std::unique_ptr<Unpacker::Module> Unpacker::Get(const string& filename)
     }
 
     // hand over the unique ptr
+    modules.back()->filename = filename;
     return std::move(modules.back());
 }
 
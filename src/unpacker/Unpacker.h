@@ -23,6 +23,8 @@
 
 #include <string>
 #include <memory>
+#include <cstdint>
+#include <stdexcept>
 
 namespace ant {
 
@@ -46,9 +48,20 @@ public:
         virtual ~Module() = default;
         virtual TEvent NextEvent() = 0;
         virtual double PercentDone() const = 0;
+
+        /**
+         * @brief SeekEvent lets the next NextEvent call return the given event
+         * @param event the number of the event, usually the TID lower
+         * @return false if seeking is not supported or failed
+         */
+        virtual bool SeekEvent(std::uint32_t) { return false; }
+
+        /// the file this module was created for by Unpacker::Get
+        const std::string& GetFilename() const { return filename; }
     protected:
         friend class Unpacker;
         virtual bool OpenFile(const std::string& filename) = 0;
+        std::string filename;
     };
 
     /**
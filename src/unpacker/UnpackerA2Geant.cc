@@ -1,4 +1,5 @@
 #include "UnpackerA2Geant.h"
+#include "RawFileReader.h"
 
 #include "expconfig/ExpConfig.h"
 
@@ -86,6 +87,10 @@ UnpackerA2Geant::~UnpackerA2Geant() {}
 
 bool UnpackerA2Geant::OpenFile(const string& filename)
 {
+    // live sources are handled by the Acqu unpacker
+    if(RawFileReader::IsSocket(filename))
+        return false;
+
     // open a root file, ignore non-ROOT files silently
     inputfile = std_ext::make_unique<WrapTFileInput>();
 
@@ -3,8 +3,11 @@
 
 #include "tree/TEvent.h"
 #include "base/Logger.h"
+#include "base/ProgressCounter.h"
 
 #include <stdexcept>
+#include <iomanip>
+#include <algorithm>
 
 using namespace std;
 using namespace ant;
@@ -17,6 +20,12 @@ double UnpackerAcqu::PercentDone() const
     return file->PercentDone();
 }
 
+bool UnpackerAcqu::SeekEvent(uint32_t event)
+{
+    queue.clear();
+    return file->SeekEvent(event);
+}
+
 bool UnpackerAcqu::OpenFile(const std::string &filename)
 {
     // this might also throw an exception if something
@@ -27,6 +36,22 @@ bool UnpackerAcqu::OpenFile(const std::string &filename)
         return false;
 
     LOG(INFO) << "Successfully opened " << filename;
+
+    if(file->IsLive()) {
+        LOG(INFO) << "Reading live data from " << filename;
+        latencyProgress = std_ext::make_unique<ProgressCounter>(
+                              [this] (std::chrono::duration<double>)
+        {
+            if(latency.N == 0)
+                return;
+            LOG(INFO) << "Live data latency until unpacked event is handed out: mean "
+                      << std::fixed << setprecision(1) << 1000*latency.Sum/latency.N
+                      << " ms, max " << 1000*latency.Max << " ms";
+            latency.Sum = 0;
+            latency.Max = 0;
+            latency.N = 0;
+        });
+    }
     return true;
 }
 
@@ -38,6 +63,14 @@ TEvent UnpackerAcqu::NextEvent()
         // still empty? Then the file is completely processed...
         if(queue.empty())
             return {};
+        latency.Arrival = file->LastArrival();
+    }
+
+    if(latencyProgress) {
+        const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - latency.Arrival;
+        latency.Sum += dt.count();
+        latency.Max = std::max(latency.Max, dt.count());
+        latency.N++;
     }
 
     // std;:deque does not have a method to get and remove the element
@@ -11,9 +11,12 @@
 #include <vector>
 #include <cstdint>
 #include <limits>
+#include <chrono>
 
 namespace ant {
 
+struct ProgressCounter;
+
 class UnpackerAcquFileFormat; // implemented in detail/UnpackerAcqu.h
 
 class UnpackerAcqu : public Unpacker::Module
@@ -31,10 +34,22 @@ public:
 
     virtual double PercentDone() const override;
 
+    virtual bool SeekEvent(std::uint32_t event) override;
+
 private:
     std::list<TEvent> queue; // std::list supports splice
     std::unique_ptr<UnpackerAcquFileFormat> file;
 
+    // latency from reading live data to handing out its events
+    struct latency_t {
+        std::chrono::steady_clock::time_point Arrival; // of events in queue
+        double Sum = 0;
+        double Max = 0;
+        unsigned long N = 0;
+    };
+    latency_t latency;
+    std::unique_ptr<ProgressCounter> latencyProgress;
+
 };
 
 // we define some methods here which
@@ -14,6 +14,7 @@
 #include "base/Logger.h"
 #include "base/std_ext/misc.h"
 #include "RawFileReader.h"
+#include "RawFileIndex.h"
 
 #include <algorithm>
 #include <exception>
@@ -73,7 +74,7 @@ UnpackerAcquFileFormat::Get(const string& filename)
     // give him the reader and the buffer for further processing
     // also fill some header-like events into the queue
     const format_t& format = formats.back();
-    format->Setup(move(reader), move(buffer));
+    format->Setup(filename, move(reader), move(buffer));
 
     // return the UnpackerAcquFormat instance
     return move(formats.back());
@@ -81,7 +82,8 @@ UnpackerAcquFileFormat::Get(const string& filename)
 
 UnpackerAcquFileFormat::~UnpackerAcquFileFormat() {}
 
-void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
+void acqu::FileFormatBase::Setup(const string& filename_, reader_t &&reader_, buffer_t &&buffer_) {
+    filename = filename_;
     reader = move(reader_);
     buffer = move(buffer_);
 
@@ -114,11 +116,28 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
 
     // now try to fill the first data buffer
     FillFirstDataBuffer(reader, buffer);
+    bufferArrival = clock_t::now();
     nUnpackedBuffers = 0; // not yet unpacked
 
     // remember the record length size
     trueRecordLength = buffer.size();
 
+    // use or create the index for seeking
+    if(!buffer.empty() && !reader->IsLive()) {
+        try {
+            index = RawFileIndex::Load(filename);
+        }
+        catch(RawFileIndex::Exception e) {
+            VLOG(3) << "Cannot load raw file index: " << e.what();
+        }
+        if(!index && RawFileIndex::CreateOnRead) {
+            newIndex = std_ext::make_unique<RawFileIndex>();
+            newIndex->RecordLength = 4*trueRecordLength;
+            newIndex->FirstBufferOffset = reader->tellg() - newIndex->RecordLength;
+            reader->record_access_points(RawFileIndex::AccessPointSpacing);
+        }
+    }
+
     // get the mappings once
     setup.BuildMappings(hit_mappings, scaler_mappings);
 
@@ -144,6 +163,52 @@ double acqu::FileFormatBase::PercentDone() const
     return reader->PercentDone();
 }
 
+bool acqu::FileFormatBase::IsLive() const
+{
+    return reader->IsLive();
+}
+
+bool acqu::FileFormatBase::SeekEvent(uint32_t event)
+{
+    if(!index) {
+        LOG(WARNING) << "No index present for " << filename << ", create it with Ant-rawIndex";
+        return false;
+    }
+
+    const auto b = index->FindBuffer(event);
+    if(b == index->Buffers.size()) {
+        LOG(WARNING) << "Event " << event << " not found in index of " << filename;
+        return false;
+    }
+    const RawFileIndex::buffer_t& info = index->Buffers[b];
+
+    // index is only built when reading from the beginning
+    newIndex = nullptr;
+
+    try {
+        reader->seek(index->GetOffset(b), index->AccessPoints);
+    }
+    catch(RawFileReader::Exception e) {
+        LOG(WARNING) << "Cannot seek to event " << event << " in " << filename << ": " << e.what();
+        return false;
+    }
+
+    buffer.resize(trueRecordLength);
+    refillPending = false;
+    RefillBuffer();
+    if(buffer.empty())
+        return false;
+
+    // continue as if the previous buffers were unpacked
+    id.Lower = info.FirstEvent;
+    AcquID_last = info.FirstAcquID - 1;
+    nUnpackedBuffers = b;
+    skipEvents = event - info.FirstEvent;
+
+    VLOG(3) << "Seeked to event " << event << " in buffer " << b;
+    return true;
+}
+
 time_t acqu::FileFormatBase::GetTimeStamp()
 {
     // the following calculation assumes
@@ -248,6 +313,11 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
     // this method never throws exceptions, but just adds TUnpackerMessage to event
     // if something strange while unpacking is encountered
 
+    if(refillPending) {
+        refillPending = false;
+        RefillBuffer();
+    }
+
     // we use the buffer as some state-variable
     // if the buffer is already empty now, there is nothing more to read
     if(buffer.empty()) {
@@ -262,6 +332,14 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
         return;
     }
 
+    unpackedArrival = bufferArrival;
+
+    RawFileIndex::buffer_t bufferInfo;
+    bufferInfo.FirstEvent = id.Lower;
+    bufferInfo.nEvents = 0;
+    bufferInfo.FirstAcquID = buffer.size() > 1 ? buffer[1] : 0;
+    bufferInfo.HasScalers = false;
+
     // start parsing the filled buffer
     // however, we fill a temporary queue first
     auto it = buffer.cbegin();
@@ -286,13 +364,44 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
         const int unpackedWords = distance(buffer.cbegin(), it);
         VLOG(7) << "Successfully unpacked " << unpackedWords << " words ("
                 << 100.0*unpackedWords/buffer.size() << " %) from buffer ";
+
+        bufferInfo.nEvents = queue_buffer.size();
+        bufferInfo.HasScalers = any_of(queue_buffer.begin(), queue_buffer.end(), [] (const TEvent& e) {
+            return !e.Reconstructed().SlowControls.empty();
+        });
+
+        // after seeking, the buffer might start before the requested event
+        if(skipEvents > 0) {
+            auto it_skip = queue_buffer.begin();
+            advance(it_skip, min<size_t>(skipEvents, queue_buffer.size()));
+            queue_buffer.erase(queue_buffer.begin(), it_skip);
+            skipEvents = 0;
+        }
+
         queue.splice(queue.end(), move(queue_buffer));
     }
 
+    if(newIndex)
+        newIndex->Buffers.push_back(bufferInfo);
+
     nUnpackedBuffers++;
 
+    if(reader->IsLive()) {
+        refillPending = true;
+        return;
+    }
+
+    RefillBuffer();
 
-    // refill the buffer
+    // the above refill might have created messages,
+    // and to suppress empty events with messages only,
+    // we simply append them to the last event if any present
+    if(!queue.empty())
+        AppendMessagesToEvent(queue.back());
+}
+
+void acqu::FileFormatBase::RefillBuffer()
+{
     try {
         reader->read(buffer.data(), trueRecordLength);
     }
@@ -311,6 +420,17 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
             LogMessage(TUnpackerMessage::Level_t::Info,
                        std_ext::formatter()
                        << "Found proper end of file");
+            if(newIndex) {
+                newIndex->AccessPoints = reader->recorded_access_points();
+                try {
+                    newIndex->Save(filename);
+                    VLOG(3) << "Created raw file index " << RawFileIndex::GetFilename(filename);
+                }
+                catch(RawFileIndex::Exception e) {
+                    VLOG(3) << "Cannot save raw file index: " << e.what();
+                }
+                newIndex = nullptr;
+            }
         }
         else {
             LogMessage(TUnpackerMessage::Level_t::DataError,
@@ -319,13 +439,19 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
                        << " bytes, not enough for record length " << 4*trueRecordLength);
         }
         buffer.clear();
+        return;
     }
 
-    // the above refill might have created messages,
-    // and to suppress empty events with messages only,
-    // we simply append them to the last event if any present
-    if(!queue.empty())
-        AppendMessagesToEvent(queue.back());
+    bufferArrival = clock_t::now();
+
+    // live data never reaches the end of the file,
+    // but Acqu writes an end buffer when the run is stopped
+    if(reader->IsLive() && buffer.front() == acqu::EEndBuff) {
+        LogMessage(TUnpackerMessage::Level_t::Info,
+                   std_ext::formatter()
+                   << "Found end buffer in live data");
+        buffer.clear();
+    }
 }
 
 uint32_t acqu::FileFormatBase::GetDataBufferMarker() const
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <chrono>
 
 namespace ant {
 
@@ -21,6 +22,7 @@ namespace ant {
  * Base class for file access management of acqu files
  */
 class RawFileReader;
+class RawFileIndex;
 struct TEvent;
 struct TSlowControl;
 
@@ -48,10 +50,32 @@ public:
 
     virtual double PercentDone() const =0;
 
+    /**
+     * @brief IsLive
+     * @return true if reading from a live source, see RawFileReader::Live
+     */
+    virtual bool IsLive() const = 0;
+
+    using clock_t = std::chrono::steady_clock;
+
+    /**
+     * @brief LastArrival
+     * @return time when the data of the events from last FillEvents call was read
+     */
+    virtual clock_t::time_point LastArrival() const = 0;
+
+    /**
+     * @brief SeekEvent prepares that the next FillEvents call starts with the given event
+     * @param event the TID lower of the event
+     * @return false if no index for the file is present or the event is not found
+     */
+    virtual bool SeekEvent(std::uint32_t event) = 0;
+
 protected:
     virtual size_t SizeOfHeader() const = 0;
     virtual bool InspectHeader(const std::vector<uint32_t>& buffer) const = 0;
-    virtual void Setup(std::unique_ptr<RawFileReader>&& reader_,
+    virtual void Setup(const std::string& filename,
+                       std::unique_ptr<RawFileReader>&& reader_,
                        std::vector<std::uint32_t>&& buffer_) = 0;
 };
 
@@ -66,10 +90,25 @@ public:
     virtual ~FileFormatBase();
 
     virtual double PercentDone() const override;
+    virtual bool IsLive() const override;
+    virtual clock_t::time_point LastArrival() const override { return unpackedArrival; }
+    virtual bool SeekEvent(std::uint32_t event) override;
 
 private:
+    std::string filename;
     std::unique_ptr<RawFileReader> reader;
     std::vector<std::uint32_t>     buffer;
+    // live sources refill the buffer only when the next events are requested,
+    // otherwise the events of one buffer would wait until the next one is written
+    bool refillPending = false;
+    clock_t::time_point bufferArrival;
+    clock_t::time_point unpackedArrival;
+    void RefillBuffer();
+
+    // index for seeking, the newIndex is built when reading from the beginning
+    std::unique_ptr<RawFileIndex> index;
+    std::unique_ptr<RawFileIndex> newIndex;
+    unsigned skipEvents = 0;
     // messages must be buffered during event unpacking,
     // but in order to have LogMessage() const,
     // the storage must be mutable
@@ -131,7 +170,7 @@ protected:
 
 
     // this class already implements some stuff
-    void Setup(reader_t&& reader_, buffer_t&& buffer_) override;
+    void Setup(const std::string& filename_, reader_t&& reader_, buffer_t&& buffer_) override;
     void FillEvents(queue_t& queue) noexcept override;
 
     // unpacker messages handling
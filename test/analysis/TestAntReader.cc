@@ -3,6 +3,7 @@
 #include "expconfig_helpers.h"
 
 #include "analysis/input/ant/AntReader.h"
+#include "analysis/input/ant/ReadHitsCache.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
@@ -24,12 +25,18 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest_read_unpacker();
+void dotest_read_cache();
 
 TEST_CASE("AntReader: Read from unpacker", "[analysis]") {
     test::EnsureSetup();
     dotest_read_unpacker();
 }
 
+TEST_CASE("AntReader: Read from read hits cache", "[analysis]") {
+    test::EnsureSetup();
+    dotest_read_cache();
+}
+
 
 void dotest_read_unpacker() {
     auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
@@ -58,3 +65,60 @@ void dotest_read_unpacker() {
     REQUIRE(nCandidates == 864);
 
 }
+
+void dotest_read_cache() {
+    const string rawfile = string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz";
+
+    tmpfile_t tmpfile;
+
+    // write the cache, check that the hits survive packing
+    unsigned nReadHits = 0;
+    {
+        WrapTFileOutput outputfile(tmpfile.filename, true);
+        ReadHitsCache_t cache;
+        cache.CreateBranches(outputfile.CreateInside<TTree>(ReadHitsCache_t::TreeName, ""));
+
+        auto unpacker = Unpacker::Get(rawfile);
+        while(auto event = unpacker->NextEvent()) {
+            const auto& eventdata = event.Reconstructed();
+            cache.Set(eventdata);
+            cache.Tree->Fill();
+
+            auto cached = cache.Get();
+            const auto& cacheddata = cached.Reconstructed();
+            REQUIRE(cacheddata.ID == eventdata.ID);
+            REQUIRE(cacheddata.SlowControls.size() == eventdata.SlowControls.size());
+            REQUIRE(cacheddata.DetectorReadHits.size() == eventdata.DetectorReadHits.size());
+            for(size_t i=0;i<eventdata.DetectorReadHits.size();i++) {
+                const auto& h1 = eventdata.DetectorReadHits[i];
+                const auto& h2 = cacheddata.DetectorReadHits[i];
+                REQUIRE(h1.DetectorType == h2.DetectorType);
+                REQUIRE(h1.ChannelType == h2.ChannelType);
+                REQUIRE(h1.Channel == h2.Channel);
+                REQUIRE(h1.RawData == h2.RawData);
+                REQUIRE(h1.Values.size() == h2.Values.size());
+            }
+            nReadHits += eventdata.DetectorReadHits.size();
+        }
+    }
+    REQUIRE(nReadHits > 0);
+
+    // reading the cache must give the same result as reading the raw file
+    auto rootfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+    AntReader reader(rootfiles, nullptr, std_ext::make_unique<Reconstruct>());
+    REQUIRE(reader.IsSource());
+
+    unsigned nEvents = 0;
+    unsigned nCandidates = 0;
+    unsigned nSlowControls = 0;
+    event_t event;
+    while(reader.ReadNextEvent(event)) {
+        nEvents++;
+        nCandidates += event.Reconstructed().Candidates.size();
+        nSlowControls += event.Reconstructed().SlowControls.size();
+    }
+
+    REQUIRE(nEvents==221);
+    REQUIRE(nSlowControls == 8);
+    REQUIRE(nCandidates == 864);
+}
@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "analysis/plot/CutTree.h"
+#include "analysis/plot/HistogramFactory.h"
+
+#include "TH1D.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+using namespace ant::analysis::plot;
+
+void dotest_flat();
+
+TEST_CASE("CutTree: Flat", "[analysis]") {
+    dotest_flat();
+}
+
+struct Hist_t {
+    struct Fill_t {
+        int X;
+    };
+
+    TH1D* h;
+
+    Hist_t(const HistogramFactory& HistFac, const cuttree::TreeInfo_t&) {
+        h = HistFac.makeTH1D("X","x","",BinSettings(10),"h");
+    }
+
+    void Fill(const Fill_t& f) const {
+        h->Fill(f.X);
+    }
+
+    static cuttree::Cuts_t<Fill_t> GetCuts() {
+        using cuttree::MultiCut_t;
+        cuttree::Cuts_t<Fill_t> cuts;
+        cuts.emplace_back(MultiCut_t<Fill_t>{
+                              {"X>1", [] (const Fill_t& f) { return f.X>1; }},
+                              {"X>3", [] (const Fill_t& f) { return f.X>3; }},
+                          });
+        cuts.emplace_back(MultiCut_t<Fill_t>{
+                              {"Even", [] (const Fill_t& f) { return f.X % 2 == 0; }},
+                              {"All"},
+                              {"X<5", [] (const Fill_t& f) { return f.X<5; }},
+                          });
+        cuts.emplace_back(MultiCut_t<Fill_t>{
+                              {"X>8", [] (const Fill_t& f) { return f.X>8; }},
+                          });
+        return cuts;
+    }
+};
+
+void collect_entries(const cuttree::Tree_t<Hist_t>& node, vector<double>& entries) {
+    entries.push_back(node->Get().Hist.h->GetEntries());
+    for(const auto& d : node->Daughters())
+        collect_entries(d, entries);
+}
+
+void dotest_flat() {
+    gDirectory->Clear();
+
+    auto tree = cuttree::Make<Hist_t>(HistogramFactory("Tree"));
+    auto flattree = cuttree::MakeFlat<Hist_t>(HistogramFactory("Flat"));
+
+    for(int x=0;x<10;x++) {
+        cuttree::Fill<Hist_t>(tree, {x});
+        cuttree::Fill<Hist_t>(flattree, {x});
+    }
+
+    vector<double> entries_tree;
+    collect_entries(tree, entries_tree);
+    vector<double> entries_flat;
+    collect_entries(flattree.GetTree(), entries_flat);
+
+    REQUIRE(entries_tree.size() == 1+2+2*3+2*3*1);
+    CHECK(entries_flat == entries_tree);
+    CHECK(entries_flat.front() == 10);
+}
@@ -1,8 +1,11 @@
 #include "catch.hpp"
 
 #include "analysis/plot/HistogramFactory.h"
+#include "analysis/plot/PromptRandomHist.h"
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
+#include "base/std_ext/memory.h"
+#include "root-addons/analysis_codes/hstack.h"
 
 #include "TH1D.h"
 #include "TH2D.h"
@@ -10,6 +13,8 @@
 #include "TGraph.h"
 #include "TTree.h"
 
+#include <thread>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis;
@@ -17,6 +22,7 @@ using namespace ant::analysis;
 void dotest_make();
 void dotest_nameclash();
 void dotest_numdir();
+void dotest_directorybuffer();
 
 
 TEST_CASE("HistogramFactory: Make", "[analysis]") {
@@ -32,6 +38,10 @@ TEST_CASE("HistogramFactory: Numbered directories", "[analysis]") {
     dotest_numdir();
 }
 
+TEST_CASE("HistogramFactory: DirectoryBuffer", "[analysis]") {
+    dotest_directorybuffer();
+}
+
 
 void dotest_make() {
     gDirectory->Clear();
@@ -88,3 +98,66 @@ void dotest_numdir() {
     // back in old dir
     REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test_2")));
 }
+
+struct buffered_hists_t {
+    HistogramFactory HistFac;
+    PromptRandom::Switch promptrandom;
+    PromptRandom::Hist1 h_pr;
+    TH1D* h;
+    buffered_hists_t() :
+        HistFac("Test"),
+        h_pr(promptrandom)
+    {
+        promptrandom.AddPromptRange({-2, 2});
+        promptrandom.AddRandomRange({-20, -10});
+        h = HistFac.makeTH1D("h","","",BinSettings(10),"h");
+        h_pr.MakeHistograms(HistogramFactory("Sub", HistFac), "h_pr", "", BinSettings(10), "", "");
+    }
+    void Fill() {
+        for(int i=0;i<10;i++) {
+            h->Fill(i);
+            promptrandom.SetTaggerTime(i % 2 == 0 ? 0 : -15);
+            h_pr.Fill(i);
+        }
+    }
+};
+
+void dotest_directorybuffer() {
+    gDirectory->Clear();
+
+    buffered_hists_t registered;
+
+    HistogramFactory::DirectoryBuffer buffer;
+    // the buffer is not registered in gDirectory
+    REQUIRE(gDirectory->FindObject("DirectoryBuffer") == nullptr);
+    unique_ptr<buffered_hists_t> buffered;
+    {
+        HistogramFactory::DirectoryBuffer::Scope scope(buffer);
+        buffered = std_ext::make_unique<buffered_hists_t>();
+        // not created by the registered instance
+        buffered->HistFac.makeTH1D("only_buffered","","",BinSettings(10),"only_buffered")->Fill(1);
+        buffered->HistFac.make<hstack>("only_buffered_stack");
+    }
+    // the buffered instance must not touch gDirectory
+    REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test")));
+    REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test_1")) == nullptr);
+
+    std::thread t([&buffered] () { buffered->Fill(); });
+    registered.Fill();
+    t.join();
+
+    CHECK(registered.h->GetEntries() == 10);
+    CHECK(buffered->h->GetEntries() == 10);
+
+    buffer.MergeInto(gDirectory);
+
+    CHECK(registered.h->GetEntries() == 20);
+    CHECK(registered.h_pr.prompt->GetEntries() == 10);
+    CHECK(registered.h_pr.random->GetEntries() == 10);
+    CHECK(buffered->h->GetEntries() == 0);
+
+    auto only_buffered = dynamic_cast<TH1D*>(gDirectory->Get("Test/only_buffered"));
+    REQUIRE(only_buffered);
+    CHECK(only_buffered->GetEntries() == 1);
+    CHECK(dynamic_cast<hstack*>(gDirectory->Get("Test/only_buffered_stack")));
+}
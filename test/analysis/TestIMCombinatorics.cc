@@ -0,0 +1,166 @@
+#include "catch.hpp"
+
+#include "analysis/utils/IMCombinatorics.h"
+#include "analysis/utils/Combinatorics.h"
+
+#include "base/vec/LorentzVec.h"
+
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+vector<LorentzVec> make_photons(unsigned n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> E(10, 800);
+    std::uniform_real_distribution<double> theta(0.1, 3.0);
+    std::uniform_real_distribution<double> phi(-3.1, 3.1);
+    vector<LorentzVec> photons;
+    for(unsigned i=0;i<n;i++) {
+        const auto e = E(rng);
+        photons.emplace_back(LorentzVec::EPThetaPhi(e, e, theta(rng), phi(rng)));
+    }
+    return photons;
+}
+
+vector<double> sum_from_scratch(const vector<LorentzVec>& photons, unsigned k) {
+    vector<double> ims;
+    for(auto comb = makeCombination(photons, k); !comb.done(); ++comb) {
+        LorentzVec sum;
+        for(const auto& p : comb)
+            sum += p;
+        ims.push_back(sum.M());
+    }
+    return ims;
+}
+
+TEST_CASE("IMCombinatorics: Compare to NchooseK", "[analysis]") {
+    std::mt19937 rng(0);
+    IMCombinatorics combinatorics;
+
+    for(unsigned n=0;n<=10;n++) {
+        const auto photons = make_photons(n, rng);
+        combinatorics.Clear();
+        for(const auto& p : photons)
+            combinatorics.Add(p);
+        REQUIRE(combinatorics.N() == n);
+
+        for(unsigned k=1;k<=n+1;k++) {
+            auto expected = sum_from_scratch(photons, k);
+            const auto nSubsets = combinatorics.Calculate(k);
+            REQUIRE(nSubsets == expected.size());
+            REQUIRE(combinatorics.IMs().size() == nSubsets);
+            REQUIRE(combinatorics.Masks().size() == nSubsets);
+
+            // each subset has k distinct members and appears once
+            auto masks = combinatorics.Masks();
+            for(auto mask : masks)
+                REQUIRE(unsigned(__builtin_popcount(mask)) == k);
+            sort(masks.begin(), masks.end());
+            REQUIRE(unique(masks.begin(), masks.end()) == masks.end());
+
+            // check each mass against its mask
+            for(size_t i=0;i<nSubsets;i++) {
+                LorentzVec sum;
+                for(unsigned j=0;j<n;j++)
+                    if(combinatorics.Masks()[i] & (1u << j))
+                        sum += photons[j];
+                REQUIRE(combinatorics.IMs()[i] == Approx(sum.M()).margin(1e-3));
+            }
+
+            // order differs from NchooseK, but not the set of masses
+            auto ims = combinatorics.IMs();
+            sort(ims.begin(), ims.end());
+            sort(expected.begin(), expected.end());
+            for(size_t i=0;i<nSubsets;i++)
+                REQUIRE(ims[i] == Approx(expected[i]).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("IMCombinatorics: More than MaxN", "[analysis]") {
+    std::mt19937 rng(1);
+    IMCombinatorics combinatorics;
+
+    const auto photons = make_photons(IMCombinatorics::MaxN+2, rng);
+    for(const auto& p : photons)
+        combinatorics.Add(p);
+
+    for(unsigned k=1;k<=2;k++) {
+        const auto expected = sum_from_scratch(photons, k);
+        REQUIRE(combinatorics.Calculate(k) == expected.size());
+        CHECK(combinatorics.Masks().empty());
+        // same order as NchooseK
+        for(size_t i=0;i<expected.size();i++)
+            REQUIRE(combinatorics.IMs()[i] == Approx(expected[i]).margin(1e-3));
+    }
+}
+
+TEST_CASE("IMCombinatorics: Uncached sequences", "[analysis]") {
+    std::mt19937 rng(2);
+    IMCombinatorics combinatorics;
+
+    // 20 choose 10 exceeds the cache, 20 choose 2 does not
+    const auto photons = make_photons(20, rng);
+    for(const auto& p : photons)
+        combinatorics.Add(p);
+
+    for(unsigned k : {10u, 2u, 10u, 2u}) {
+        const auto expected = sum_from_scratch(photons, k);
+        REQUIRE(combinatorics.Calculate(k) == expected.size());
+        REQUIRE(combinatorics.Masks().size() == expected.size());
+        // generated on the fly, but still in revolving-door order
+        const auto& masks = combinatorics.Masks();
+        for(size_t i=1;i<masks.size();i++)
+            REQUIRE(__builtin_popcount(masks[i-1] ^ masks[i]) == 2);
+        for(size_t i=0;i<expected.size();i+=97) {
+            LorentzVec sum;
+            for(unsigned j=0;j<photons.size();j++)
+                if(combinatorics.Masks()[i] & (1u << j))
+                    sum += photons[j];
+            REQUIRE(combinatorics.IMs()[i] == Approx(sum.M()).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("IMCombinatorics: Benchmark", "[analysis][.bench]") {
+    std::mt19937 rng(0);
+    IMCombinatorics combinatorics;
+    constexpr unsigned nEvents = 2000;
+
+    for(unsigned n=2;n<=10;n++) {
+        vector<vector<LorentzVec>> events;
+        for(unsigned i=0;i<nEvents;i++)
+            events.emplace_back(make_photons(n, rng));
+
+        double sum_nchoosek = 0;
+        auto start = chrono::steady_clock::now();
+        for(const auto& photons : events)
+            for(unsigned k=2;k<=n;k++)
+                for(auto im : sum_from_scratch(photons, k))
+                    sum_nchoosek += im;
+        const chrono::duration<double> t_nchoosek = chrono::steady_clock::now() - start;
+
+        double sum_engine = 0;
+        start = chrono::steady_clock::now();
+        for(const auto& photons : events) {
+            combinatorics.Clear();
+            for(const auto& p : photons)
+                combinatorics.Add(p);
+            for(unsigned k=2;k<=n;k++) {
+                combinatorics.Calculate(k);
+                for(auto im : combinatorics.IMs())
+                    sum_engine += im;
+            }
+        }
+        const chrono::duration<double> t_engine = chrono::steady_clock::now() - start;
+
+        CHECK(sum_engine == Approx(sum_nchoosek));
+        cout << "n=" << n << ": NchooseK " << t_nchoosek.count()*1e6/nEvents << " us/event, "
+             << "IMCombinatorics " << t_engine.count()*1e6/nEvents << " us/event, "
+             << "speedup " << t_nchoosek.count()/t_engine.count() << endl;
+    }
+}
@@ -3,6 +3,7 @@
 #include "expconfig_helpers.h"
 
 #include "analysis/physics/PhysicsManager.h"
+#include "analysis/physics/manager_t.h"
 #include "analysis/input/ant/AntReader.h"
 #include "analysis/input/pluto/PlutoReader.h"
 #include "analysis/input/goat/GoatReader.h"
@@ -10,16 +11,20 @@
 #include "analysis/utils/Uncertainties.h"
 #include "analysis/utils/ParticleTools.h"
 #include "analysis/utils/ParticleID.h"
+#include "analysis/utils/ProtonPhotonCombs.h"
 
 #include "unpacker/Unpacker.h"
 #include "reconstruct/Reconstruct.h"
 #include "expconfig/ExpConfig.h"
 #include "tree/TAntHeader.h"
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
 
 #include "base/tmpfile_t.h"
 #include "base/WrapTFile.h"
 
 #include "TTree.h"
+#include "TH1D.h"
 
 
 #include <iostream>
@@ -34,6 +39,7 @@ void dotest_raw_nowrite();
 void dotest_plutogeant(bool insertGoat);
 void dotest_pluto(bool insertGoat);
 void dotest_runall();
+void dotest_buffer();
 
 TEST_CASE("PhysicsManager: Raw Input", "[analysis]") {
     test::EnsureSetup();
@@ -70,6 +76,23 @@ TEST_CASE("PhysicsManager: Run all physics", "[analysis]") {
     dotest_runall();
 }
 
+TEST_CASE("PhysicsManager: Merge buffered histograms", "[analysis]") {
+    test::EnsureSetup();
+    dotest_buffer();
+}
+
+void dotest_parallelsafe();
+
+TEST_CASE("PhysicsManager: Parallel opt-in", "[analysis]") {
+    dotest_parallelsafe();
+}
+
+void dotest_managercache();
+
+TEST_CASE("PhysicsManager: Per-event cache of manager_t", "[analysis]") {
+    dotest_managercache();
+}
+
 struct TestPhysics : Physics
 {
     bool finishCalled = false;
@@ -81,19 +104,22 @@ struct TestPhysics : Physics
     unsigned seenMCTrue = 0;
     unsigned seenTrueTargetPos = 0;
     unsigned seenReconTargetPosNaN = 0;
+    double entriesInFinish = 0;
 
+    TH1D* h;
 
 
     TestPhysics(bool nowrite_ = false) :
         Physics("TestPhysics", nullptr),
         nowrite(nowrite_)
     {
-        HistFac.makeTH1D("test","test","test",BinSettings(10));
+        h = HistFac.makeTH1D("test","test","test",BinSettings(10));
     }
 
     virtual void ProcessEvent(const TEvent& event, physics::manager_t& manager) override
     {
         seenEvents++;
+        h->Fill(seenEvents % 10);
         seenTaggerHits += event.Reconstructed().TaggerHits.size();
         seenCandidates += event.Reconstructed().Candidates.size();
         seenMCTrue += utils::ParticleTypeList::Make(event.MCTrue().ParticleTree).GetAll().size();
@@ -107,6 +133,7 @@ struct TestPhysics : Physics
     virtual void Finish() override
     {
         finishCalled = true;
+        entriesInFinish = h->GetEntries();
     }
     virtual void ShowResult() override
     {
@@ -359,3 +386,99 @@ void dotest_runall() {
 
 }
 
+
+void dotest_buffer()
+{
+    tmpfile_t tmpfile;
+    WrapTFileOutput outfile(tmpfile.filename, true);
+
+    PhysicsManagerTester pm;
+    pm.AddPhysics<TestPhysics>(true);
+
+    // a second instance with the same histogram paths,
+    // usually filled by another thread while ReadFrom runs
+    auto target = gDirectory;
+    auto buffer = std_ext::make_unique<HistogramFactory::DirectoryBuffer>();
+    unique_ptr<TestPhysics> buffered;
+    {
+        HistogramFactory::DirectoryBuffer::Scope scope(*buffer);
+        buffered = std_ext::make_unique<TestPhysics>(true);
+    }
+    for(int i=0;i<5;i++)
+        buffered->h->Fill(i);
+    pm.AddBuffer(move(buffer), target);
+
+    list< unique_ptr<analysis::input::DataReader> > readers;
+    auto rootfiles = std::make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/Pluto_with_TID.root");
+    readers.push_back(std_ext::make_unique<analysis::input::PlutoReader>(rootfiles));
+    REQUIRE_NOTHROW(pm.ReadFrom(move(readers), numeric_limits<long long>::max()));
+
+    std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+
+    REQUIRE(physics->finishCalled);
+    REQUIRE(physics->seenEvents == 100);
+    // merged before Finish was called
+    CHECK(physics->entriesInFinish == 105);
+    CHECK(physics->h->GetEntries() == 105);
+    CHECK(buffered->h->GetEntries() == 0);
+
+    REQUIRE_THROWS_AS(pm.AddBuffer(nullptr, target), PhysicsManager::Exception);
+}
+
+void dotest_parallelsafe() {
+    struct ParallelTestPhysics : TestPhysics {
+        virtual bool IsParallelSafe() const override { return true; }
+    };
+
+    PhysicsManager pm;
+    CHECK(pm.GetParallelUnsafe().empty());
+    pm.AddPhysics<ParallelTestPhysics>();
+    CHECK(pm.GetParallelUnsafe().empty());
+    // classes must opt in
+    pm.AddPhysics<TestPhysics>();
+    CHECK(pm.GetParallelUnsafe() == vector<string>{"TestPhysics"});
+}
+
+TEvent makeCacheTestEvent(unsigned nPhotons, double cbEnergy) {
+    TEvent event(TID(0, nPhotons, {TID::Flags_t::MC}));
+    auto& recon = event.Reconstructed();
+    for(unsigned i=0;i<nPhotons;i++)
+        recon.Candidates.emplace_back(Detector_t::Type_t::CB, 100, 1.0+0.1*i, 0.5*i, 0, 1, 0, 0, TClusterList{});
+    recon.DetectorReadHits.emplace_back(
+                LogicalChannel_t{Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 0},
+                TDetectorReadHit::Value_t(cbEnergy));
+    return event;
+}
+
+void dotest_managercache() {
+    utils::ParticleID::SetDefault(std_ext::make_unique<utils::SimpleParticleID>());
+
+    const auto event1 = makeCacheTestEvent(2, 600);
+    const auto event2 = makeCacheTestEvent(3, 400);
+
+    physics::manager_t manager;
+
+    // same event returns the same objects
+    const auto& triggersimu = manager.GetTriggerSimulation(event1);
+    const auto& particles   = manager.GetParticles(event1);
+    const auto& combs       = manager.GetProtonPhotonCombs(event1);
+    CHECK(addressof(manager.GetTriggerSimulation(event1)) == addressof(triggersimu));
+    CHECK(addressof(manager.GetParticles(event1)) == addressof(particles));
+    CHECK(addressof(manager.GetProtonPhotonCombs(event1)) == addressof(combs));
+
+    CHECK(triggersimu.CBEnergySum == Approx(600));
+    CHECK(triggersimu.hasTriggered);
+    CHECK(particles.GetAll().size() == 2);
+    CHECK(combs().size() == utils::ProtonPhotonCombs(event1.Reconstructed().Candidates)().size());
+
+    // different event recomputes, check content as the addresses may be re-used
+    CHECK(manager.GetTriggerSimulation(event2).CBEnergySum == Approx(400));
+    CHECK_FALSE(manager.GetTriggerSimulation(event2).hasTriggered);
+    CHECK(manager.GetParticles(event2).GetAll().size() == 3);
+    CHECK(manager.GetProtonPhotonCombs(event2)().size() ==
+          utils::ProtonPhotonCombs(event2.Reconstructed().Candidates)().size());
+
+    // and going back recomputes again
+    CHECK(manager.GetParticles(event1).GetAll().size() == 2);
+    CHECK(manager.GetTriggerSimulation(event1).CBEnergySum == Approx(600));
+}
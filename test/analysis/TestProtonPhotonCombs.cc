@@ -0,0 +1,162 @@
+#include "catch.hpp"
+
+#include "analysis/utils/ProtonPhotonCombs.h"
+
+#include <random>
+#include <list>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+void dotest_compare();
+void dotest_observer();
+void dotest_toomany();
+
+TEST_CASE("ProtonPhotonCombs: Compare to list of particles", "[analysis]") {
+    dotest_compare();
+}
+
+TEST_CASE("ProtonPhotonCombs: Observer", "[analysis]") {
+    dotest_observer();
+}
+
+TEST_CASE("ProtonPhotonCombs: Too many candidates", "[analysis]") {
+    dotest_toomany();
+}
+
+TCandidateList make_cands(unsigned n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> E(10, 800);
+    std::uniform_real_distribution<double> theta(0.1, 3.0);
+    std::uniform_real_distribution<double> phi(-3.1, 3.1);
+    TCandidateList cands;
+    for(unsigned i=0;i<n;i++)
+        cands.emplace_back(Detector_t::Type_t::CB, E(rng), theta(rng), phi(rng), 0, 1, 0, 0,
+                           TClusterList{});
+    return cands;
+}
+
+// straightforward implementation to compare with
+struct ref_comb_t {
+    TCandidatePtr Proton;
+    TCandidatePtrList Photons; // by descending Ek
+    double DiscardedEk = std_ext::NaN;
+    LorentzVec PhotonSum{{0,0,0},0};
+    double MissingMass = std_ext::NaN;
+};
+
+list<ref_comb_t> make_ref(const TCandidateList& cands, unsigned nPhotons, double maxDiscardedEk,
+                          const IntervalD& im_cut, const TTaggerHit& taggerhit, const IntervalD& mm_cut)
+{
+    TCandidatePtrList photons;
+    for(auto cand : cands.get_iter())
+        photons.push_back(cand);
+    std::stable_sort(photons.begin(), photons.end(), [] (const TCandidatePtr& a, const TCandidatePtr& b) {
+        return a->CaloEnergy > b->CaloEnergy;
+    });
+
+    list<ref_comb_t> combs;
+    for(auto proton : cands.get_iter()) {
+        ref_comb_t comb;
+        comb.Proton = proton;
+        for(auto photon : photons)
+            if(photon != comb.Proton)
+                comb.Photons.push_back(photon);
+        if(comb.Photons.size() < nPhotons)
+            continue;
+        comb.DiscardedEk = 0;
+        for(auto i=nPhotons;i<comb.Photons.size();i++)
+            comb.DiscardedEk += comb.Photons[i]->CaloEnergy; // Ek of a photon
+        if(comb.DiscardedEk >= maxDiscardedEk)
+            continue;
+        comb.Photons.resize(nPhotons);
+        for(auto photon : comb.Photons)
+            comb.PhotonSum += TParticle(ParticleTypeDatabase::Photon, photon->CaloEnergy, photon->Theta, photon->Phi);
+        if(!im_cut.Contains(comb.PhotonSum.M()))
+            continue;
+        const auto beam_target = taggerhit.GetPhotonBeam() + LorentzVec::AtRest(ParticleTypeDatabase::Proton.Mass());
+        comb.MissingMass = (beam_target - comb.PhotonSum).M();
+        if(!mm_cut.Contains(comb.MissingMass))
+            continue;
+        combs.emplace_back(move(comb));
+    }
+    return combs;
+}
+
+void dotest_compare() {
+    std::mt19937 rng(0);
+    const TTaggerHit taggerhit(0, 1500, 0);
+
+    for(unsigned n=0;n<=10;n++) {
+        const auto cands = make_cands(n, rng);
+        ProtonPhotonCombs proton_photons(cands);
+
+        for(unsigned nPhotons=0;nPhotons<=n;nPhotons++) {
+            for(double maxDiscardedEk : {std_ext::inf, 300.0}) {
+                INFO("n=" << n << " nPhotons=" << nPhotons << " maxDiscardedEk=" << maxDiscardedEk);
+                const IntervalD im_cut{100, std_ext::inf};
+                const IntervalD mm_cut{500, 1200};
+
+                auto combs = proton_photons()
+                             .FilterMult(nPhotons, maxDiscardedEk)
+                             .FilterIM(im_cut)
+                             .FilterMM(taggerhit, mm_cut);
+                const auto expected = make_ref(cands, nPhotons, maxDiscardedEk, im_cut, taggerhit, mm_cut);
+
+                REQUIRE(combs.size() == expected.size());
+                auto it_expected = expected.begin();
+                for(const auto& comb : combs) {
+                    REQUIRE(comb.Proton()->Candidate == it_expected->Proton);
+                    REQUIRE(comb.Proton()->Type() == ParticleTypeDatabase::Proton);
+                    REQUIRE(comb.NPhotons() == nPhotons);
+                    const auto photons = comb.Photons();
+                    REQUIRE(photons.size() == nPhotons);
+                    for(unsigned i=0;i<nPhotons;i++) {
+                        CHECK(photons[i]->Candidate == it_expected->Photons[i]);
+                        CHECK(photons[i]->Type() == ParticleTypeDatabase::Photon);
+                    }
+                    CHECK(comb.DiscardedEk == Approx(it_expected->DiscardedEk));
+                    CHECK(comb.PhotonSum.M() == Approx(it_expected->PhotonSum.M()));
+                    CHECK(comb.MissingMass == Approx(it_expected->MissingMass));
+                    ++it_expected;
+                }
+            }
+        }
+
+        // the pre-built combinations stay untouched
+        const auto all = proton_photons();
+        REQUIRE(all.size() == n);
+        for(const auto& comb : all)
+            CHECK(comb.NPhotons()+1 == n);
+    }
+}
+
+void dotest_observer() {
+    std::mt19937 rng(1);
+    const auto cands = make_cands(6, rng);
+    ProtonPhotonCombs proton_photons(cands);
+
+    unsigned nObserved = 0;
+    auto combs = proton_photons()
+                 .Observe([&nObserved] (const string& s) {
+                     CHECK(s.substr(0, 2) == "S ");
+                     nObserved++;
+                 }, "S ")
+                 .FilterMult(4, 200.0);
+
+    // once for each combination in Observe, once again for each passing FilterMult
+    CHECK(nObserved == 6 + combs.size());
+}
+
+void dotest_toomany() {
+    std::mt19937 rng(2);
+
+    const auto max_cands = make_cands(ProtonPhotonCombs::MaxCandidates, rng);
+    const auto max_combs = ProtonPhotonCombs(max_cands)();
+    REQUIRE(max_combs.size() == ProtonPhotonCombs::MaxCandidates);
+    CHECK(max_combs.front().NPhotons() == ProtonPhotonCombs::MaxCandidates-1);
+
+    const auto cands = make_cands(ProtonPhotonCombs::MaxCandidates+1, rng);
+    CHECK(ProtonPhotonCombs(cands)().empty());
+}
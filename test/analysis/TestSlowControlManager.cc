@@ -24,6 +24,7 @@
 #include <iostream>
 #include <list>
 #include <queue>
+#include <thread>
 
 using namespace std;
 using namespace ant;
@@ -45,7 +46,7 @@ struct result_t {
     unsigned nEventsSavedForSC = 0;
 };
 
-result_t run_TestSlowControlManager(const vector<unsigned>& enabled);
+result_t run_TestSlowControlManager(const vector<unsigned>& enabled, bool useEpochs = false);
 
 TEST_CASE("SlowControlManager: Processors {1}", "[analysis]") {
     auto r = run_TestSlowControlManager({1});
@@ -119,6 +120,25 @@ TEST_CASE("SlowControlManager: Processors {1,2,3,4}", "[analysis]") {
     CHECK(r.nEventsSavedForSC == 8);
 }
 
+void dotest_ConcurrentEpochs(const vector<unsigned>& enabled);
+
+TEST_CASE("SlowControlManager: Concurrent epochs", "[analysis]") {
+    dotest_ConcurrentEpochs({1});
+    dotest_ConcurrentEpochs({1,2,3,4});
+}
+
+TEST_CASE("SlowControlManager: Epochs", "[analysis]") {
+    // epochs must give the same values as popping single events
+    for(const vector<unsigned>& enabled : vector<vector<unsigned>>{{1}, {2}, {3}, {4}, {1,2}, {3,4}, {1,4}, {2,3}, {1,2,3,4}}) {
+        auto r_epochs = run_TestSlowControlManager(enabled, true);
+        auto r_events = run_TestSlowControlManager(enabled, false);
+        CHECK(r_epochs.nEventsPopped == r_events.nEventsPopped);
+        CHECK(r_epochs.nContextSwitched == r_events.nContextSwitched);
+        CHECK(r_epochs.nEventsSkipped == r_events.nEventsSkipped);
+        CHECK(r_epochs.nEventsSavedForSC == r_events.nEventsSavedForSC);
+    }
+}
+
 // see https://github.com/zjx20/stealer for STEALER usage
 
 STEALER(stealer_Variable_t, slowcontrol::Variable,
@@ -298,7 +318,19 @@ struct TestProcessor : slowcontrol::Processor {
         nCompleted++;
         q.emplace(nCompleted);
     }
+    struct value_state_t : state_t {
+        explicit value_state_t(unsigned value) : Value(value) {}
+        const unsigned Value;
+    };
+    virtual bool GetStates(states_t& states) const override {
+        if(q.empty())
+            return false;
+        states.emplace_back(this, make_shared<value_state_t>(q.front()));
+        return true;
+    }
     virtual unsigned Get() const {
+        if(auto state = dynamic_pointer_cast<const value_state_t>(GetEpochState()))
+            return state->Value;
         if(q.empty())
            return 0;
         return q.front();
@@ -481,7 +513,7 @@ struct TestSlowControlManager : SlowControlManager {
     }
 };
 
-result_t run_TestSlowControlManager(const vector<unsigned>& enabled) {
+result_t run_TestSlowControlManager(const vector<unsigned>& enabled, bool useEpochs) {
     TestSlowControlManager scm(enabled);
 
     // this is basically how PhysicsManager drives the SlowControlManager
@@ -533,8 +565,7 @@ result_t run_TestSlowControlManager(const vector<unsigned>& enabled) {
 
         r.nContextSwitched++;
 
-        while(auto event = scm.PopEvent()) {
-
+        auto record = [&r, &scm, &values, &values_expected] (const slowcontrol::event_t& event) {
             REQUIRE(event.Event.HasReconstructed());
             r.nEventsPopped++;
             r.nEventsSkipped += event.WantsSkip;
@@ -547,6 +578,21 @@ result_t run_TestSlowControlManager(const vector<unsigned>& enabled) {
                 values.back().ProcValues.emplace_back(event.WantsSkip ? 0 : p->Get(), p->HasChanged());
                 values_expected.back().ProcValues.emplace_back( p->GetExpected().at(tid.Timestamp) );
             }
+        };
+
+        if(useEpochs) {
+            while(auto epoch = scm.PopEpoch()) {
+                slowcontrol::epoch_t::Scope scope(epoch);
+                for(const auto& event : epoch.Events) {
+                    record(event);
+                    if(!event.WantsSkip)
+                        epoch.ClearChanged();
+                }
+            }
+        }
+        else {
+            while(auto event = scm.PopEvent())
+                record(event);
         }
     }
 
@@ -578,3 +624,66 @@ result_t run_TestSlowControlManager(const vector<unsigned>& enabled) {
 
     return r;
 }
+
+void dotest_ConcurrentEpochs(const vector<unsigned>& enabled) {
+    TestSlowControlManager scm(enabled);
+    const auto testprocs = scm.GetTestProcessors();
+
+    // pop all epochs first, so the processors have moved on
+    // and the epochs can only rely on their own values
+    vector<slowcontrol::epoch_t> epochs;
+    unsigned nEventsRead = 0;
+    while(nEventsRead<maxEvents) {
+        while(nEventsRead<maxEvents) {
+            input::event_t event;
+            event.MakeReconstructed(TID(nEventsRead++));
+            if(scm.ProcessEvent(move(event)))
+                break;
+        }
+        while(auto epoch = scm.PopEpoch())
+            epochs.emplace_back(move(epoch));
+    }
+    REQUIRE(epochs.size()>1);
+
+    using values_t = vector<vector<procvalue_t>>;
+    auto process = [&testprocs] (slowcontrol::epoch_t& epoch, values_t& values) {
+        slowcontrol::epoch_t::Scope scope(epoch);
+        for(const auto& event : epoch.Events) {
+            if(event.WantsSkip)
+                continue;
+            values.emplace_back();
+            for(auto& p : testprocs)
+                values.back().emplace_back(p->Get(), p->HasChanged());
+            epoch.ClearChanged();
+        }
+    };
+
+    // each epoch is processed in its own thread
+    vector<values_t> values(epochs.size());
+    {
+        vector<thread> threads;
+        for(size_t i=0;i<epochs.size();i++)
+            threads.emplace_back(process, ref(epochs[i]), ref(values[i]));
+        for(auto& t : threads)
+            t.join();
+    }
+    CHECK(slowcontrol::epoch_t::Current() == nullptr);
+
+    for(size_t i=0;i<epochs.size();i++) {
+        size_t j=0;
+        for(const auto& event : epochs[i].Events) {
+            if(event.WantsSkip)
+                continue;
+            INFO("Epoch " << i << " Timestamp " << event.Event.Reconstructed().ID.Timestamp);
+            REQUIRE(j<values[i].size());
+            for(size_t k=0;k<testprocs.size();k++) {
+                const auto& v = values[i][j][k];
+                CHECK(v.Value == testprocs[k]->GetExpected().at(event.Event.Reconstructed().ID.Timestamp).Value);
+                // only the first processed event of an epoch might see a change
+                if(j>0)
+                    CHECK_FALSE(v.HasChanged);
+            }
+            j++;
+        }
+    }
+}
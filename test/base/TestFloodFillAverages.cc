@@ -1,8 +1,12 @@
 #include "catch.hpp"
 
 #include "base/FloodFillAverages.h"
+#include "base/SavitzkyGolay.h"
 #include "base/std_ext/math.h"
 
+#include <random>
+#include <chrono>
+
 using namespace std;
 using namespace ant;
 using namespace ant::std_ext;
@@ -33,6 +37,8 @@ void dotest_simple();
 void dotest_edge1();
 void dotest_edge2();
 void dotest_cyclic();
+void dotest_neighbourtable();
+void dotest_benchmark();
 
 
 TEST_CASE("FloodFillAverages: Simple", "[base]") {
@@ -51,6 +57,14 @@ TEST_CASE("FloodFillAverages: Cyclic", "[base]") {
     dotest_cyclic();
 }
 
+TEST_CASE("FloodFillAverages: Neighbour table", "[base]") {
+    dotest_neighbourtable();
+}
+
+TEST_CASE("FloodFillAverages: Benchmark", "[base][.bench]") {
+    dotest_benchmark();
+}
+
 void dotest_simple() {
     vector<double> numbers{
         0.5, NaN, 0.5,  // 0,1,2
@@ -122,3 +136,94 @@ void dotest_cyclic() {
         CHECK(ring[i] == Approx(i<5 ? 0.1 : 0.2));
 
 }
+
+void dotest_neighbourtable() {
+    const FloodFillNeighbours neighbours(9, getNeighbours);
+    REQUIRE(neighbours.Size() == 9);
+    CHECK(vector<int>(neighbours.begin(4), neighbours.end(4)) == getNeighbours(4));
+
+    // same as dotest_edge2, but the table is reused
+    for(int n=0;n<2;n++) {
+        vector<double> numbers{
+            0.1, NaN, NaN,  // 0,1,2
+            NaN, NaN, NaN,  // 3,4,5
+            NaN, NaN, 0.5   // 6,7,8
+        };
+        floodFillAverages(neighbours,
+          [&numbers] (int i) { return numbers[i]; },
+          [&numbers] (int i, double v) { numbers[i] = v; },
+          [&numbers] (int i) { return isfinite(numbers[i]); }
+        );
+        CHECK(numbers[1] == Approx(0.1));
+        CHECK(numbers[2] == Approx(0.3));
+        CHECK(numbers[4] == Approx(0.3));
+        CHECK(numbers[5] == Approx(0.5));
+    }
+}
+
+
+void dotest_benchmark() {
+    // the relative gains of a grid of channels with some broken ones
+    // are flood filled on each load, that is for each range of a beamtime,
+    // and then smoothed over all ranges as Ant-calib-smooth does
+    constexpr int nX = 24;
+    constexpr int nY = 30;
+    constexpr int N = nX*nY;
+    constexpr unsigned nRanges = 3000;
+
+    auto gridNeighbours = [] (int i) {
+        const int x = i % nX;
+        const int y = i / nX;
+        vector<int> n;
+        if(x>0)    n.push_back(i-1);
+        if(x<nX-1) n.push_back(i+1);
+        if(y>0)    n.push_back(i-nX);
+        if(y<nY-1) n.push_back(i+nX);
+        return n;
+    };
+
+    std::mt19937 rng(0);
+    std::normal_distribution<double> values(1, 0.1);
+    std::bernoulli_distribution broken(0.05);
+    vector<char> isBroken(N);
+    for(auto& b : isBroken)
+        b = broken(rng);
+    vector<double> loaded(nRanges*N);
+    for(auto& v : loaded)
+        v = values(rng);
+
+    auto floodFill = [&isBroken] (const FloodFillNeighbours& neighbours, double* v) {
+        floodFillAverages(neighbours,
+          [v] (int i) { return v[i]; },
+          [v] (int i, double val) { v[i] = val; },
+          [&isBroken] (int i) { return !isBroken[i]; }
+        );
+    };
+
+    // the neighbours are looked up on each load
+    auto interleaved_lookup = loaded;
+    auto start = chrono::steady_clock::now();
+    for(unsigned r=0;r<nRanges;r++)
+        floodFill(FloodFillNeighbours(N, gridNeighbours), addressof(interleaved_lookup[r*N]));
+    const chrono::duration<double> t_lookup = chrono::steady_clock::now() - start;
+
+    // the table is built once
+    auto interleaved_table = loaded;
+    start = chrono::steady_clock::now();
+    const FloodFillNeighbours neighbours(N, gridNeighbours);
+    for(unsigned r=0;r<nRanges;r++)
+        floodFill(neighbours, addressof(interleaved_table[r*N]));
+    const chrono::duration<double> t_table = chrono::steady_clock::now() - start;
+
+    REQUIRE(interleaved_table == interleaved_lookup);
+
+    start = chrono::steady_clock::now();
+    SavitzkyGolay sg(10,4);
+    const auto smoothed = sg.Smooth(interleaved_table, N);
+    const chrono::duration<double> t_smooth = chrono::steady_clock::now() - start;
+
+    REQUIRE(smoothed.size() == interleaved_table.size());
+    WARN("Flood fill of " << nRanges << " loads with lookup: " << t_lookup.count() << " s, "
+         << "with table: " << t_table.count() << " s, "
+         << "smoothing all channels: " << t_smooth.count() << " s");
+}
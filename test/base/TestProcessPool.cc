@@ -0,0 +1,125 @@
+#include "catch.hpp"
+
+#include "base/ProcessPool.h"
+#include "base/tmpfile_t.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+
+unsigned countLines(const string& filename) {
+    ifstream f(filename);
+    string line;
+    unsigned n = 0;
+    while(getline(f, line))
+        n++;
+    return n;
+}
+
+TEST_CASE("ProcessPool: Run tasks", "[base]") {
+    tmpfolder_t folder;
+    vector<tmpfile_t> outputs;
+    for(unsigned i=0;i<5;i++)
+        outputs.emplace_back(folder, "txt");
+
+    ProcessPool pool(2);
+    for(unsigned i=0;i<outputs.size();i++) {
+        const auto& filename = outputs[i].filename;
+        pool.Add(to_string(i), [i, filename] () {
+            ofstream(filename) << i << endl;
+            return ProcessPool::ReportProgress(0.5);
+        });
+    }
+    REQUIRE(pool.GetNTasks() == 5);
+    REQUIRE(pool.Wait());
+    CHECK(pool.GetNSucceeded() == 5);
+    CHECK(pool.GetNRunning() == 0);
+    CHECK(pool.GetProgress() == Approx(1.0));
+
+    for(unsigned i=0;i<outputs.size();i++) {
+        ifstream f(outputs[i].filename);
+        unsigned j;
+        REQUIRE(f >> j);
+        CHECK(i == j);
+    }
+
+    // the parent process is not a worker
+    CHECK_FALSE(ProcessPool::ReportProgress(0.5));
+}
+
+TEST_CASE("ProcessPool: Retry failed tasks", "[base]") {
+    tmpfolder_t folder;
+    tmpfile_t attempts_flaky(folder, "txt");
+    tmpfile_t attempts_broken(folder, "txt");
+
+    ProcessPool pool(2);
+    pool.MaxRetries = 2;
+
+    // fails on first attempt only
+    const auto& flaky = attempts_flaky.filename;
+    const auto i_flaky = pool.Add("flaky", [flaky] () {
+        const bool first = countLines(flaky) == 0;
+        ofstream(flaky, ios::app) << "attempt" << endl;
+        return !first;
+    });
+
+    const auto& broken = attempts_broken.filename;
+    const auto i_broken = pool.Add("broken", [broken] () {
+        ofstream(broken, ios::app) << "attempt" << endl;
+        return false;
+    });
+
+    const auto i_throws = pool.Add("throws", [] () -> bool {
+        throw runtime_error("Failing task");
+    });
+
+    CHECK_FALSE(pool.Wait());
+    CHECK(pool.Succeeded(i_flaky));
+    CHECK_FALSE(pool.Succeeded(i_broken));
+    CHECK_FALSE(pool.Succeeded(i_throws));
+    CHECK(countLines(flaky) == 2);
+    CHECK(countLines(broken) == 3);
+}
+
+TEST_CASE("ProcessPool: Exec programs", "[base]") {
+    ProcessPool pool(2);
+    pool.MaxRetries = 0;
+    const auto i_true = pool.Add("true", ProcessPool::Exec({"/bin/sh", "-c", "exit 0"}));
+    const auto i_false = pool.Add("false", ProcessPool::Exec({"/bin/sh", "-c", "exit 1"}));
+    const auto i_missing = pool.Add("missing", ProcessPool::Exec({"/nonexistent/program"}));
+    CHECK_FALSE(pool.Wait());
+    CHECK(pool.Finished(i_false));
+    CHECK(pool.Succeeded(i_true));
+    CHECK_FALSE(pool.Succeeded(i_false));
+    CHECK_FALSE(pool.Succeeded(i_missing));
+}
+
+TEST_CASE("ProcessPool: Prune finished tasks", "[base]") {
+    ProcessPool pool(2);
+    pool.MaxRetries = 0;
+    const auto i_first = pool.Add("first", [] () { return true; });
+    const auto i_second = pool.Add("second", [] () { return false; });
+    REQUIRE_FALSE(pool.Wait());
+    const auto i_third = pool.Add("third", [] () { return true; });
+
+    // only finished tasks in front are forgotten
+    pool.Prune();
+    CHECK(pool.GetNTasks() == 3);
+    CHECK(pool.GetNSucceeded() == 1);
+    CHECK(pool.Succeeded(i_third) == false);
+    REQUIRE_THROWS_AS(pool.Succeeded(i_first), ProcessPool::Exception);
+    REQUIRE_THROWS_AS(pool.Finished(i_second), ProcessPool::Exception);
+
+    CHECK_FALSE(pool.Wait());
+    CHECK(pool.Succeeded(i_third));
+    pool.Prune();
+    CHECK(pool.GetNTasks() == 3);
+    CHECK(pool.GetNSucceeded() == 2);
+    CHECK(pool.GetProgress() == Approx(2.0/3.0));
+
+    // indices continue after pruning
+    CHECK(pool.Add("fourth", [] () { return true; }) == 3);
+}
@@ -2,6 +2,10 @@
 
 #include "base/SavitzkyGolay.h"
 
+#include <random>
+#include <chrono>
+#include <cmath>
+
 using namespace std;
 using namespace ant;
 
@@ -16,3 +20,68 @@ TEST_CASE("SavitzkyGolay: Constant values", "[base/std_ext]") {
         REQUIRE(smoothed[i] == Approx(expected[i]));
     }
 }
+
+TEST_CASE("SavitzkyGolay: Many series", "[base/std_ext]") {
+    SavitzkyGolay sg(7,3);
+    constexpr unsigned nSeries = 5;
+    constexpr unsigned nPoints = 30;
+
+    std::mt19937 rng(0);
+    std::normal_distribution<double> noise(0, 0.1);
+    vector<vector<double>> series(nSeries);
+    vector<double> interleaved(nSeries*nPoints);
+    for(unsigned i=0;i<nPoints;i++) {
+        for(unsigned s=0;s<nSeries;s++) {
+            const double v = std::sin(0.2*i+s) + noise(rng);
+            series[s].push_back(v);
+            interleaved[i*nSeries+s] = v;
+        }
+    }
+
+    auto smoothed = sg.Smooth(interleaved, nSeries);
+    REQUIRE(smoothed.size() == interleaved.size());
+    for(unsigned s=0;s<nSeries;s++) {
+        auto expected = sg.Smooth(series[s]);
+        for(unsigned i=0;i<nPoints;i++) {
+            INFO("s=" << s << " i=" << i);
+            REQUIRE(smoothed[i*nSeries+s] == Approx(expected[i]));
+        }
+    }
+
+    REQUIRE_THROWS_AS(sg.Smooth(interleaved, 7), SavitzkyGolay::Exception);
+    REQUIRE_THROWS_AS(sg.Smooth(vector<double>(2*nSeries), nSeries), SavitzkyGolay::Exception);
+}
+
+TEST_CASE("SavitzkyGolay: Benchmark", "[base/std_ext][.bench]") {
+    SavitzkyGolay sg(10,4);
+    // channels and ranges of a beamtime
+    constexpr unsigned nSeries = 720;
+    constexpr unsigned nPoints = 3000;
+
+    std::mt19937 rng(0);
+    std::normal_distribution<double> values(1, 0.1);
+    vector<double> interleaved(nSeries*nPoints);
+    for(auto& v : interleaved)
+        v = values(rng);
+
+    auto start = chrono::steady_clock::now();
+    double sum_single = 0;
+    for(unsigned s=0;s<nSeries;s++) {
+        interval<int> range(0, nPoints-1);
+        for(unsigned i=0;i<nPoints;i++) {
+            auto getY = [&interleaved, i, s] (int i_) { return interleaved[(i+i_)*nSeries+s]; };
+            auto setY = [&sum_single] (double v) { sum_single += v; };
+            sg.Convolute(getY, setY, range-int(i));
+        }
+    }
+    const chrono::duration<double> t_single = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    double sum_batch = 0;
+    for(auto v : sg.Smooth(interleaved, nSeries))
+        sum_batch += v;
+    const chrono::duration<double> t_batch = chrono::steady_clock::now() - start;
+
+    CHECK(sum_batch == Approx(sum_single));
+    WARN("Convolute per point: " << t_single.count() << " s, all series at once: " << t_batch.count() << " s");
+}
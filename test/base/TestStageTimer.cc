@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "base/StageTimer.h"
+
+#include <thread>
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+using namespace ant;
+
+TEST_CASE("StageTimer: Registry", "[base]") {
+    const auto n = StageTimer::GetAll().size();
+    {
+        StageTimer t1("t1");
+        StageTimer t2("t2");
+        REQUIRE(StageTimer::GetAll().size() == n+2);
+        CHECK(StageTimer::GetAll().back() == &t2);
+    }
+    REQUIRE(StageTimer::GetAll().size() == n);
+}
+
+TEST_CASE("StageTimer: Binning", "[base]") {
+    StageTimer t("test");
+
+    // edges are increasing, first one is 64ns
+    CHECK(StageTimer::GetBinEdge(0) == Approx(64e-9));
+    CHECK(StageTimer::GetBinEdge(StageTimer::BinsPerOctave) == Approx(128e-9));
+    for(unsigned i=0;i<StageTimer::nBins;i++)
+        REQUIRE(StageTimer::GetBinEdge(i) < StageTimer::GetBinEdge(i+1));
+
+    // each duration ends up in the bin containing it
+    for(long long ns : {100LL, 1000LL, 12345LL, 999999LL, 123456789LL}) {
+        t.Add(chrono::nanoseconds(ns));
+        const auto it = find_if(t.Histogram.begin(), t.Histogram.end(), [] (uint64_t c) { return c>0; });
+        const auto bin = unsigned(distance(t.Histogram.begin(), it));
+        CHECK(StageTimer::GetBinEdge(bin) <= ns*1e-9);
+        CHECK(StageTimer::GetBinEdge(bin+1) > ns*1e-9);
+        t.Histogram.fill(0);
+    }
+
+    // underflow and overflow
+    t.Add(chrono::nanoseconds(1));
+    t.Add(chrono::hours(1));
+    CHECK(t.Histogram.front() == 1);
+    CHECK(t.Histogram.back() == 1);
+    CHECK(t.Calls == 7);
+}
+
+TEST_CASE("StageTimer: Scope", "[base]") {
+    StageTimer t("test");
+    {
+        StageTimer::scope_t s(t);
+        this_thread::sleep_for(chrono::milliseconds(2));
+    }
+    CHECK(t.Calls == 1);
+    CHECK(t.Total.count() >= 2e-3);
+    CHECK(accumulate(t.Histogram.begin(), t.Histogram.end(), uint64_t(0)) == 1);
+
+    StageTimer::Enabled = false;
+    {
+        StageTimer::scope_t s(t);
+    }
+    StageTimer::Enabled = true;
+    CHECK(t.Calls == 1);
+}
+
+TEST_CASE("StageTimer: Sum", "[base]") {
+    StageTimer t("test");
+    {
+        StageTimer::sum_t sum(t);
+        for(int i=0;i<3;i++) {
+            StageTimer::sum_t::scope_t s(sum);
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        // nothing recorded until the sum ends
+        CHECK(t.Calls == 0);
+    }
+    CHECK(t.Calls == 1);
+    CHECK(t.Total.count() >= 3e-3);
+    CHECK(accumulate(t.Histogram.begin(), t.Histogram.end(), uint64_t(0)) == 1);
+}
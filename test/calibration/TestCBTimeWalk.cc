@@ -0,0 +1,122 @@
+#include "catch.hpp"
+
+#include "calibration/modules/CB_TimeWalk.h"
+#include "calibration/fitfunctions/FitTimewalk.h"
+#include "calibration/fitfunctions/BaseFunctions.h"
+#include "calibration/DataManager.h"
+
+#include "expconfig/detectors/CB.h"
+
+#include "base/tmpfile_t.h"
+#include "base/std_ext/math.h"
+
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration;
+
+void dotest_batched();
+
+TEST_CASE("CB_TimeWalk: Batched evaluation", "[calibration]") {
+    dotest_batched();
+}
+
+struct CB_TimeWalk_Test : CB_TimeWalk {
+    using CB_TimeWalk::CB_TimeWalk;
+
+    // what the loader does for each channel
+    void Load(unsigned ch, const vector<double>& data) {
+        timewalks.at(ch)->Load(data);
+    }
+    void Update() {
+        UpdateTimewalkTable();
+    }
+    const gui::FitTimewalk& GetTimewalk(unsigned ch) const {
+        return *timewalks.at(ch);
+    }
+    size_t GetTableSize() const {
+        return timewalk_table.size();
+    }
+};
+
+void dotest_batched() {
+    auto cb = make_shared<expconfig::detector::CB>();
+    tmpfolder_t tmpfolder;
+    CB_TimeWalk_Test cb_timewalk(cb, make_shared<DataManager>(tmpfolder.foldername),
+                                 {-std_ext::inf, std_ext::inf});
+
+    const auto nChannels = cb->GetNChannels();
+    // one row per channel, the start of the fit range followed by the parameters
+    REQUIRE(functions::timewalk::nParameters+1 == 7);
+    REQUIRE(cb_timewalk.GetTableSize() == 7*nChannels);
+
+    vector<unsigned> channels;
+    for(unsigned ch=0;ch<nChannels;ch++) {
+        if(!cb->HasElementFlags(ch, Detector_t::ElementFlag_t::BadTDC))
+            channels.push_back(ch);
+    }
+    REQUIRE_FALSE(channels.empty());
+
+    std::mt19937 rng(0);
+    using uniform = std::uniform_real_distribution<double>;
+    std::uniform_int_distribution<size_t> channel(0, channels.size()-1);
+    std::uniform_int_distribution<unsigned> nTimings(1, 3);
+
+    for(unsigned round=0;round<5;round++) {
+
+        // random parameters within the limits of FitTimewalk
+        for(unsigned ch=0;ch<nChannels;ch++) {
+            cb_timewalk.Load(ch, {
+                                 uniform(0, 1.5)(rng), 4, // range
+                                 uniform(-100, 100)(rng), // Offset
+                                 uniform(0, 1000)(rng),   // Scale
+                                 uniform(0.5, 1.3)(rng),  // E0
+                                 uniform(0.0001, 3)(rng), // Pow
+                                 uniform(0, 5)(rng),      // Exp
+                                 uniform(-0.5, 0)(rng)    // Slope
+                             });
+        }
+        cb_timewalk.Update();
+
+        // one event with many hits, some below the fit range and the asymptote
+        TClusterHitList hits;
+        for(unsigned i=0;i<500;i++) {
+            hits.emplace_back(channels[channel(rng)], 1, std_ext::NaN);
+            auto& hit = hits.back();
+            const double raw_energy = std::pow(10, uniform(0, 4)(rng));
+            hit.Data.emplace_back(Channel_t::Type_t::Integral, TDetectorReadHit::Value_t(raw_energy));
+            for(unsigned t=nTimings(rng);t>0;t--)
+                hit.Data.emplace_back(Channel_t::Type_t::Timing, TDetectorReadHit::Value_t(uniform(-50, 300)(rng)));
+        }
+
+        ReconstructHook::ClusterHits::clusterhits_t sorted_clusterhits;
+        sorted_clusterhits[Detector_t::Type_t::CB] = hits;
+        cb_timewalk.ApplyTo(sorted_clusterhits);
+        const auto& corrected = sorted_clusterhits[Detector_t::Type_t::CB];
+        REQUIRE(corrected.size() == hits.size());
+
+        for(size_t i=0;i<hits.size();i++) {
+            const auto& hit = hits[i];
+            INFO("Round " << round << " " << hit);
+
+            // per-hit evaluation as FitTimewalk does it
+            const auto& timewalk = cb_timewalk.GetTimewalk(hit.Channel);
+            const double deltaT = timewalk.Eval(std::log10(hit.Data.front().Value.Uncalibrated));
+            REQUIRE(std::isfinite(deltaT));
+
+            double closest = std_ext::NaN;
+            for(const auto& datum : hit.Data) {
+                if(datum.Type != Channel_t::Type_t::Timing)
+                    continue;
+                const auto timing = datum.Value.Calibrated;
+                if(!std::isfinite(closest) || std::abs(timing - deltaT) < std::abs(closest - deltaT))
+                    closest = timing;
+            }
+
+            CHECK(corrected[i].Time == Approx(closest - deltaT));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+
+#include "calibration/modules/detail/GainIterator.h"
+
+#include "tree/TCluster.h"
+
+#include <random>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration::detail;
+
+void dotest_evaluate();
+void dotest_iterate();
+
+TEST_CASE("GainIterator: Evaluate", "[calibration]") {
+    dotest_evaluate();
+}
+
+TEST_CASE("GainIterator: Iterate", "[calibration]") {
+    dotest_iterate();
+}
+
+// some miscalibrated channels, the clusters have an energy correction applied
+const vector<double> miscalibration = {1.0, 1.1, 0.9, 1.05};
+const double correction = 1.02;
+
+TCluster makeCluster(unsigned channel, double E) {
+    const double hitE = E*miscalibration.at(channel);
+    return TCluster(vec3(0,0,1), correction*hitE, 0, Detector_t::Type_t::CB, channel,
+                    {TClusterHit(channel, hitE, 0)});
+}
+
+void fillPairs(GainIterator& gi, vector<double>& imasses, unsigned nPairs) {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<unsigned> channel(0, miscalibration.size()-1);
+    std::uniform_real_distribution<double> energy(100, 500);
+    std::normal_distribution<double> mass(135, 8);
+
+    for(unsigned i=0;i<nPairs;i++) {
+        const auto E1 = energy(gen);
+        const auto E2 = energy(gen);
+        // the opening angle is given by the true mass and energies
+        const auto opening = std::pow(mass(gen), 2)/(E1*E2);
+        const auto cl1 = makeCluster(channel(gen), E1);
+        const auto cl2 = makeCluster(channel(gen), E2);
+        const auto imass = std::sqrt(opening*cl1.Energy*cl2.Energy);
+        gi.AddPair(cl1, cl2, imass);
+        imasses.push_back(imass);
+    }
+}
+
+void dotest_evaluate() {
+    GainIterator gi(miscalibration.size());
+    vector<double> imasses;
+    fillPairs(gi, imasses, 100);
+    REQUIRE(gi.GetNPairs() == 100);
+
+    // unchanged factors reproduce the masses
+    vector<double> evaluated;
+    gi.Evaluate(evaluated);
+    REQUIRE(evaluated.size() == imasses.size());
+    for(size_t i=0;i<imasses.size();i++)
+        CHECK(evaluated[i] == Approx(imasses[i]));
+
+    // scaling all gains scales the masses
+    gi.SetFactors(vector<double>(miscalibration.size(), 2.0));
+    gi.Evaluate(evaluated);
+    for(size_t i=0;i<imasses.size();i++)
+        CHECK(evaluated[i] == Approx(2*imasses[i]));
+
+    REQUIRE_THROWS(gi.SetFactors({1.0}));
+}
+
+void dotest_iterate() {
+    GainIterator gi(miscalibration.size());
+    vector<double> imasses;
+    fillPairs(gi, imasses, 20000);
+
+    GainIterator::settings_t settings;
+    settings.PeakPosition = 135;
+    const auto iterations = gi.Iterate(settings);
+    CHECK(iterations > 1);
+    CHECK(iterations < settings.MaxIterations);
+
+    const auto& factors = gi.GetFactors();
+    REQUIRE(factors.size() == miscalibration.size());
+    for(size_t ch=0;ch<factors.size();ch++)
+        CHECK(factors[ch]*correction*miscalibration[ch] == Approx(1).epsilon(0.01));
+}
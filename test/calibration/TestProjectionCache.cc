@@ -0,0 +1,112 @@
+#include "catch.hpp"
+
+#include "calibration/gui/ProjectionCache.h"
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+
+#include <random>
+#include <memory>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration::gui;
+
+void dotest_projectionx();
+void dotest_projectionyx();
+void dotest_newhist();
+
+TEST_CASE("ProjectionCache: ProjectionX", "[calibration]") {
+    dotest_projectionx();
+}
+
+TEST_CASE("ProjectionCache: ProjectionYX", "[calibration]") {
+    dotest_projectionyx();
+}
+
+TEST_CASE("ProjectionCache: New histogram", "[calibration]") {
+    dotest_newhist();
+}
+
+constexpr unsigned nChannels = 10;
+
+unique_ptr<TH2D> makeTH2(unsigned nFills, bool weighted) {
+    auto h = unique_ptr<TH2D>(new TH2D("h2","h2",50,-10,10,nChannels,0,nChannels));
+    h->SetDirectory(nullptr);
+    std::mt19937 gen(1234);
+    std::normal_distribution<double> x(0, 3);
+    std::uniform_int_distribution<unsigned> ch(0, nChannels-1);
+    std::uniform_real_distribution<double> w(0.5, 2);
+    for(unsigned i=0;i<nFills;i++)
+        h->Fill(x(gen), ch(gen), weighted ? w(gen) : 1.0);
+    return h;
+}
+
+void compare(const TH1& expected, const TH1& actual) {
+    REQUIRE(expected.GetNcells() == actual.GetNcells());
+    for(int bin=0;bin<expected.GetNcells();bin++) {
+        INFO("bin=" << bin);
+        CHECK(actual.GetBinContent(bin) == Approx(expected.GetBinContent(bin)));
+        CHECK(actual.GetBinError(bin) == Approx(expected.GetBinError(bin)));
+    }
+    CHECK(actual.GetEntries() == Approx(expected.GetEntries()));
+    CHECK(actual.GetMean() == Approx(expected.GetMean()));
+}
+
+void dotest_projectionx() {
+    for(bool weighted : {false, true}) {
+        auto h = makeTH2(10000, weighted);
+        ProjectionCache cache;
+        // jump around like the user does in the GUI
+        for(unsigned ch : {0u, 1u, 5u, 2u, 9u, 5u}) {
+            INFO("ch=" << ch << " weighted=" << weighted);
+            unique_ptr<TH1D> expected(h->ProjectionX("expected", ch+1, ch+1));
+            expected->SetDirectory(nullptr);
+            auto actual = cache.ProjectionX(*h, ch);
+            REQUIRE(actual != nullptr);
+            compare(*expected, *actual);
+        }
+    }
+}
+
+void dotest_projectionyx() {
+    auto h = unique_ptr<TH3D>(new TH3D("h3","h3",20,0,10,30,-5,5,nChannels,0,nChannels));
+    h->SetDirectory(nullptr);
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> x(0, 10);
+    std::normal_distribution<double> y(0, 2);
+    std::uniform_int_distribution<unsigned> ch(0, nChannels-1);
+    for(unsigned i=0;i<20000;i++)
+        h->Fill(x(gen), y(gen), ch(gen));
+
+    ProjectionCache cache;
+    for(unsigned ch : {3u, 0u, 9u, 3u}) {
+        INFO("ch=" << ch);
+        h->GetZaxis()->SetRange(ch+1, ch+1);
+        unique_ptr<TH2D> expected(dynamic_cast<TH2D*>(h->Project3D("yx")));
+        expected->SetDirectory(nullptr);
+        auto actual = cache.ProjectionYX(*h, ch);
+        REQUIRE(actual != nullptr);
+        REQUIRE(actual->GetNbinsX() == 20);
+        REQUIRE(actual->GetNbinsY() == 30);
+        compare(*expected, *actual);
+    }
+}
+
+void dotest_newhist() {
+    auto h1 = makeTH2(1000, false);
+    auto h2 = makeTH2(3000, false);
+
+    ProjectionCache cache;
+    CHECK(cache.ProjectionX(*h1, 4)->GetEntries() == Approx(h1->ProjectionX("p1",5,5)->GetEntries()));
+    // another histogram is picked up without Reset
+    CHECK(cache.ProjectionX(*h2, 4)->GetEntries() == Approx(h2->ProjectionX("p2",5,5)->GetEntries()));
+
+    // as well as more entries in the same histogram
+    h2->Fill(0.0, 4.0);
+    CHECK(cache.ProjectionX(*h2, 4)->GetEntries() == Approx(h2->ProjectionX("p3",5,5)->GetEntries()));
+
+    cache.Reset();
+    CHECK(cache.ProjectionX(*h1, 4)->GetEntries() == Approx(h1->ProjectionX("p4",5,5)->GetEntries()));
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+#include "base/tmpfile_t.h"
+#include "RawFileIndex.h"
+
+#include <fstream>
+
+using namespace std;
+using namespace ant;
+
+void dosaveload();
+void dofindbuffer();
+void dostale();
+
+TEST_CASE("Test RawFileIndex: Save and load", "[unpacker]") {
+    dosaveload();
+}
+
+TEST_CASE("Test RawFileIndex: FindBuffer", "[unpacker]") {
+    dofindbuffer();
+}
+
+TEST_CASE("Test RawFileIndex: Outdated index", "[unpacker]") {
+    dostale();
+}
+
+RawFileIndex make_index() {
+    RawFileIndex index;
+    index.FirstBufferOffset = 0x8000;
+    index.RecordLength = 0x8000;
+    // second buffer contains only a scaler read
+    index.Buffers.push_back({0,  10, 1,  false});
+    index.Buffers.push_back({10,  0, 11, true});
+    index.Buffers.push_back({10, 20, 11, true});
+    index.Buffers.push_back({30,  5, 31, false});
+    return index;
+}
+
+void dosaveload() {
+    tmpfolder_t folder;
+    tmpfile_t rawfile(folder, ".dat");
+    rawfile.write_testdata();
+
+    REQUIRE(RawFileIndex::Load(rawfile.filename) == nullptr);
+
+    auto index = make_index();
+    RawFileReader::access_point_t p;
+    p.Out = 1234;
+    p.In = 567;
+    p.Bits = 3;
+    p.Window = {1, 2, 3, 4};
+    index.AccessPoints.push_back(p);
+
+    REQUIRE_NOTHROW(index.Save(rawfile.filename));
+
+    auto loaded = RawFileIndex::Load(rawfile.filename);
+    REQUIRE(loaded != nullptr);
+    REQUIRE(loaded->FirstBufferOffset == index.FirstBufferOffset);
+    REQUIRE(loaded->RecordLength == index.RecordLength);
+    REQUIRE(loaded->Buffers.size() == index.Buffers.size());
+    for(size_t i=0;i<index.Buffers.size();i++) {
+        CHECK(loaded->Buffers[i].FirstEvent == index.Buffers[i].FirstEvent);
+        CHECK(loaded->Buffers[i].nEvents == index.Buffers[i].nEvents);
+        CHECK(loaded->Buffers[i].FirstAcquID == index.Buffers[i].FirstAcquID);
+        CHECK(loaded->Buffers[i].HasScalers == index.Buffers[i].HasScalers);
+    }
+    REQUIRE(loaded->AccessPoints.size() == 1);
+    CHECK(loaded->AccessPoints.front().Out == p.Out);
+    CHECK(loaded->AccessPoints.front().In == p.In);
+    CHECK(loaded->AccessPoints.front().Bits == p.Bits);
+    CHECK(loaded->AccessPoints.front().Window == p.Window);
+    CHECK(loaded->GetOffset(2) == 3*0x8000);
+
+    // index of missing raw file cannot be saved
+    REQUIRE_THROWS_AS(index.Save(folder.foldername+"/missing.dat"), RawFileIndex::Exception);
+}
+
+void dofindbuffer() {
+    auto index = make_index();
+    const auto n = index.Buffers.size();
+    CHECK(index.FindBuffer(0) == 0);
+    CHECK(index.FindBuffer(9) == 0);
+    // skips the empty buffer
+    CHECK(index.FindBuffer(10) == 2);
+    CHECK(index.FindBuffer(29) == 2);
+    CHECK(index.FindBuffer(30) == 3);
+    CHECK(index.FindBuffer(34) == 3);
+    CHECK(index.FindBuffer(35) == n);
+    CHECK(index.FindBuffer(1000) == n);
+
+    RawFileIndex empty;
+    CHECK(empty.FindBuffer(0) == 0);
+}
+
+void dostale() {
+    tmpfolder_t folder;
+    tmpfile_t rawfile(folder, ".dat");
+    rawfile.write_testdata();
+
+    auto index = make_index();
+    index.Save(rawfile.filename);
+    REQUIRE(RawFileIndex::Load(rawfile.filename) != nullptr);
+
+    // growing the raw file outdates the index
+    {
+        ofstream s(rawfile.filename, ios::binary | ios::app);
+        s << "more data";
+    }
+    REQUIRE(RawFileIndex::Load(rawfile.filename) == nullptr);
+
+    // garbage is not loaded
+    {
+        ofstream s(RawFileIndex::GetFilename(rawfile.filename), ios::binary);
+        s << "garbage";
+    }
+    REQUIRE(RawFileIndex::Load(rawfile.filename) == nullptr);
+}
@@ -1,12 +1,19 @@
 #include "catch.hpp"
 #include "base/tmpfile_t.h"
 #include "RawFileReader.h"
+#include "RawFileWriter.h"
 #include <cstdlib>
 #include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <thread>
+#include <chrono>
+#include <fstream>
 
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 
 using namespace std;
@@ -20,6 +27,10 @@ enum class eCompress { NoCompress, XZ, GZ };
 
 void dotest(eCompress, streamsize, streamsize, streamsize);
 void doendianness();
+void dowriter(ant::RawFileWriter::Compression_t);
+void dolivefile();
+void dolivesocket();
+void doseek(ant::RawFileWriter::Compression_t, streamsize blockSize, bool accessPoints);
 
 
 TEST_CASE("Test RawFileReader: nocompress, one chunk", "[unpacker]") {
@@ -58,6 +69,223 @@ TEST_CASE("Test RawFileReader: uint32_t endianness","[unpacker]") {
   doendianness();
 }
 
+TEST_CASE("Test RawFileWriter: nocompress", "[unpacker]") {
+  dowriter(ant::RawFileWriter::Compression_t::None);
+}
+
+TEST_CASE("Test RawFileWriter: compress xz", "[unpacker]") {
+  dowriter(ant::RawFileWriter::Compression_t::XZ);
+}
+
+TEST_CASE("Test RawFileWriter: compress gz", "[unpacker]") {
+  dowriter(ant::RawFileWriter::Compression_t::GZ);
+}
+
+TEST_CASE("Test RawFileReader: follow growing file", "[unpacker]") {
+  dolivefile();
+}
+
+TEST_CASE("Test RawFileReader: read UNIX socket", "[unpacker]") {
+  dolivesocket();
+}
+
+TEST_CASE("Test RawFileReader: seek nocompress", "[unpacker]") {
+  doseek(ant::RawFileWriter::Compression_t::None, 0, false);
+}
+
+TEST_CASE("Test RawFileReader: seek xz, one block", "[unpacker]") {
+  doseek(ant::RawFileWriter::Compression_t::XZ, 0, false);
+}
+
+TEST_CASE("Test RawFileReader: seek xz, blocks", "[unpacker]") {
+  doseek(ant::RawFileWriter::Compression_t::XZ, 12345, false);
+}
+
+TEST_CASE("Test RawFileReader: seek gz", "[unpacker]") {
+  doseek(ant::RawFileWriter::Compression_t::GZ, 0, false);
+}
+
+TEST_CASE("Test RawFileReader: seek gz, access points", "[unpacker]") {
+  doseek(ant::RawFileWriter::Compression_t::GZ, 0, true);
+}
+
+void doseek(ant::RawFileWriter::Compression_t compression, streamsize blockSize, bool accessPoints) {
+  ant::tmpfile_t f;
+  // compressible data, so that deflate creates many blocks
+  f.testdata.resize(1 << 20);
+  generate(f.testdata.begin(), f.testdata.end(), [] () { return rand() % 16; });
+  {
+    ant::RawFileWriter writer(f.filename, compression, 6, blockSize);
+    writer.write((const char*)f.testdata.data(), f.testdata.size());
+  }
+
+  ant::RawFileReader::access_points_t points;
+  if(accessPoints) {
+    ant::RawFileReader reader;
+    reader.open(f.filename);
+    reader.record_access_points(1 << 16);
+    vector<uint8_t> indata(f.testdata.size());
+    REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+    points = reader.recorded_access_points();
+    REQUIRE(points.size() > 4);
+    for(auto& p : points)
+      REQUIRE(p.Window.size() <= 1 << 15);
+  }
+
+  ant::RawFileReader reader;
+  REQUIRE_NOTHROW(reader.open(f.filename));
+
+  // forwards and backwards
+  const streamsize n = 1000;
+  const streamsize size = f.testdata.size();
+  for(streamsize pos : {size/2, streamsize(0), size-n, size/3, size/3+1, streamsize(12345*3), size/7}) {
+    REQUIRE_NOTHROW(reader.seek(pos, points));
+    REQUIRE(reader.tellg() == pos);
+    vector<uint8_t> indata(n);
+    REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+    REQUIRE(reader.gcount()==n);
+    REQUIRE(equal(indata.begin(), indata.end(), f.testdata.begin()+pos));
+  }
+
+  // reading continues until the end
+  vector<uint8_t> indata(size);
+  REQUIRE_NOTHROW(reader.seek(size/5, points));
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+  REQUIRE(reader.gcount() == size - size/5);
+  REQUIRE(reader.eof());
+  REQUIRE(equal(indata.begin(), indata.begin()+reader.gcount(), f.testdata.begin()+size/5));
+}
+
+void dolivefile() {
+  ant::tmpfile_t f;
+  f.testdata.resize(totalSize);
+  generate(f.testdata.begin(), f.testdata.end(), rand);
+
+  // start with first chunk only
+  ofstream out(f.filename, ios::binary);
+  out.write((const char*)&f.testdata[0], chunkSize);
+  out.flush();
+
+  ant::RawFileReader::Live.FollowFiles = true;
+  ant::RawFileReader::Live.Timeout = 0.5;
+  ant::RawFileReader::Live.PollInterval = 0.005;
+
+  ant::RawFileReader reader;
+  REQUIRE_NOTHROW(reader.open(f.filename));
+  REQUIRE(reader);
+  REQUIRE(reader.IsLive());
+
+  // the remaining data is written while the reader waits
+  thread writer([&out, &f] () {
+    streamsize offset = chunkSize;
+    while(offset < totalSize) {
+      this_thread::sleep_for(chrono::milliseconds(2));
+      const auto n = min(chunkSize, totalSize-offset);
+      out.write((const char*)&f.testdata[offset], n);
+      out.flush();
+      offset += n;
+    }
+  });
+
+  vector<uint8_t> indata(f.testdata.size());
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+  writer.join();
+  REQUIRE(reader.gcount()==indata.size());
+  REQUIRE(!reader.eof());
+
+  // nothing more written, so reading times out
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], 1));
+  REQUIRE(reader.gcount()==0);
+  REQUIRE(reader.eof());
+
+  ant::RawFileReader::Live = ant::RawFileReader::live_t();
+
+  const bool inputEqualsOutput = indata == f.testdata;
+  REQUIRE(inputEqualsOutput);
+}
+
+void dolivesocket() {
+  ant::tmpfile_t f;
+  f.testdata.resize(totalSize);
+  generate(f.testdata.begin(), f.testdata.end(), rand);
+
+  // the socket replaces the tmpfile
+  unlink(f.filename.c_str());
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  f.filename.copy(addr.sun_path, sizeof(addr.sun_path)-1);
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  REQUIRE(server >= 0);
+  REQUIRE(::bind(server, (sockaddr*)&addr, sizeof(addr)) == 0);
+  REQUIRE(listen(server, 1) == 0);
+  REQUIRE(ant::RawFileReader::IsSocket(f.filename));
+
+  // stand-in for the DAQ, closing the connection ends the stream
+  thread producer([server, &f] () {
+    const int conn = accept(server, nullptr, nullptr);
+    streamsize offset = 0;
+    while(conn >= 0 && offset < totalSize) {
+      this_thread::sleep_for(chrono::milliseconds(2));
+      const auto n = min(chunkSize, totalSize-offset);
+      offset += write(conn, &f.testdata[offset], n);
+    }
+    close(conn);
+  });
+
+  ant::RawFileReader reader;
+  REQUIRE_NOTHROW(reader.open(f.filename));
+  REQUIRE(reader);
+  REQUIRE(reader.IsLive());
+
+  vector<uint8_t> indata(f.testdata.size());
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+  REQUIRE(reader.gcount()==indata.size());
+  REQUIRE(!reader.eof());
+
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], 1));
+  REQUIRE(reader.gcount()==0);
+  REQUIRE(reader.eof());
+
+  producer.join();
+  close(server);
+
+  const bool inputEqualsOutput = indata == f.testdata;
+  REQUIRE(inputEqualsOutput);
+}
+
+void dowriter(ant::RawFileWriter::Compression_t compression) {
+  ant::tmpfile_t f;
+  f.testdata.resize(totalSize);
+  generate(f.testdata.begin(), f.testdata.end(), rand);
+
+  // write in chunks, which is what the compressors are challenged with
+  {
+    ant::RawFileWriter writer(f.filename, compression);
+    streamsize offset = 0;
+    while(offset < totalSize) {
+      const auto n = min(chunkSize, totalSize-offset);
+      REQUIRE_NOTHROW(writer.write((const char*)&f.testdata[offset], n));
+      offset += n;
+    }
+    REQUIRE(writer.BytesWritten() == totalSize);
+    REQUIRE_NOTHROW(writer.close());
+  }
+
+  ant::RawFileReader reader;
+  REQUIRE_NOTHROW(reader.open(f.filename, inbufSize));
+  REQUIRE(reader);
+
+  vector<uint8_t> indata(f.testdata.size());
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], indata.size()));
+  REQUIRE(reader.gcount()==indata.size());
+  REQUIRE_NOTHROW(reader.read((char*)&indata[0], 1));
+  REQUIRE(reader.gcount()==0);
+  REQUIRE(reader.eof());
+
+  const bool inputEqualsOutput = indata == f.testdata;
+  REQUIRE(inputEqualsOutput);
+}
+
 void doendianness() {
   ant::tmpfile_t f;
 